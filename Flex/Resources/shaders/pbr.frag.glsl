@@ -1,4 +1,5 @@
 #version 460
+#extension GL_ARB_bindless_texture : enable
 
 // PBR Functions
 #define M_RCPPI 0.31830988618379067153776752674503
@@ -71,10 +72,11 @@ vec3 SampleSphericalMap(sampler2D tex, vec3 dir)
     return texture(tex, uv).rgb;
 }
 
-vec3 GetNormalFromMap(vec3 normal, vec3 tangent, vec3 bitangent, vec2 uv, sampler2D normalMap)
+vec3 GetNormalFromMap(vec3 normal, vec3 tangent, vec3 bitangent, vec3 normalMapValue)
 {
-    vec3 normalMapValue = texture(normalMap, uv).rgb;
-    normalMapValue = normalMapValue * 2.0 - 1.0;
+    // Z is rebuilt from XY, BC5 normal maps only store two channels
+    normalMapValue.xy = normalMapValue.xy * 2.0 - 1.0;
+    normalMapValue.z = sqrt(max(1.0 - dot(normalMapValue.xy, normalMapValue.xy), 0.0));
     mat3 TBN = mat3(tangent, bitangent, normal);
     return normalize(TBN * normalMapValue);
 }
@@ -86,8 +88,16 @@ vec3 GetNormalFromMap(vec3 normal, vec3 tangent, vec3 bitangent, vec2 uv, sample
 
 #define UNIFORM_BINDING_LOC_CAMERA 0
 #define UNIFORM_BINDING_LOC_SCENE 1
-#define UNIFORM_BINDING_LOC_MATERIAL 2
 #define UNIFORM_BINDING_LOC_CSM 3
+#define STORAGE_BINDING_LOC_MATERIALS 1
+#define TEXTURE_BINDING_LOC_MATERIAL_ARRAYS 7
+
+#define MAX_MATERIAL_TEXTURE_ARRAYS 8
+#define MATERIAL_TEXTURE_BASE_COLOR 0
+#define MATERIAL_TEXTURE_EMISSIVE 1
+#define MATERIAL_TEXTURE_METALLIC_ROUGHNESS 2
+#define MATERIAL_TEXTURE_NORMAL 3
+#define MATERIAL_TEXTURE_OCCLUSION 4
 
 #define NUM_CASCADES 4
 
@@ -111,14 +121,22 @@ layout (std140, binding = UNIFORM_BINDING_LOC_SCENE) uniform Scene
     float padding[2];
 } u_Scene;
 
-layout (std140, binding = UNIFORM_BINDING_LOC_MATERIAL) uniform Material
+struct MaterialParams
 {
     vec4 baseColorFactor;
     vec4 emissiveFactor;
     float metallicFactor;
     float roughnessFactor;
     float occlusionStrength;
-} u_Material;
+    float padding;
+    uvec2 textures[5]; // TextureTable references, see SampleMaterialTexture
+};
+
+// Every live material, indexed by Material::GetSlot
+layout (std430, binding = STORAGE_BINDING_LOC_MATERIALS) readonly buffer Materials
+{
+    MaterialParams params[];
+} u_Materials;
 
 layout (std140, binding = UNIFORM_BINDING_LOC_CSM) uniform CascadedShadows
 {
@@ -139,17 +157,33 @@ layout (location = 0) in VERTEX
     vec3 bitangent;
     vec3 color;
     vec2 uv;
+    flat uint materialIndex;
 } _input;
 
-layout (binding = 0) uniform sampler2D u_BaseColorTexture;
-layout (binding = 1) uniform sampler2D u_EmissiveTexture;
-layout (binding = 2) uniform sampler2D u_MetallicRoughnessTexture;
-layout (binding = 3) uniform sampler2D u_NormalTexture;
-layout (binding = 4) uniform sampler2D u_OcclusionTexture;
+#ifdef GL_ARB_bindless_texture
+// The reference is the texture's resident bindless handle
+vec4 SampleMaterialTexture(uvec2 textureRef, vec2 uv)
+{
+    return texture(sampler2D(textureRef), uv);
+}
+#else
+// The reference is (texture array, layer), arrays are bucketed by size and format.
+// Every instance of a draw command shares its material, so the index is uniform per draw
+layout (binding = TEXTURE_BINDING_LOC_MATERIAL_ARRAYS) uniform sampler2DArray u_MaterialTextures[MAX_MATERIAL_TEXTURE_ARRAYS];
+
+vec4 SampleMaterialTexture(uvec2 textureRef, vec2 uv)
+{
+    return texture(u_MaterialTextures[textureRef.x], vec3(uv, float(textureRef.y)));
+}
+#endif
+
 layout (binding = 5) uniform sampler2D u_EnvironmentTexture;
 layout (binding = 6) uniform sampler2DArray u_ShadowMap; // depth array
 
-uniform int u_DebugShadows; // 1 = visualize cascades, 2 = visualize visibility factor
+// Compiled in per variant (see PBRFeature in Material.h):
+// HAS_<texture>_MAP when the material has a real map, without one the value of the renderer's
+// fallback texture is used and nothing is fetched. DEBUG_SHADOW_CASCADES / DEBUG_SHADOW_VISIBILITY
+// replace the lit color with the cascade index or the visibility factor
 
 int GetCascadeIndex(float viewDepth)
 {
@@ -198,6 +232,8 @@ float SampleShadow(vec3 worldPos, vec3 normal, vec3 lightDir)
 
 void main()
 {
+    MaterialParams material = u_Materials.params[_input.materialIndex];
+
     vec3 normals = normalize(_input.normals.xyz);
     vec3 tangent = normalize(_input.tangent);
     vec3 bitangent = normalize(_input.bitangent);
@@ -218,30 +254,49 @@ void main()
     float sunAngularRadius = 0.5;
     float sunSolidAngle = 2.0 * M_PI * (1.0 - cos(sunAngularRadius)); // steradians
 
-    vec3 baseColorTex = texture(u_BaseColorTexture, _input.uv).rgb;
-    vec3 emissiveColorTex = texture(u_EmissiveTexture, _input.uv).rgb * u_Material.emissiveFactor.rgb;
-    vec3 metallicRoughnessColorTex = texture(u_MetallicRoughnessTexture, _input.uv).rgb;
-    vec3 normalMapTex = texture(u_NormalTexture, _input.uv).rgb;
-    float occlusionTex = texture(u_OcclusionTexture, _input.uv).r;
-    float metallicVal = metallicRoughnessColorTex.b * u_Material.metallicFactor;
-    float roughnessTex = metallicRoughnessColorTex.g * (1.0 - u_Material.roughnessFactor);
+#ifdef HAS_BASE_COLOR_MAP
+    vec4 baseColorSample = SampleMaterialTexture(material.textures[MATERIAL_TEXTURE_BASE_COLOR], _input.uv);
+#else
+    vec4 baseColorSample = vec4(1.0);
+#endif
+#ifdef HAS_EMISSIVE_MAP
+    vec3 emissiveColorTex = SampleMaterialTexture(material.textures[MATERIAL_TEXTURE_EMISSIVE], _input.uv).rgb * material.emissiveFactor.rgb;
+#else
+    vec3 emissiveColorTex = material.emissiveFactor.rgb;
+#endif
+#ifdef HAS_METALLIC_ROUGHNESS_MAP
+    vec3 metallicRoughnessColorTex = SampleMaterialTexture(material.textures[MATERIAL_TEXTURE_METALLIC_ROUGHNESS], _input.uv).rgb;
+#else
+    vec3 metallicRoughnessColorTex = vec3(0.0);
+#endif
+#ifdef HAS_OCCLUSION_MAP
+    float occlusionTex = SampleMaterialTexture(material.textures[MATERIAL_TEXTURE_OCCLUSION], _input.uv).r;
+#else
+    float occlusionTex = 1.0;
+#endif
+    vec3 baseColorTex = baseColorSample.rgb;
+    float metallicVal = metallicRoughnessColorTex.b * material.metallicFactor;
+    float roughnessTex = metallicRoughnessColorTex.g * (1.0 - material.roughnessFactor);
     float roughnessVal = clamp(roughnessTex, 0.0, 1.0);
 
     // Detect if occlusion texture is actually a white fallback (heuristic)
     occlusionTex = abs(occlusionTex - 1.0) < 0.001 
-        ? 1.0 * u_Material.occlusionStrength
-        : occlusionTex * u_Material.occlusionStrength;
+        ? 1.0 * material.occlusionStrength
+        : occlusionTex * material.occlusionStrength;
 
     if (int(u_Scene.renderMode) == RENDER_MODE_COLOR)
     {
         // Use user/texture roughness directly (already clamped). Removed sunSolidAngle filtering for clearer control.
-        vec3 diffuseColor = baseColorTex * _input.color * u_Material.baseColorFactor.rgb * (1.0 - metallicVal);
+        vec3 diffuseColor = baseColorTex * _input.color * material.baseColorFactor.rgb * (1.0 - metallicVal);
         vec3 specularColor = mix(vec3(0.04), baseColorTex, metallicVal);
         
         // Use normal mapping if available
         vec3 finalNormal = normals;
+#ifdef HAS_NORMAL_MAP
+        vec3 normalMapTex = SampleMaterialTexture(material.textures[MATERIAL_TEXTURE_NORMAL], _input.uv).rgb;
         if (length(normalMapTex) > 0.1) // Check if normal map has meaningful data
-            finalNormal = GetNormalFromMap(normals, tangent, bitangent, _input.uv, u_NormalTexture);
+            finalNormal = GetNormalFromMap(normals, tangent, bitangent, normalMapTex);
+#endif
         
         vec3 reflectDirection = reflect(-viewDirection, finalNormal);
         vec3 reflectRadiance = SampleSphericalMap(u_EnvironmentTexture, reflectDirection);
@@ -292,7 +347,7 @@ void main()
         }
         
         fragColor = vec4(finalColor, 1.0);
-        if (u_DebugShadows == 1)
+#if defined(DEBUG_SHADOW_CASCADES)
         {
             // visualize cascade index by re-running selection
             vec3 viewPos = (u_Camera.view * vec4(_input.worldPosition,1.0)).xyz;
@@ -305,36 +360,34 @@ void main()
             
             fragColor = vec4(dbg, 1.0);
         }
-        else if (u_DebugShadows == 2)
-        {
-            float vis = SampleShadow(_input.worldPosition, finalNormal, lightDirection);
-            fragColor = vec4(vec3(vis),1.0);
-        }
+#elif defined(DEBUG_SHADOW_VISIBILITY)
+        fragColor = vec4(vec3(shadowTerm), 1.0);
+#endif
     }
     else if (int(u_Scene.renderMode) == RENDER_MODE_NORMALS)
     {
         vec3 n = normals * 0.5 + 0.5;
         vec3 finalNormal = normals * 0.5 + 0.5;
+#ifdef HAS_NORMAL_MAP
+        vec3 normalMapTex = SampleMaterialTexture(material.textures[MATERIAL_TEXTURE_NORMAL], _input.uv).rgb;
         if (length(normalMapTex) > 0.01) // Check if normal map has meaningful data
-            finalNormal = GetNormalFromMap(n, tangent, bitangent, _input.uv, u_NormalTexture);
+            finalNormal = GetNormalFromMap(n, tangent, bitangent, normalMapTex);
+#endif
         
         fragColor = vec4(finalNormal, 1.0);
     }
     else if (int(u_Scene.renderMode) == RENDER_MODE_METALLIC)
     {
-        vec4 metallicRoughnessColorTex = texture(u_MetallicRoughnessTexture, _input.uv);
-        float metallic = metallicRoughnessColorTex.b * u_Material.metallicFactor;
+        float metallic = metallicRoughnessColorTex.b * material.metallicFactor;
         fragColor = vec4(metallic, metallic, metallic, 1.0);
     }
     else if (int(u_Scene.renderMode) == RENDER_MODE_ROUGHNESS)
     {
-        vec4 metallicRoughnessColorTex = texture(u_MetallicRoughnessTexture, _input.uv);
         float roughness = metallicRoughnessColorTex.g;
         fragColor = vec4(roughness, roughness, roughness, 1.0);
     }
     else
     {
-        vec4 baseColorTex = texture(u_BaseColorTexture, _input.uv);
-        fragColor = baseColorTex;
+        fragColor = baseColorSample;
     }
 }
\ No newline at end of file
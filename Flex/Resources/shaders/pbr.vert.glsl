@@ -1,10 +1,10 @@
 #version 460
+// PackedVertex stream from the GeometryPool (see VertexFormat.h), normalized by the vertex fetch
 layout (location = 0) in vec3 position;
-layout (location = 1) in vec3 normals;
-layout (location = 2) in vec3 tangent;
-layout (location = 3) in vec3 bitangent;
-layout (location = 4) in vec3 color;
-layout (location = 5) in vec2 uv;
+layout (location = 1) in vec2 normalOct;   // snorm16
+layout (location = 2) in vec4 tangentOct;  // snorm8, xy octahedral, z bitangent sign
+layout (location = 3) in vec4 color;       // unorm8, optional stream, constant white without it
+layout (location = 4) in vec2 uv;          // half
 
 #define UNIFORM_BINDING_LOC_CAMERA 0
 
@@ -16,6 +16,7 @@ layout (std140, binding = UNIFORM_BINDING_LOC_CAMERA) uniform Camera
 } u_Camera;
 
 uniform mat4 u_Transform;
+uniform int u_MaterialIndex;
 
 layout (location = 0) out VERTEX
 {
@@ -26,10 +27,23 @@ layout (location = 0) out VERTEX
     vec3 bitangent;
     vec3 color;
     vec2 uv;
+    flat uint materialIndex;
 } _output;
 
+vec3 DecodeOctahedral(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0)
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(n);
+}
+
 void main()
 {
+    vec3 normals = DecodeOctahedral(normalOct);
+    vec3 tangent = DecodeOctahedral(tangentOct.xy);
+    vec3 bitangent = cross(normals, tangent) * (tangentOct.z < 0.0 ? -1.0 : 1.0);
+
     // World position with translation
     _output.worldPosition = (u_Transform * vec4(position, 1.0)).xyz;
     _output.position = position;
@@ -37,8 +51,9 @@ void main()
     _output.normals = normalize(mat3(u_Transform) * normals);
     _output.tangent = normalize(mat3(u_Transform) * tangent);
     _output.bitangent = normalize(mat3(u_Transform) * bitangent);
-    _output.color = color;
+    _output.color = color.rgb;
     _output.uv = uv;
+    _output.materialIndex = uint(u_MaterialIndex);
 
     gl_Position = u_Camera.viewProjection * u_Transform * vec4(position, 1.0);
 }
@@ -0,0 +1,72 @@
+#version 460
+// PackedVertex stream from the GeometryPool (see VertexFormat.h), normalized by the vertex fetch
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 normalOct;   // snorm16
+layout (location = 2) in vec4 tangentOct;  // snorm8, xy octahedral, z bitangent sign
+layout (location = 3) in vec4 color;       // unorm8, optional stream, constant white without it
+layout (location = 4) in vec2 uv;          // half
+
+#define UNIFORM_BINDING_LOC_CAMERA 0
+#define STORAGE_BINDING_LOC_INSTANCES 0
+
+layout (std140, binding = UNIFORM_BINDING_LOC_CAMERA) uniform Camera
+{
+    mat4 viewProjection;
+    mat4 view;
+    vec4 position;
+} u_Camera;
+
+struct InstanceData
+{
+    mat4 transform;
+    uint materialIndex;
+};
+
+// Every instance in the draw list, a draw reads [gl_BaseInstance, gl_BaseInstance + instanceCount)
+layout (std430, binding = STORAGE_BINDING_LOC_INSTANCES) readonly buffer Instances
+{
+    InstanceData instances[];
+} u_Instances;
+
+layout (location = 0) out VERTEX
+{
+    vec3 worldPosition;
+    vec3 position;
+    vec3 normals;
+    vec3 tangent;
+    vec3 bitangent;
+    vec3 color;
+    vec2 uv;
+    flat uint materialIndex;
+} _output;
+
+vec3 DecodeOctahedral(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0)
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(n);
+}
+
+void main()
+{
+    vec3 normals = DecodeOctahedral(normalOct);
+    vec3 tangent = DecodeOctahedral(tangentOct.xy);
+    vec3 bitangent = cross(normals, tangent) * (tangentOct.z < 0.0 ? -1.0 : 1.0);
+
+    InstanceData instance = u_Instances.instances[gl_BaseInstance + gl_InstanceID];
+    mat4 transform = instance.transform;
+
+    // World position with translation
+    _output.worldPosition = (transform * vec4(position, 1.0)).xyz;
+    _output.position = position;
+    // Transform normals to world space (approximate; assumes uniform scale)
+    _output.normals = normalize(mat3(transform) * normals);
+    _output.tangent = normalize(mat3(transform) * tangent);
+    _output.bitangent = normalize(mat3(transform) * bitangent);
+    _output.color = color.rgb;
+    _output.uv = uv;
+    _output.materialIndex = instance.materialIndex;
+
+    gl_Position = u_Camera.viewProjection * transform * vec4(position, 1.0);
+}
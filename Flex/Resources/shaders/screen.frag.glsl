@@ -5,8 +5,14 @@ layout (location = 0) in vec2 vUV;
 
 layout (binding = 0) uniform sampler2D u_ColorTexture;
 layout (binding = 1) uniform sampler2D u_DepthTexture;
+// Effects are compiled in per variant: ENABLE_DOF, ENABLE_VIGNETTE, ENABLE_CHROMATIC_ABERRATION,
+// ENABLE_BLOOM, ENABLE_SSAO and DEBUG_SSAO (see ScreenFeature in App.h)
+#ifdef ENABLE_BLOOM
 layout (binding = 3) uniform sampler2D u_BloomTexHQ; // High quality final bloom
-layout (binding = 8) uniform sampler2D u_AOTexture; // SSAO (optional)
+#endif
+#ifdef ENABLE_SSAO
+layout (binding = 8) uniform sampler2D u_AOTexture;
+#endif
 
 #define RENDER_MODE_DEPTH 4
 #define UNIFORM_BINDING_LOC_SCENE 1
@@ -22,34 +28,34 @@ layout (std140, binding = UNIFORM_BINDING_LOC_SCENE) uniform Scene
     float padding[2];
 } u_Scene;
 
+uniform float u_Exposure;
+uniform float u_Gamma;
+
+uniform mat4 u_InverseProjection;
+
+#ifdef ENABLE_DOF
 uniform float u_FocalLength;
 uniform float u_FocalDistance;
 uniform float u_FStop;
 uniform float u_FocusRange;
 uniform float u_BlurAmount;
-uniform float u_Exposure;
-uniform float u_Gamma;
+#endif
 
-uniform mat4 u_InverseProjection;
-
-// Post effect toggles
-uniform bool u_EnableDOF;
-uniform bool u_EnableVignette;
-uniform bool u_EnableChromAb;
-uniform bool u_EnableBloom;
-uniform bool u_EnableSSAO;
+#ifdef ENABLE_SSAO
 uniform float u_AOIntensity; // blend strength
-uniform bool u_DebugSSAO;
+#endif
 
-// Vignette uniforms
+#ifdef ENABLE_VIGNETTE
 uniform float u_VignetteRadius;
 uniform float u_VignetteSoftness;
 uniform float u_VignetteIntensity;
 uniform vec3 u_VignetteColor;
+#endif
 
-// Chromatic aberration uniforms
+#ifdef ENABLE_CHROMATIC_ABERRATION
 uniform float u_ChromaticAberrationAmount;
 uniform float u_ChromaticAberrationRadial;
+#endif
 
 float LinearizeDepth(float depth, float near, float far)
 {
@@ -153,20 +159,20 @@ void main()
     {
         vec4 baseColor = texture(u_ColorTexture, uv);
         // Apply SSAO (multiply diffuse) before DOF/fog when still linear HDR
-        if (u_EnableSSAO)
+#ifdef ENABLE_SSAO
         {
             float ao = texture(u_AOTexture, uv).r;
             ao = clamp(ao, 0.0, 1.0);
-            if (u_DebugSSAO)
-            {
-                fragColor = vec4(vec3(ao), 1.0);
-                return;
-            }
+#ifdef DEBUG_SSAO
+            fragColor = vec4(vec3(ao), 1.0);
+            return;
+#endif
             float blendAO = mix(1.0, ao, u_AOIntensity);
             baseColor.rgb *= blendAO;
         }
+#endif
 
-        if (u_EnableChromAb)
+#ifdef ENABLE_CHROMATIC_ABERRATION
         {
             vec2 center = vec2(0.5);
             vec2 dir = uv - center;
@@ -178,8 +184,9 @@ void main()
             float b = texture(u_ColorTexture, uv - offset).b; // opposite shift
             baseColor.rgb = vec3(r, g, b);
         }
+#endif
 
-        if (u_EnableDOF)
+#ifdef ENABLE_DOF
         {
             // Calculate circle of confusion (CoC)
             float distanceFromFocus = abs(dist - u_FocalDistance);
@@ -220,20 +227,18 @@ void main()
                 baseColor.rgb = ApplyFog(baseColor.rgb, depth, uv, u_InverseProjection, u_Scene.fogDensity, u_Scene.fogColor, u_Scene.fogStart, u_Scene.fogEnd);
             }
         }
-        else
-        {
-            // No DOF, apply fog to center
-            baseColor.rgb = ApplyFog(baseColor.rgb, depth, uv, u_InverseProjection, u_Scene.fogDensity, u_Scene.fogColor, u_Scene.fogStart, u_Scene.fogEnd);
-        }
+#else
+        // No DOF, apply fog to center
+        baseColor.rgb = ApplyFog(baseColor.rgb, depth, uv, u_InverseProjection, u_Scene.fogDensity, u_Scene.fogColor, u_Scene.fogStart, u_Scene.fogEnd);
+#endif
 
         // Bloom composite BEFORE tone mapping (HDR domain)
-        if (u_EnableBloom)
-        {
-            baseColor.rgb += texture(u_BloomTexHQ, uv).rgb;
-        }
+#ifdef ENABLE_BLOOM
+        baseColor.rgb += texture(u_BloomTexHQ, uv).rgb;
+#endif
 
         // Vignette AFTER chromatic aberration but still linear
-        if (u_EnableVignette)
+#ifdef ENABLE_VIGNETTE
         {
             float rad = clamp(u_VignetteRadius, 0.0, 1.0);
             float soft = clamp(u_VignetteSoftness, 0.0001, 1.0);
@@ -245,6 +250,7 @@ void main()
             float intensity = u_VignetteIntensity;
             baseColor.rgb = mix(baseColor.rgb, baseColor.rgb * u_VignetteColor, vig * intensity);
         }
+#endif
 
         vec3 mapped = FilmicTonemap(baseColor.rgb, u_Exposure, u_Gamma);
         fragColor = vec4(mapped, 1.0);
@@ -1,4 +1,5 @@
 #version 460
+// Reads only the GeometryPool position stream, 12 bytes per vertex
 layout (location = 0) in vec3 aPos;
 
 layout(std140, binding = 3) uniform CascadedShadows
@@ -0,0 +1,34 @@
+#version 460
+// Reads only the GeometryPool position stream, 12 bytes per vertex
+layout (location = 0) in vec3 aPos;
+
+#define STORAGE_BINDING_LOC_INSTANCES 0
+
+layout(std140, binding = 3) uniform CascadedShadows
+{
+    mat4 lightViewProj[4];
+    vec4 cascadeSplits;
+    float shadowStrength;
+    float minBias;
+    float maxBias;
+    float pcfRadius;
+} u_CSM;
+
+struct InstanceData
+{
+    mat4 transform;
+    uint materialIndex;
+};
+
+layout (std430, binding = STORAGE_BINDING_LOC_INSTANCES) readonly buffer Instances
+{
+    InstanceData instances[];
+} u_Instances;
+
+uniform int u_CascadeIndex;
+
+void main()
+{
+    mat4 model = u_Instances.instances[gl_BaseInstance + gl_InstanceID].transform;
+    gl_Position = u_CSM.lightViewProj[u_CascadeIndex] * model * vec4(aPos,1.0);
+}
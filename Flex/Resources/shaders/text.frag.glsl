@@ -1,7 +1,8 @@
-#version 410 core
+#version 460 core
 layout (location = 0) out vec4 fragColor;
 
-uniform sampler2D textures[32];
+// Units 0..31
+layout (binding = 0) uniform sampler2D textures[32];
 
 struct VERTEX
 {
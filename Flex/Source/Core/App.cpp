@@ -2,6 +2,14 @@
 
 #include "App.h"
 #include "Physics/JoltPhysics.h"
+#include "Core/ThreadPool.h"
+#include "Renderer/StreamingBuffer.h"
+#include "Renderer/MaterialTable.h"
+#include "Renderer/TextureTable.h"
+#include "Renderer/RenderState.h"
+#include "Renderer/ProgramCache.h"
+#include "Renderer/TextureLoader.h"
+#include "Renderer/TextureStreamer.h"
 #include "Scene/Components.h"
 #include "Renderer/Material.h"
 #include "Renderer/Renderer2D.h"
@@ -59,6 +67,7 @@ namespace flex
         TextRenderer::Init();
 
         JoltPhysics::Init();
+        ThreadPool::Init();
         m_Screen = CreateRef<Screen>();
 
         m_EditorScene = CreateRef<Scene>();
@@ -72,6 +81,7 @@ namespace flex
 
         MeshLoader::ClearCache();
 
+        ThreadPool::Shutdown();
         JoltPhysics::Shutdown();
         ImGuiContext::Shutdown();
         TextRenderer::Shutdown();
@@ -81,22 +91,28 @@ namespace flex
 
     void App::Run()
     {
-        glEnable(GL_DEPTH_TEST);
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_BACK);
-
-        Ref<Shader> PBRShader = Renderer::CreateShaderFromFile(
+        // Scene meshes are drawn through the render queue, which always issues instanced draws.
+        // The define list follows PBRFeature, other variants compile the first time a material needs them
+        Ref<ShaderVariants> PBRShaders = Renderer::CreateShaderVariants(
             {
-                ShaderData{"Resources/shaders/pbr.vert.glsl", GL_VERTEX_SHADER, 0 },
+                ShaderData{"Resources/shaders/pbr_instanced.vert.glsl", GL_VERTEX_SHADER, 0 },
                 ShaderData{"Resources/shaders/pbr.frag.glsl", GL_FRAGMENT_SHADER, 0 },
-			}, "MaterialPBR");
+            },
+            {
+                "HAS_BASE_COLOR_MAP", "HAS_EMISSIVE_MAP", "HAS_METALLIC_ROUGHNESS_MAP", "HAS_NORMAL_MAP", "HAS_OCCLUSION_MAP",
+                "DEBUG_SHADOW_CASCADES", "DEBUG_SHADOW_VISIBILITY",
+            }, "MaterialPBRInstanced");
+
+        // glTF materials usually sample every map, others stand in with the base variant until they link
+        PBRShaders->Precompile(PBR_FEATURE_BASE_COLOR_MAP | PBR_FEATURE_EMISSIVE_MAP | PBR_FEATURE_METALLIC_ROUGHNESS_MAP
+            | PBR_FEATURE_NORMAL_MAP | PBR_FEATURE_OCCLUSION_MAP);
 
         // Shadow depth shader (cascaded)
         Ref<Shader> shadowDepthShader = Renderer::CreateShaderFromFile(
             {
-                ShaderData{"Resources/shaders/shadow_depth.vert.glsl", GL_VERTEX_SHADER, 0 },
+                ShaderData{"Resources/shaders/shadow_depth_instanced.vert.glsl", GL_VERTEX_SHADER, 0 },
                 ShaderData{"Resources/shaders/shadow_depth.frag.glsl", GL_FRAGMENT_SHADER, 0 },
-            }, "ShadowDepth");
+            }, "ShadowDepthInstanced");
 
         Ref<Shader> skyboxShader = Renderer::CreateShaderFromFile(
 			{
@@ -104,16 +120,22 @@ namespace flex
 				ShaderData{"Resources/shaders/skybox.frag.glsl", GL_FRAGMENT_SHADER, 0 },
 			}, "SkyBox");
 
+        // Post process shaders are submitted here too, every program compiles while the HDR and textures load
+        m_Bloom = CreateRef<Bloom>(m_Window->GetWidth(), m_Window->GetHeight());
+        m_SSAO = CreateRef<SSAO>(m_Window->GetWidth(), m_Window->GetHeight());
+
         TextureCreateInfo createInfo;
         createInfo.flip = false;
         createInfo.format = Format::RGB32F;
         createInfo.clampMode = WrapMode::REPEAT;
         createInfo.filter = FilterMode::LINEAR;
 
-        m_EnvMap = CreateRef<Texture2D>(createInfo, "Resources/hdr/rogland_clear_night_4k.hdr");
+        // Decoded in the background, the sky and IBL stay black until the upload lands
+        TextureLoader* textureLoader = Renderer::GetTextureLoader();
+        m_EnvMap = textureLoader->Load("Resources/hdr/rogland_clear_night_4k.hdr", createInfo);
 
         createInfo.format = Format::RGBA8;
-        m_FallbackTexture = CreateRef<Texture2D>(createInfo, "Resources/textures/fallback.jpg");
+        m_FallbackTexture = textureLoader->Load("Resources/textures/fallback.jpg", createInfo);
 
         // Create skybox mesh
         auto skyboxMesh = MeshLoader::CreateSkyboxCube();
@@ -159,9 +181,6 @@ namespace flex
         };
         m_ViewportFB = Framebuffer::Create(viewportFBCreateInfo);
 
-        m_Bloom = CreateRef<Bloom>(viewportFBCreateInfo.width, viewportFBCreateInfo.height);
-        m_SSAO = CreateRef<SSAO>(viewportFBCreateInfo.width, viewportFBCreateInfo.height);
-
         // Render Here (main scene)
         m_Vp.viewport = { 0, 0, static_cast<uint32_t>(viewportFBCreateInfo.width), static_cast<uint32_t>(viewportFBCreateInfo.height) };
         m_Vp.isHovered = false;
@@ -243,18 +262,25 @@ namespace flex
                 }
             }
 
-            // Shadow pass (depth only per cascade)
-            glEnable(GL_DEPTH_TEST);
-            glCullFace(GL_FRONT); // reduce peter-panning
+            // Shadow pass (depth only per cascade). RenderState forgets everything at the end of each frame,
+            // so the frame starts by stating what it relies on
+            RenderState::SetEnabled(GL_DEPTH_TEST, true);
+            RenderState::SetEnabled(GL_CULL_FACE, true);
+            RenderState::SetDepthFunc(GL_LESS);
+            RenderState::SetDepthWrite(true);
+            RenderState::SetCullFace(GL_FRONT); // reduce peter-panning
+            // Casters in front of the cascade's near plane are culled in but would be clipped, clamp them onto it instead
+            RenderState::SetEnabled(GL_DEPTH_CLAMP, true);
             for (int ci = 0; ci < CascadedShadowMap::NumCascades; ++ci)
             {
                 m_CSM->BeginCascade(ci);
                 shadowDepthShader->Use();
                 shadowDepthShader->SetUniform("u_CascadeIndex", ci);
-                m_ActiveScene->RenderDepth(shadowDepthShader);
+                m_ActiveScene->RenderDepth(shadowDepthShader, m_CSM->GetData().lightViewProj[ci]);
             }
             m_CSM->EndCascade();
-            glCullFace(GL_BACK);
+            RenderState::SetEnabled(GL_DEPTH_CLAMP, false);
+            RenderState::SetCullFace(GL_BACK);
 
             // FIRST PASS: Render to framebuffer
             m_SceneFB->Bind(m_Vp.viewport);
@@ -262,14 +288,22 @@ namespace flex
             glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 
             // Render models first
-            glCullFace(GL_BACK);
-            PBRShader->Use();
+            RenderState::SetCullFace(GL_BACK);
             // Bind cascaded shadow map (binding = 6 in pbr.frag)
             m_CSM->BindTexture(6);
-            PBRShader->SetUniform("u_ShadowMap", 6);
-            PBRShader->SetUniform("u_DebugShadows", m_Camera.controls.debugShadowMode);
 
-            m_ActiveScene->Render(PBRShader, m_EnvMap);
+            uint32_t pbrFeatures = 0;
+            if (m_Camera.controls.debugShadowMode == 1)
+            {
+                pbrFeatures |= PBR_FEATURE_DEBUG_SHADOW_CASCADES;
+            }
+            else if (m_Camera.controls.debugShadowMode == 2)
+            {
+                pbrFeatures |= PBR_FEATURE_DEBUG_SHADOW_VISIBILITY;
+            }
+
+            Renderer::GetTextureStreamer()->SetViewportHeight(static_cast<uint32_t>(m_Vp.viewport.height));
+            m_ActiveScene->Render(PBRShaders, pbrFeatures, m_EnvMap, cameraData.viewProjection);
 
             if (m_ActiveScene)
             {
@@ -282,11 +316,9 @@ namespace flex
             if (m_Camera.projectionType == ProjectionType::Perspective)
             {
                 // Render skybox last (no depth writes, pass when depth equals far plane)
-                glDepthMask(GL_FALSE);
-                GLint prevDepthFunc; glGetIntegerv(GL_DEPTH_FUNC, &prevDepthFunc);
-                glDepthFunc(GL_LEQUAL);
-
-                glCullFace(GL_FRONT);
+                RenderState::SetDepthWrite(false);
+                RenderState::SetDepthFunc(GL_LEQUAL);
+                RenderState::SetCullFace(GL_FRONT);
 				skyboxShader->Use();
                 // Create skybox transformation (remove translation from view)
                 auto skyboxView = glm::mat4(glm::mat3(m_Camera.view));
@@ -294,13 +326,12 @@ namespace flex
                 skyboxShader->SetUniform("u_Transform", skyboxMVP);
                 m_EnvMap->Bind(0);
                 skyboxShader->SetUniform("u_EnvironmentMap", 0);
-                skyboxMesh->mesh->vertexArray->Bind();
-                Renderer::DrawIndexed(skyboxMesh->mesh->vertexArray);
+                Renderer::DrawMesh(*skyboxMesh->mesh);
 
                 // Restore state
-                glCullFace(GL_BACK);
-                glDepthFunc(prevDepthFunc);
-                glDepthMask(GL_TRUE);
+                RenderState::SetCullFace(GL_BACK);
+                RenderState::SetDepthFunc(GL_LESS);
+                RenderState::SetDepthWrite(true);
             }
 
             // SSAO pass (before screen composite) if enabled
@@ -327,8 +358,8 @@ namespace flex
                 glClearColor(0.0, 0.0, 0.0, 1.0);
 
                 // Disable depth testing and culling for screen quad
-                glDisable(GL_DEPTH_TEST);
-                glDisable(GL_CULL_FACE);
+                RenderState::SetEnabled(GL_DEPTH_TEST, false);
+                RenderState::SetEnabled(GL_CULL_FACE, false);
                 if (uint32_t screenTexture = m_SceneFB->GetColorAttachment(0))
                 {
                     if (m_Camera.postProcessing.enableBloom)
@@ -338,34 +369,27 @@ namespace flex
 
                         // Also bind the final high-quality bloom texture to slot 7
                         uint32_t bloomTex = m_Bloom->GetBloomTexture();
-                        if (bloomTex != 0)
-                        {
-                            glBindTextureUnit(3, bloomTex);
-                        }
-                        else
-                        {
-                            glBindTextureUnit(3, 0);
-                        }
+                        RenderState::BindTextureUnit(3, bloomTex);
                     }
                     // Bind SSAO texture (binding=8 in screen shader)
                     if (m_Camera.postProcessing.enableSSAO)
                     {
                         uint32_t aoTex = m_SSAO->GetAOTexture();
-                        glBindTextureUnit(8, aoTex);
+                        RenderState::BindTextureUnit(8, aoTex);
                     }
                     m_Screen->Render(screenTexture, m_SceneFB->GetDepthAttachment(), m_Camera, m_Camera.postProcessing);
                 }
 
                 // Restore depth testing and culling
-                glEnable(GL_DEPTH_TEST);
-                glEnable(GL_CULL_FACE);
+                RenderState::SetEnabled(GL_DEPTH_TEST, true);
+                RenderState::SetEnabled(GL_CULL_FACE, true);
             }
 
             // =========================================
             // ======== Render Main Framebuffer ========
 
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
-            glViewport(0, 0, static_cast<int>(m_Window->GetWidth()), static_cast<int>(m_Window->GetHeight()));
+            RenderState::BindFramebuffer(0);
+            RenderState::SetViewport(0, 0, static_cast<int>(m_Window->GetWidth()), static_cast<int>(m_Window->GetHeight()));
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
             ImGuiContext::NewFrame();
@@ -390,6 +414,7 @@ namespace flex
             ImGuiContext::Render();
 
             m_Window->SwapBuffers();
+            Renderer::EndFrame();
         }
     }
 
@@ -521,7 +546,11 @@ namespace flex
                 if (m_SelectedEntity != entt::null && m_ActiveScene->HasComponent<TransformComponent>(m_SelectedEntity))
                 {
                     auto& transform = m_ActiveScene->GetComponent<TransformComponent>(m_SelectedEntity);
-                    glm::mat4 model = math::ComposeTransform(transform);
+                    const auto& worldTransform = m_ActiveScene->GetComponent<WorldTransformComponent>(m_SelectedEntity);
+
+                    // Manipulate in world space, then bring the result back into the parent's space
+                    const glm::mat4 parentWorld = worldTransform.world * glm::inverse(worldTransform.local);
+                    glm::mat4 model = parentWorld * math::ComposeTransform(transform);
                     glm::mat4 view = m_Camera.view;
                     glm::mat4 projection = m_Camera.projection;
 
@@ -533,7 +562,7 @@ namespace flex
 
                     if (ImGuizmo::Manipulate(glm::value_ptr(view), glm::value_ptr(projection), m_GizmoOperation, m_GizmoMode, glm::value_ptr(model)))
                     {
-                        math::DecomposeTransform(model, transform);
+                        math::DecomposeTransform(glm::inverse(parentWorld) * model, transform);
                     }
                 }
             }
@@ -552,6 +581,48 @@ namespace flex
             ImGui::Text("FPS: %.1f", m_FrameData.fps);
             ImGui::Text("Delta ms: %.3f", m_FrameData.deltaTime * 1000.0);
 
+            if (m_ActiveScene)
+            {
+                const SceneStats& stats = m_ActiveScene->GetStats();
+                ImGui::Text("Meshes visible: %u culled: %u", stats.visibleMeshes, stats.culledMeshes);
+                ImGui::Text("Shadow casters drawn: %u culled: %u", stats.shadowCastersDrawn, stats.shadowCastersCulled);
+                ImGui::Text("Draw calls: %u instances: %u state changes: %u", stats.drawCalls, stats.drawInstances, stats.stateChanges);
+                ImGui::Text("Draw submission CPU: %.3f ms", stats.submitMs);
+            }
+
+            const StreamingBuffer* stream = Renderer::GetStreamingBuffer();
+            ImGui::Text("Streamed: %.1f KB / %.1f KB region, stalls: %u", stream->GetLastFrameBytes() / 1024.0f,
+                stream->GetRegionSize() / 1024.0f, stream->GetStallCount());
+            ImGui::Text("Material slots: %u", Renderer::GetMaterialTable()->GetSlotCount());
+            const MeshCacheStats& meshStats = MeshLoader::GetMeshCache().GetStats();
+            ImGui::Text("Mesh dedup: %u primitives, %u unique (%.2fx), %.1f KB saved", meshStats.requested, meshStats.created,
+                meshStats.GetDedupRatio(), meshStats.bytesSaved / 1024.0f);
+            ImGui::Text("Textures loading: %u", Renderer::GetTextureLoader()->GetPendingCount());
+            const TextureCacheStats textureStats = MeshLoader::GetTextureCache().GetStats();
+            ImGui::Text("Texture cache: %u requested, %u uploaded (%.0f%% hits), %.1f MB VRAM saved", textureStats.requested, textureStats.created,
+                textureStats.GetHitRate() * 100.0f, textureStats.bytesSaved / (1024.0f * 1024.0f));
+            const TextureTable* textureTable = Renderer::GetTextureTable();
+            if (textureTable->IsBindless())
+            {
+                ImGui::Text("Material textures: %u bindless", textureTable->GetTextureCount());
+            }
+            else
+            {
+                ImGui::Text("Material textures: %u in %u arrays", textureTable->GetTextureCount(), textureTable->GetArrayCount());
+            }
+            TextureStreamer* streamer = Renderer::GetTextureStreamer();
+            const TextureStreamerStats& streamStats = streamer->GetStats();
+            ImGui::Text("Texture streaming: %u textures, %.1f MB resident of %.1f MB, %u promoted, %u evicted", streamStats.textureCount,
+                streamStats.residentBytes / (1024.0f * 1024.0f), streamStats.fullBytes / (1024.0f * 1024.0f), streamStats.promotions, streamStats.evictions);
+            int budgetMB = static_cast<int>(streamer->GetBudget() >> 20);
+            if (ImGui::SliderInt("Texture budget (MB)", &budgetMB, 16, 2048))
+            {
+                streamer->SetBudget(static_cast<size_t>(budgetMB) << 20);
+            }
+            const ProgramCache* programCache = Renderer::GetProgramCache();
+            ImGui::Text("Program cache: %u hits, %u compiled, %u compiling", programCache->GetHitCount(),
+                programCache->GetMissCount(), Renderer::GetPendingShaderCount());
+
             // ============ Camera Settings ============
             if (ImGui::TreeNodeEx("Camera Settings", treeFlags))
             {
@@ -685,6 +756,25 @@ namespace flex
 
                 ImGui::TreePop();
             }
+
+            // ============ Render State ============
+            if (ImGui::TreeNodeEx("Render State", treeFlags))
+            {
+                static const std::array<const char*, static_cast<size_t>(RenderStateCall::Count)> callLabels =
+                {
+                    "Program", "Texture", "Vertex array", "Buffer", "Framebuffer",
+                    "Viewport", "Enable/Disable", "Depth", "Cull", "Blend"
+                };
+
+                const RenderStateStats& stateStats = RenderState::GetLastFrameStats();
+                ImGui::Text("GL calls issued: %u skipped: %u", stateStats.GetIssued(), stateStats.GetSkipped());
+                for (size_t i = 0; i < callLabels.size(); ++i)
+                {
+                    ImGui::Text("%-14s issued: %4u skipped: %4u", callLabels[i], stateStats.issued[i], stateStats.skipped[i]);
+                }
+
+                ImGui::TreePop();
+            }
         }
 
         ImGui::End();
@@ -779,9 +869,9 @@ namespace flex
 
                 if (ImGui::TreeNodeEx("Transform", treeNodeFlags))
                 {
-                    ImGui::DragFloat3("Position", &tr.position.x, 0.025);
-                    ImGui::DragFloat3("Rotation", &tr.rotation.x, 0.025);
-                    ImGui::DragFloat3("Scale", &tr.scale.x, 0.025);
+                    tr.dirty |= ImGui::DragFloat3("Position", &tr.position.x, 0.025);
+                    tr.dirty |= ImGui::DragFloat3("Rotation", &tr.rotation.x, 0.025);
+                    tr.dirty |= ImGui::DragFloat3("Scale", &tr.scale.x, 0.025);
 
                     ImGui::TreePop();
                 }
@@ -881,11 +971,15 @@ namespace flex
                             material->type = materialTypeIndex == 0 ? MaterialType::Opaque : MaterialType::Transparent;
                         }
 
-                        ImGui::ColorEdit4("Base Color", &material->params.baseColorFactor.x);
-                        ImGui::ColorEdit3("Emissive", &material->params.emissiveFactor.x);
-                        ImGui::SliderFloat("Metallic", &material->params.metallicFactor, 0.0f, 1.0f);
-                        ImGui::SliderFloat("Roughness", &material->params.roughnessFactor, 0.0f, 1.0f);
-                        ImGui::SliderFloat("Occlusion", &material->params.occlusionStrength, 0.0f, 1.0f);
+                        bool paramsChanged = ImGui::ColorEdit4("Base Color", &material->params.baseColorFactor.x);
+                        paramsChanged |= ImGui::ColorEdit3("Emissive", &material->params.emissiveFactor.x);
+                        paramsChanged |= ImGui::SliderFloat("Metallic", &material->params.metallicFactor, 0.0f, 1.0f);
+                        paramsChanged |= ImGui::SliderFloat("Roughness", &material->params.roughnessFactor, 0.0f, 1.0f);
+                        paramsChanged |= ImGui::SliderFloat("Occlusion", &material->params.occlusionStrength, 0.0f, 1.0f);
+                        if (paramsChanged)
+                        {
+                            material->MarkDirty();
+                        }
 
                         ImGui::SeparatorText("Textures");
                         auto drawTexturePreview = [this](const char* label, const Ref<Texture2D>& texture)
@@ -27,9 +27,14 @@
 #include "ImGuiContext.h"
 #include "Scene/Scene.h"
 #include "Renderer/CascadedShadowMap.h"
+#include "Renderer/VertexArray.h"
+#include "Renderer/VertexBuffer.h"
+#include "Renderer/IndexBuffer.h"
 #include "Camera.h"
 #include "Renderer/Material.h"
 #include "Renderer/Shader.h"
+#include "Renderer/ShaderVariants.h"
+#include "Renderer/RenderState.h"
 #include "Renderer/UniformBuffer.h"
 #include "Renderer/Font.h"
 #include "Renderer/Texture.h"
@@ -56,6 +61,18 @@ namespace flex
         constexpr int RENDER_MODE_DEPTH = 4;
     }
 
+    // Variant bits of screen.frag, the define of each bit is listed in Screen::Create
+    enum ScreenFeature : uint32_t
+    {
+        SCREEN_FEATURE_DOF = 1u << 0,
+        SCREEN_FEATURE_VIGNETTE = 1u << 1,
+        SCREEN_FEATURE_CHROMATIC_ABERRATION = 1u << 2,
+        SCREEN_FEATURE_BLOOM = 1u << 3,
+        SCREEN_FEATURE_SSAO = 1u << 4,
+        SCREEN_FEATURE_DEBUG_SSAO = 1u << 5,
+        SCREEN_FEATURE_COUNT = 6
+    };
+
     class Screen
     {
     public:
@@ -66,39 +83,63 @@ namespace flex
 
         void Render(uint32_t texture, uint32_t depthTex, const flex::Camera& camera, const flex::PostProcessing& postProcessing)
         {
-			shader->Use();
-            glBindTextureUnit(0, texture);
-            shader->SetUniform("u_ColorTexture", 0);
-            glBindTextureUnit(1, depthTex);
-            shader->SetUniform("u_DepthTexture", 1);
-
-            shader->SetUniform("u_FocalLength", camera.lens.focalLength);
-            shader->SetUniform("u_FocalDistance", camera.lens.focalDistance);
-            shader->SetUniform("u_FStop", camera.lens.fStop);
-            shader->SetUniform("u_FocusRange", camera.lens.focusRange);
-            shader->SetUniform("u_BlurAmount", camera.lens.blurAmount);
-            shader->SetUniform("u_InverseProjection", inverseProjection);
-            shader->SetUniform("u_Exposure", camera.lens.exposure);
-            shader->SetUniform("u_Gamma", camera.lens.gamma);
-            shader->SetUniform("u_EnableDOF", camera.lens.enableDOF ? 1 : 0);
-            shader->SetUniform("u_EnableVignette", postProcessing.enableVignette ? 1 : 0);
-            shader->SetUniform("u_EnableChromAb", postProcessing.enableChromAb ? 1 : 0);
-            shader->SetUniform("u_EnableBloom", postProcessing.enableBloom ? 1 : 0);
-            shader->SetUniform("u_EnableSSAO", postProcessing.enableSSAO ? 1 : 0);
-            shader->SetUniform("u_AOIntensity", postProcessing.aoIntensity);
-            shader->SetUniform("u_DebugSSAO", postProcessing.debugSSAO ? 1 : 0);
-            shader->SetUniform("u_VignetteRadius", postProcessing.vignetteRadius);
-            shader->SetUniform("u_VignetteSoftness", postProcessing.vignetteSoftness);
-            shader->SetUniform("u_VignetteIntensity", postProcessing.vignetteIntensity);
-            shader->SetUniform("u_VignetteColor", postProcessing.vignetteColor);
-            shader->SetUniform("u_ChromaticAberrationAmount", postProcessing.chromAbAmount);
-            shader->SetUniform("u_ChromaticAberrationRadial", postProcessing.chromAbRadial);
+            uint32_t features = 0;
+            features |= camera.lens.enableDOF ? SCREEN_FEATURE_DOF : 0u;
+            features |= postProcessing.enableVignette ? SCREEN_FEATURE_VIGNETTE : 0u;
+            features |= postProcessing.enableChromAb ? SCREEN_FEATURE_CHROMATIC_ABERRATION : 0u;
+            features |= postProcessing.enableBloom ? SCREEN_FEATURE_BLOOM : 0u;
+            if (postProcessing.enableSSAO)
+            {
+                features |= SCREEN_FEATURE_SSAO;
+                features |= postProcessing.debugSSAO ? SCREEN_FEATURE_DEBUG_SSAO : 0u;
+            }
+
+            Shader* shader = variants->Get(features);
+            shader->Use();
+
+            Uniforms& uniforms = variantUniforms[features];
+            if (!uniforms.resolved)
+            {
+                ResolveUniforms(shader, features, uniforms);
+            }
+
+            // Sampler units come from the layout bindings in screen.frag
+            RenderState::BindTextureUnit(0, texture);
+            RenderState::BindTextureUnit(1, depthTex);
+
+            shader->SetUniform(uniforms.inverseProjection, inverseProjection);
+            shader->SetUniform(uniforms.exposure, camera.lens.exposure);
+            shader->SetUniform(uniforms.gamma, camera.lens.gamma);
+            if (features & SCREEN_FEATURE_DOF)
+            {
+                shader->SetUniform(uniforms.focalLength, camera.lens.focalLength);
+                shader->SetUniform(uniforms.focalDistance, camera.lens.focalDistance);
+                shader->SetUniform(uniforms.fStop, camera.lens.fStop);
+                shader->SetUniform(uniforms.focusRange, camera.lens.focusRange);
+                shader->SetUniform(uniforms.blurAmount, camera.lens.blurAmount);
+            }
+            if (features & SCREEN_FEATURE_SSAO)
+            {
+                shader->SetUniform(uniforms.aoIntensity, postProcessing.aoIntensity);
+            }
+            if (features & SCREEN_FEATURE_VIGNETTE)
+            {
+                shader->SetUniform(uniforms.vignetteRadius, postProcessing.vignetteRadius);
+                shader->SetUniform(uniforms.vignetteSoftness, postProcessing.vignetteSoftness);
+                shader->SetUniform(uniforms.vignetteIntensity, postProcessing.vignetteIntensity);
+                shader->SetUniform(uniforms.vignetteColor, postProcessing.vignetteColor);
+            }
+            if (features & SCREEN_FEATURE_CHROMATIC_ABERRATION)
+            {
+                shader->SetUniform(uniforms.chromAbAmount, postProcessing.chromAbAmount);
+                shader->SetUniform(uniforms.chromAbRadial, postProcessing.chromAbRadial);
+            }
 
             vertexArray->Bind();
 
             // Ensure the index buffer is bound for glDrawElements
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer->GetHandle());
-            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+            glDrawElements(GL_TRIANGLES, 6, ToGLIndexType(indexBuffer->GetType()), nullptr);
         }
 
         void Create()
@@ -127,18 +168,78 @@ namespace flex
 
             assert(glGetError() == GL_NO_ERROR);
 
-            shader = Renderer::CreateShaderFromFile(
+            // Same order as ScreenFeature
+            variants = Renderer::CreateShaderVariants(
                 {
                     ShaderData{ "Resources/shaders/screen.vert.glsl", GL_VERTEX_SHADER },
                     ShaderData{ "Resources/shaders/screen.frag.glsl", GL_FRAGMENT_SHADER },
-				}, "ScreenShader");
+                },
+                { "ENABLE_DOF", "ENABLE_VIGNETTE", "ENABLE_CHROMATIC_ABERRATION", "ENABLE_BLOOM", "ENABLE_SSAO", "DEBUG_SSAO" },
+                "ScreenShader");
+            variantUniforms.resize(size_t(1) << SCREEN_FEATURE_COUNT);
+        }
+
+        struct Uniforms
+        {
+            UniformHandle<float> focalLength;
+            UniformHandle<float> focalDistance;
+            UniformHandle<float> fStop;
+            UniformHandle<float> focusRange;
+            UniformHandle<float> blurAmount;
+            UniformHandle<glm::mat4> inverseProjection;
+            UniformHandle<float> exposure;
+            UniformHandle<float> gamma;
+            UniformHandle<float> aoIntensity;
+            UniformHandle<float> vignetteRadius;
+            UniformHandle<float> vignetteSoftness;
+            UniformHandle<float> vignetteIntensity;
+            UniformHandle<glm::vec3> vignetteColor;
+            UniformHandle<float> chromAbAmount;
+            UniformHandle<float> chromAbRadial;
+            bool resolved = false;
+        };
+
+        // Deferred to the variant's first Render, resolving needs the linked program.
+        // Uniforms of disabled features are compiled out and stay unresolved
+        static void ResolveUniforms(Shader* shader, uint32_t features, Uniforms& uniforms)
+        {
+            uniforms.resolved = true;
+            uniforms.inverseProjection = shader->GetUniform<glm::mat4>("u_InverseProjection");
+            uniforms.exposure = shader->GetUniform<float>("u_Exposure");
+            uniforms.gamma = shader->GetUniform<float>("u_Gamma");
+            if (features & SCREEN_FEATURE_DOF)
+            {
+                uniforms.focalLength = shader->GetUniform<float>("u_FocalLength");
+                uniforms.focalDistance = shader->GetUniform<float>("u_FocalDistance");
+                uniforms.fStop = shader->GetUniform<float>("u_FStop");
+                uniforms.focusRange = shader->GetUniform<float>("u_FocusRange");
+                uniforms.blurAmount = shader->GetUniform<float>("u_BlurAmount");
+            }
+            if (features & SCREEN_FEATURE_SSAO)
+            {
+                uniforms.aoIntensity = shader->GetUniform<float>("u_AOIntensity");
+            }
+            if (features & SCREEN_FEATURE_VIGNETTE)
+            {
+                uniforms.vignetteRadius = shader->GetUniform<float>("u_VignetteRadius");
+                uniforms.vignetteSoftness = shader->GetUniform<float>("u_VignetteSoftness");
+                uniforms.vignetteIntensity = shader->GetUniform<float>("u_VignetteIntensity");
+                uniforms.vignetteColor = shader->GetUniform<glm::vec3>("u_VignetteColor");
+            }
+            if (features & SCREEN_FEATURE_CHROMATIC_ABERRATION)
+            {
+                uniforms.chromAbAmount = shader->GetUniform<float>("u_ChromaticAberrationAmount");
+                uniforms.chromAbRadial = shader->GetUniform<float>("u_ChromaticAberrationRadial");
+            }
         }
 
         std::shared_ptr<VertexArray> vertexArray;
         std::shared_ptr<VertexBuffer> vertexBuffer;
         std::shared_ptr<IndexBuffer> indexBuffer;
 
-        Ref<Shader> shader;
+        Ref<ShaderVariants> variants;
+        // Indexed by the feature key like the variants, handles differ between programs
+        std::vector<Uniforms> variantUniforms;
         glm::mat4 inverseProjection = glm::mat4(1.0f);
     };
 
@@ -0,0 +1,51 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#include "FileSystem.h"
+
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace flex
+{
+    bool WriteFileAtomic(const std::filesystem::path &path, const std::function<void(std::ofstream &file)> &write)
+    {
+        std::error_code error;
+        std::filesystem::create_directories(path.parent_path(), error);
+
+        // Unique per call, writers of the same path never share a temporary file. The last rename wins,
+        // each one moves a complete file into place
+        static std::atomic<uint64_t> s_WriteCount = 0;
+        const size_t thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+        std::filesystem::path tempPath = path;
+        tempPath += "." + std::to_string(thread) + "." + std::to_string(s_WriteCount++) + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                std::cerr << "Failed to write " << tempPath << '\n';
+                return false;
+            }
+
+            write(file);
+            file.flush();
+            if (!file)
+            {
+                std::cerr << "Failed to write " << tempPath << '\n';
+                file.close();
+                std::filesystem::remove(tempPath, error);
+                return false;
+            }
+        }
+
+        std::filesystem::rename(tempPath, path, error);
+        if (error)
+        {
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+        return true;
+    }
+}
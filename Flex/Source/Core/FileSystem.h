@@ -0,0 +1,18 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#ifndef FILE_SYSTEM_H
+#define FILE_SYSTEM_H
+
+#include <filesystem>
+#include <fstream>
+#include <functional>
+
+namespace flex
+{
+    // Creates the parent directories and runs write on a temporary file next to path, which is renamed over
+    // path once written. A crash or failed write never leaves a truncated file under the real name.
+    // Safe to call from several threads for the same path
+    bool WriteFileAtomic(const std::filesystem::path &path, const std::function<void(std::ofstream &file)> &write);
+}
+
+#endif
@@ -0,0 +1,94 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#include "Hash.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <vector>
+
+namespace flex
+{
+    namespace
+    {
+        constexpr size_t kHashChunkSize = 256 * 1024;
+
+        constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+        constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+        constexpr uint64_t kPrime3 = 0x165667B19E3779F9ull;
+
+        uint64_t Round(uint64_t acc, uint64_t input)
+        {
+            acc += input * kPrime2;
+            acc = std::rotl(acc, 31);
+            return acc * kPrime1;
+        }
+
+        uint64_t Avalanche(uint64_t hash)
+        {
+            hash ^= hash >> 33;
+            hash *= kPrime2;
+            hash ^= hash >> 29;
+            hash *= kPrime3;
+            hash ^= hash >> 32;
+            return hash;
+        }
+
+        // Two independent 64-bit lanes over 16 byte blocks, mixed into each other at the end
+        Hash128 HashChunk(const uint8_t *data, size_t size, uint64_t seed)
+        {
+            uint64_t a = seed + kPrime1;
+            uint64_t b = seed ^ kPrime2;
+
+            size_t offset = 0;
+            for (; offset + 16 <= size; offset += 16)
+            {
+                uint64_t words[2];
+                std::memcpy(words, data + offset, sizeof(words));
+                a = Round(a, words[0]);
+                b = Round(b, words[1]);
+            }
+
+            if (offset < size)
+            {
+                // Zero padded, the length below keeps "ab\0" and "ab" apart
+                uint64_t words[2] = {};
+                std::memcpy(words, data + offset, size - offset);
+                a = Round(a, words[0]);
+                b = Round(b, words[1]);
+            }
+
+            a = Round(a, size);
+            b = Round(b, size ^ kPrime3);
+
+            Hash128 hash;
+            hash.low = Avalanche(a ^ std::rotl(b, 17));
+            hash.high = Avalanche(b + std::rotl(a, 41));
+            return hash;
+        }
+    }
+
+    Hash128 HashData(const void *data, size_t size, uint64_t seed)
+    {
+        const uint8_t *bytes = static_cast<const uint8_t *>(data);
+        if (size <= kHashChunkSize)
+        {
+            return HashChunk(bytes, size, seed);
+        }
+
+        // Chunk hashes are seeded by their index, then hashed in order
+        const size_t chunkCount = (size + kHashChunkSize - 1) / kHashChunkSize;
+        std::vector<Hash128> chunks(chunkCount);
+        ThreadPool::ParallelFor(chunkCount, 1, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                const size_t offset = i * kHashChunkSize;
+                chunks[i] = HashChunk(bytes + offset, std::min(kHashChunkSize, size - offset), seed + i + 1);
+            }
+        });
+
+        return HashChunk(reinterpret_cast<const uint8_t *>(chunks.data()), chunks.size() * sizeof(Hash128), size + seed);
+    }
+}
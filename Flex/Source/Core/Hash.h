@@ -0,0 +1,32 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace flex
+{
+    // 128-bit content hash, used as a deduplication and disk cache key
+    struct Hash128
+    {
+        uint64_t low = 0;
+        uint64_t high = 0;
+
+        bool operator==(const Hash128 &other) const = default;
+    };
+
+    struct Hash128Hasher
+    {
+        // Both halves are already well mixed
+        std::size_t operator()(const Hash128 &hash) const noexcept { return static_cast<std::size_t>(hash.low); }
+    };
+
+    // Buffers larger than one chunk are hashed chunk by chunk on the ThreadPool.
+    // Chunk boundaries are fixed, so the result does not depend on the worker count.
+    // Digests with different seeds are independent, data colliding under one seed is unlikely to under another
+    Hash128 HashData(const void *data, size_t size, uint64_t seed = 0);
+}
+
+#endif
@@ -0,0 +1,149 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace flex
+{
+    static ThreadPool* s_ThreadPool = nullptr;
+
+    void ThreadPool::Init(uint32_t workerCount)
+    {
+        if (s_ThreadPool)
+        {
+            return;
+        }
+
+        if (workerCount == 0)
+        {
+            const uint32_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+            workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+        }
+
+        s_ThreadPool = new ThreadPool(workerCount);
+    }
+
+    void ThreadPool::Shutdown()
+    {
+        delete s_ThreadPool;
+        s_ThreadPool = nullptr;
+    }
+
+    ThreadPool* ThreadPool::Get()
+    {
+        return s_ThreadPool;
+    }
+
+    ThreadPool::ThreadPool(uint32_t workerCount)
+    {
+        m_Workers.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; ++i)
+        {
+            m_Workers.emplace_back([this]() { WorkerLoop(); });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stop = true;
+        }
+        m_Condition.notify_all();
+
+        for (std::thread& worker : m_Workers)
+        {
+            if (worker.joinable())
+            {
+                worker.join();
+            }
+        }
+    }
+
+    void ThreadPool::Enqueue(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Tasks.push(std::move(task));
+        }
+        m_Condition.notify_one();
+    }
+
+    void ThreadPool::WorkerLoop()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_Condition.wait(lock, [this]() { return m_Stop || !m_Tasks.empty(); });
+                if (m_Stop && m_Tasks.empty())
+                {
+                    return;
+                }
+
+                task = std::move(m_Tasks.front());
+                m_Tasks.pop();
+            }
+
+            task();
+        }
+    }
+
+    void ThreadPool::ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t begin, size_t end)>& func)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        chunkSize = std::max<size_t>(chunkSize, 1);
+        const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+        if (!s_ThreadPool || chunkCount == 1)
+        {
+            func(0, count);
+            return;
+        }
+
+        struct Batch
+        {
+            std::atomic<size_t> nextChunk = 0;
+            std::atomic<size_t> finishedChunks = 0;
+            std::mutex mutex;
+            std::condition_variable done;
+        };
+
+        // Helpers may start after every chunk was taken, so the batch is shared
+        auto batch = std::make_shared<Batch>();
+        const auto runChunks = [batch, count, chunkSize, chunkCount, &func]()
+        {
+            size_t processed = 0;
+            for (size_t chunk = batch->nextChunk++; chunk < chunkCount; chunk = batch->nextChunk++)
+            {
+                const size_t begin = chunk * chunkSize;
+                func(begin, std::min(begin + chunkSize, count));
+                ++processed;
+            }
+
+            if (processed > 0 && batch->finishedChunks.fetch_add(processed) + processed == chunkCount)
+            {
+                std::lock_guard<std::mutex> lock(batch->mutex);
+                batch->done.notify_all();
+            }
+        };
+
+        const size_t helperCount = std::min<size_t>(s_ThreadPool->GetWorkerCount(), chunkCount - 1);
+        for (size_t i = 0; i < helperCount; ++i)
+        {
+            s_ThreadPool->Enqueue(runChunks);
+        }
+
+        runChunks();
+
+        std::unique_lock<std::mutex> lock(batch->mutex);
+        batch->done.wait(lock, [&batch, chunkCount]() { return batch->finishedChunks.load() == chunkCount; });
+    }
+}
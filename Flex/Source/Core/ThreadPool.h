@@ -0,0 +1,49 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace flex
+{
+    // Engine wide worker pool used for CPU side work (transforms, asset import)
+    // that should not go through the physics job system
+    class ThreadPool
+    {
+    public:
+        // workerCount = 0 uses hardware_concurrency - 1 workers
+        static void Init(uint32_t workerCount = 0);
+        static void Shutdown();
+
+        static ThreadPool* Get();
+
+        // Splits [0, count) into chunks of at most chunkSize and blocks until every chunk ran.
+        // The calling thread processes chunks too. Runs inline when the pool is not initialized.
+        static void ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t begin, size_t end)>& func);
+
+        void Enqueue(std::function<void()> task);
+        uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+
+        ~ThreadPool();
+
+    private:
+        explicit ThreadPool(uint32_t workerCount);
+        void WorkerLoop();
+
+        std::vector<std::thread> m_Workers;
+        std::queue<std::function<void()>> m_Tasks;
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        bool m_Stop = false;
+    };
+}
+
+#endif
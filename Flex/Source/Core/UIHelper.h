@@ -15,8 +15,16 @@ namespace flex
 {
     inline void UIDrawImage(const std::shared_ptr<Texture2D> &texture, float width, float height, const std::string &text = "")
     {
-        ImTextureID texID = static_cast<ImTextureID>(texture->GetHandle());
-        ImGui::Image(texID, {width, height}, {0, 1}, {1, 0});
+        // Keeps the layout while the texture is still loading
+        if (texture->IsReady())
+        {
+            ImTextureID texID = static_cast<ImTextureID>(texture->GetHandle());
+            ImGui::Image(texID, {width, height}, {0, 1}, {1, 0});
+        }
+        else
+        {
+            ImGui::Dummy({width, height});
+        }
     
         if (!text.empty())
         {
@@ -0,0 +1,225 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#ifndef BOUNDS_HPP
+#define BOUNDS_HPP
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace flex
+{
+    struct AABB
+    {
+        glm::vec3 min = glm::vec3(FLT_MAX);
+        glm::vec3 max = glm::vec3(-FLT_MAX);
+
+        AABB() = default;
+        AABB(const glm::vec3& min, const glm::vec3& max)
+            : min(min), max(max)
+        {
+        }
+
+        bool IsValid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+        glm::vec3 GetCenter() const { return (min + max) * 0.5f; }
+        glm::vec3 GetExtents() const { return (max - min) * 0.5f; }
+
+        void Expand(const glm::vec3& point)
+        {
+            min = glm::min(min, point);
+            max = glm::max(max, point);
+        }
+
+        void Expand(const AABB& other)
+        {
+            min = glm::min(min, other.min);
+            max = glm::max(max, other.max);
+        }
+
+        bool Contains(const AABB& other) const
+        {
+            return glm::all(glm::lessThanEqual(min, other.min)) && glm::all(glm::greaterThanEqual(max, other.max));
+        }
+
+        bool Overlaps(const AABB& other) const
+        {
+            return glm::all(glm::lessThanEqual(min, other.max)) && glm::all(glm::greaterThanEqual(max, other.min));
+        }
+
+        float GetSurfaceArea() const
+        {
+            const glm::vec3 size = max - min;
+            return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+        }
+
+        static AABB Union(const AABB& a, const AABB& b)
+        {
+            return AABB(glm::min(a.min, b.min), glm::max(a.max, b.max));
+        }
+    };
+
+    enum class Containment
+    {
+        Outside,
+        Intersects,
+        Inside
+    };
+
+    struct BoundingSphere
+    {
+        glm::vec3 center = glm::vec3(0.0f);
+        float radius = 0.0f;
+    };
+
+    // Six planes stored as (normal, distance) with normals pointing into the volume
+    struct Frustum
+    {
+        enum Plane
+        {
+            Left = 0,
+            Right,
+            Bottom,
+            Top,
+            Near,
+            Far,
+            Count
+        };
+
+        glm::vec4 planes[Count];
+
+        // Gribb/Hartmann extraction, expects OpenGL clip space (-w <= z <= w)
+        static Frustum FromMatrix(const glm::mat4& m)
+        {
+            const glm::vec4 row0 = { m[0][0], m[1][0], m[2][0], m[3][0] };
+            const glm::vec4 row1 = { m[0][1], m[1][1], m[2][1], m[3][1] };
+            const glm::vec4 row2 = { m[0][2], m[1][2], m[2][2], m[3][2] };
+            const glm::vec4 row3 = { m[0][3], m[1][3], m[2][3], m[3][3] };
+
+            Frustum frustum;
+            frustum.planes[Left] = row3 + row0;
+            frustum.planes[Right] = row3 - row0;
+            frustum.planes[Bottom] = row3 + row1;
+            frustum.planes[Top] = row3 - row1;
+            frustum.planes[Near] = row3 + row2;
+            frustum.planes[Far] = row3 - row2;
+
+            for (glm::vec4& plane : frustum.planes)
+            {
+                const float length = glm::length(glm::vec3(plane));
+                if (length > 0.0f)
+                {
+                    plane /= length;
+                }
+            }
+
+            return frustum;
+        }
+
+        // A disabled plane accepts everything
+        void DisablePlane(Plane plane)
+        {
+            planes[plane] = glm::vec4(0.0f, 0.0f, 0.0f, FLT_MAX);
+        }
+
+        bool Intersects(const BoundingSphere& sphere) const
+        {
+            for (const glm::vec4& plane : planes)
+            {
+                if (glm::dot(glm::vec3(plane), sphere.center) + plane.w < -sphere.radius)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        Containment Classify(const AABB& box) const
+        {
+            const glm::vec3 center = box.GetCenter();
+            const glm::vec3 extents = box.GetExtents();
+            Containment result = Containment::Inside;
+            for (const glm::vec4& plane : planes)
+            {
+                const glm::vec3 normal = glm::vec3(plane);
+                const float radius = glm::dot(extents, glm::abs(normal));
+                const float distance = glm::dot(normal, center) + plane.w;
+                if (distance < -radius)
+                {
+                    return Containment::Outside;
+                }
+                if (distance < radius)
+                {
+                    result = Containment::Intersects;
+                }
+            }
+            return result;
+        }
+
+        // Conservative: boxes straddling two planes outside a corner may pass
+        bool Intersects(const AABB& box) const
+        {
+            const glm::vec3 center = box.GetCenter();
+            const glm::vec3 extents = box.GetExtents();
+            for (const glm::vec4& plane : planes)
+            {
+                const glm::vec3 normal = glm::vec3(plane);
+                const float radius = glm::dot(extents, glm::abs(normal));
+                if (glm::dot(normal, center) + plane.w < -radius)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    namespace math
+    {
+        // Arvo's method, the result encloses the transformed box
+        static AABB TransformAABB(const AABB& box, const glm::mat4& matrix)
+        {
+            const glm::vec3 center = glm::vec3(matrix * glm::vec4(box.GetCenter(), 1.0f));
+            const glm::mat3 absolute = glm::mat3(glm::abs(glm::vec3(matrix[0])), glm::abs(glm::vec3(matrix[1])), glm::abs(glm::vec3(matrix[2])));
+            const glm::vec3 extents = absolute * box.GetExtents();
+            return AABB(center - extents, center + extents);
+        }
+
+        static bool IntersectSphereAABB(const BoundingSphere& sphere, const AABB& box)
+        {
+            const glm::vec3 closest = glm::clamp(sphere.center, box.min, box.max);
+            const glm::vec3 offset = closest - sphere.center;
+            return glm::dot(offset, offset) <= sphere.radius * sphere.radius;
+        }
+
+        // Slab test, invDirection = 1 / direction. outDistance is the entry distance (0 when starting inside)
+        static bool IntersectRayAABB(const glm::vec3& origin, const glm::vec3& invDirection, float maxDistance, const AABB& box, float& outDistance)
+        {
+            const glm::vec3 t0 = (box.min - origin) * invDirection;
+            const glm::vec3 t1 = (box.max - origin) * invDirection;
+            const glm::vec3 tNear = glm::min(t0, t1);
+            const glm::vec3 tFar = glm::max(t0, t1);
+            const float enter = std::max({ tNear.x, tNear.y, tNear.z, 0.0f });
+            const float exit = std::min({ tFar.x, tFar.y, tFar.z, maxDistance });
+            outDistance = enter;
+            return enter <= exit;
+        }
+
+        static BoundingSphere TransformSphere(const BoundingSphere& sphere, const glm::mat4& matrix)
+        {
+            const float maxScaleSq = std::max({
+                glm::dot(glm::vec3(matrix[0]), glm::vec3(matrix[0])),
+                glm::dot(glm::vec3(matrix[1]), glm::vec3(matrix[1])),
+                glm::dot(glm::vec3(matrix[2]), glm::vec3(matrix[2]))
+            });
+
+            BoundingSphere result;
+            result.center = glm::vec3(matrix * glm::vec4(sphere.center, 1.0f));
+            result.radius = sphere.radius * std::sqrt(maxScaleSq);
+            return result;
+        }
+    }
+}
+
+#endif
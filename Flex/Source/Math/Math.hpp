@@ -46,6 +46,7 @@ namespace flex::math
 		outTransform.position = translation;
 		outTransform.scale = scale;
 		outTransform.rotation = glm::degrees(glm::eulerAngles(orientation));
+		outTransform.dirty = true;
 	}
 }
 
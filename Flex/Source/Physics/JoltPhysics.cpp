@@ -166,6 +166,7 @@ namespace flex
 
 			transform.position = GetPosition(rb.bodyID);
 			transform.rotation = GetEulerAngles(rb.bodyID);
+			transform.dirty = true;
 		});
 	}
 
@@ -3,6 +3,7 @@
 #include "Bloom.h"
 
 #include "Renderer.h"
+#include "RenderState.h"
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
@@ -44,7 +45,7 @@ namespace flex
     {
         if (m_Vao != 0)
         {
-            glDeleteVertexArrays(1, &m_Vao);
+            RenderState::DeleteVertexArray(m_Vao);
         }
 
         m_Vao = 0;
@@ -134,9 +135,9 @@ namespace flex
         if (m_Levels.empty())
             return;
 
-        glDisable(GL_DEPTH_TEST);
-        glDisable(GL_CULL_FACE);
-        glBindVertexArray(m_Vao);
+        RenderState::SetEnabled(GL_DEPTH_TEST, false);
+        RenderState::SetEnabled(GL_CULL_FACE, false);
+        RenderState::BindVertexArray(m_Vao);
 
         uint32_t prevTex = sourceTex;
 
@@ -153,7 +154,7 @@ namespace flex
             glClear(GL_COLOR_BUFFER_BIT);
 
             m_DownsampleShader->Use();
-            glBindTextureUnit(0, prevTex);
+            RenderState::BindTextureUnit(0, prevTex);
             m_DownsampleShader->SetUniform("u_Src", 0);
             m_DownsampleShader->SetUniform("u_Intensity", settings.intensity);
             m_DownsampleShader->SetUniform("u_Knee", settings.knee);
@@ -183,7 +184,7 @@ namespace flex
             glClear(GL_COLOR_BUFFER_BIT);
             
             m_BlurShader->Use();
-            glBindTextureUnit(0, lvl.fbDown->GetColorAttachment(0));
+            RenderState::BindTextureUnit(0, lvl.fbDown->GetColorAttachment(0));
             m_BlurShader->SetUniform("u_Src", 0);
             m_BlurShader->SetUniform("u_Horizontal", 1);
             glDrawArrays(GL_TRIANGLES, 0, 3);
@@ -192,7 +193,7 @@ namespace flex
             lvl.fbBlurV->Bind(vp);
             glClear(GL_COLOR_BUFFER_BIT);
             
-            glBindTextureUnit(0, lvl.fbBlurH->GetColorAttachment(0));
+            RenderState::BindTextureUnit(0, lvl.fbBlurH->GetColorAttachment(0));
             m_BlurShader->SetUniform("u_Src", 0);
             m_BlurShader->SetUniform("u_Horizontal", 0);
             glDrawArrays(GL_TRIANGLES, 0, 3);
@@ -224,8 +225,8 @@ namespace flex
                 glClear(GL_COLOR_BUFFER_BIT);
                 
                 m_UpsampleShader->Use();
-                glBindTextureUnit(0, currentTex);  // Lower resolution
-                glBindTextureUnit(1, lvl.fbBlurV->GetColorAttachment(0));  // Current level
+                RenderState::BindTextureUnit(0, currentTex);  // Lower resolution
+                RenderState::BindTextureUnit(1, lvl.fbBlurV->GetColorAttachment(0));  // Current level
                 m_UpsampleShader->SetUniform("u_LowRes", 0);
                 m_UpsampleShader->SetUniform("u_HighRes", 1);
                 m_UpsampleShader->SetUniform("u_Radius", settings.radius * (float)(i + 1));
@@ -241,7 +242,7 @@ namespace flex
     {
         for (size_t i = 0; i < m_Levels.size() && i < 5; ++i)
         {
-            glBindTextureUnit(2 + (uint32_t)i, m_Levels[i].fbBlurV->GetColorAttachment(0));
+            RenderState::BindTextureUnit(2 + (uint32_t)i, m_Levels[i].fbBlurV->GetColorAttachment(0));
         }
     }
 
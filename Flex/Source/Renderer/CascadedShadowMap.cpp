@@ -4,6 +4,7 @@
 
 #include "CascadedShadowMap.h"
 #include "Renderer/UniformBuffer.h"
+#include "RenderState.h"
 #include "Core/Camera.h"
 
 #include <glad/glad.h>
@@ -68,12 +69,12 @@ namespace flex
     {
         if (m_DepthArray) 
         {
-            glDeleteTextures(1, &m_DepthArray);
+            RenderState::DeleteTexture(m_DepthArray);
         }
         
         if (m_FBO)
         {
-            glDeleteFramebuffers(1, &m_FBO);
+            RenderState::DeleteFramebuffer(m_FBO);
         } 
         
         m_DepthArray = 0;
@@ -221,8 +222,8 @@ namespace flex
 
     void CascadedShadowMap::BeginCascade(int cascadeIndex)
     {
-        glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
-        glViewport(0, 0, m_Resolution, m_Resolution);
+        RenderState::BindFramebuffer(m_FBO);
+        RenderState::SetViewport(0, 0, m_Resolution, m_Resolution);
         glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_DepthArray, 0, cascadeIndex);
         glDrawBuffer(GL_NONE);
         glReadBuffer(GL_NONE);
@@ -231,12 +232,12 @@ namespace flex
 
     void CascadedShadowMap::EndCascade()
     {
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        RenderState::BindFramebuffer(0);
     }
 
     void CascadedShadowMap::BindTexture(int unit) const
     {
-        glBindTextureUnit(unit, m_DepthArray);
+        RenderState::BindTextureUnit(unit, m_DepthArray);
     }
 
     void CascadedShadowMap::Upload()
@@ -4,6 +4,7 @@
 
 #include "Renderer.h"
 #include "Shader.h"
+#include "RenderState.h"
 
 #include "VertexArray.h"
 #include "IndexBuffer.h"
@@ -111,17 +112,15 @@ namespace flex
         msdfgen::BitmapConstRef<float, 3> bitmap = generator.atlasStorage();
 
         // Create atlas texture (keep float precision for MSDF)
-        glGenTextures(1, &m_TextureHandle);
-        glBindTexture(GL_TEXTURE_2D, m_TextureHandle);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB32F, width, height, 0, GL_RGB, GL_FLOAT, bitmap.pixels);
+        glCreateTextures(GL_TEXTURE_2D, 1, &m_TextureHandle);
+        glTextureStorage2D(m_TextureHandle, 1, GL_RGB32F, width, height);
+        glTextureSubImage2D(m_TextureHandle, 0, 0, 0, width, height, GL_RGB, GL_FLOAT, bitmap.pixels);
 
         // Set texture options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        glBindTexture(GL_TEXTURE_2D, 0);
+        glTextureParameteri(m_TextureHandle, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTextureParameteri(m_TextureHandle, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTextureParameteri(m_TextureHandle, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTextureParameteri(m_TextureHandle, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
         msdfgen::destroyFont(font);
         msdfgen::deinitializeFreetype(ft);
@@ -129,7 +128,7 @@ namespace flex
 
     Font::~Font()
     {
-        glDeleteTextures(1, &m_TextureHandle);
+        RenderState::DeleteTexture(m_TextureHandle);
     }
 
     // ------------------------
@@ -167,12 +166,6 @@ namespace flex
                 ShaderData{ "Resources/shaders/text.frag.glsl", GL_FRAGMENT_SHADER, 0 },
             }, "TextShader");
 
-        // Bind sampler array once (textures[0..31])
-        s_TextData->shader->Use();
-        for (int i = 0; i < 32; ++i)
-        {
-            s_TextData->shader->SetUniform(std::string("textures[") + std::to_string(i) + "]", i);
-        }
 
         s_TextData->fonts = {nullptr};
         s_TextData->vertexPointerBase = new FontVertex[TextRendererData::MAX_VERTICES];
@@ -228,8 +221,8 @@ namespace flex
         s_TextData->shader->Use();
         s_TextData->shader->SetUniform("viewProjection", viewProjection);
 
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        RenderState::SetEnabled(GL_BLEND, true);
+        RenderState::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     }
 
     void TextRenderer::End()
@@ -245,12 +238,11 @@ namespace flex
             {
                 if (s_TextData->fonts[i])
                 {
-                    glActiveTexture(GL_TEXTURE0 + i);
-                    glBindTexture(GL_TEXTURE_2D, s_TextData->fonts[i]->GetTextureHandle());
+                    RenderState::BindTextureUnit(i, s_TextData->fonts[i]->GetTextureHandle());
                 }
             }
 
-            glDrawElements(GL_TRIANGLES, s_TextData->indexCount, GL_UNSIGNED_INT, nullptr);
+            glDrawElements(GL_TRIANGLES, s_TextData->indexCount, ToGLIndexType(s_TextData->indexBuffer->GetType()), nullptr);
         }
     }
 
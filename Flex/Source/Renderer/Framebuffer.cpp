@@ -1,6 +1,7 @@
 // Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
 
 #include "Framebuffer.h"
+#include "RenderState.h"
 #include <glad/glad.h>
 
 namespace flex
@@ -14,7 +15,7 @@ namespace flex
         m_Viewport.height = createInfo.height;
 
         glCreateFramebuffers(1, &m_Handle);
-        glBindFramebuffer(GL_FRAMEBUFFER, m_Handle);
+        RenderState::BindFramebuffer(m_Handle);
 
         CreateAttachments();
         assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE && "Failed to create framebuffer");
@@ -22,19 +23,19 @@ namespace flex
 
     Framebuffer::~Framebuffer()
     {
-        glDeleteFramebuffers(1, &m_Handle);
+        RenderState::DeleteFramebuffer(m_Handle);
 
         // Delete old color attachments
         for (uint32_t texture : m_ColorAttachments)
         {
-            glDeleteTextures(1, &texture);
+            RenderState::DeleteTexture(texture);
         }
 
         m_ColorAttachments.clear();
 
         if (m_DepthAttachment != 0)
         {
-            glDeleteTextures(1, &m_DepthAttachment);
+            RenderState::DeleteTexture(m_DepthAttachment);
         }
     }
 
@@ -59,24 +60,24 @@ namespace flex
             return;
         }
 
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        RenderState::BindFramebuffer(0);
         glFlush();
 
         for (uint32_t texture : m_ColorAttachments)
         {
-            glDeleteTextures(1, &texture);
+            RenderState::DeleteTexture(texture);
         }
         m_ColorAttachments.clear();
 
         if (m_DepthAttachment != 0)
         {
-            glDeleteTextures(1, &m_DepthAttachment);
+            RenderState::DeleteTexture(m_DepthAttachment);
             m_DepthAttachment = 0;
         }
 
         if (m_Handle != 0)
         {
-            glDeleteFramebuffers(1, &m_Handle);
+            RenderState::DeleteFramebuffer(m_Handle);
             m_Handle = 0;
         }
 
@@ -86,12 +87,12 @@ namespace flex
         m_Viewport.height = height;
 
         glCreateFramebuffers(1, &m_Handle);
-        glBindFramebuffer(GL_FRAMEBUFFER, m_Handle);
+        RenderState::BindFramebuffer(m_Handle);
 
         CreateAttachments();
         assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE && "Failed to resize framebuffer");
 
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        RenderState::BindFramebuffer(0);
     }
 
     void Framebuffer::Bind(const Viewport& viewport)
@@ -99,10 +100,10 @@ namespace flex
         m_Viewport = viewport;
 
         // Bind framebuffer first
-        glBindFramebuffer(GL_FRAMEBUFFER, m_Handle);
+        RenderState::BindFramebuffer(m_Handle);
 
         // Then set viewport
-        glViewport(viewport.x, viewport.y, viewport.width, viewport.height);
+        RenderState::SetViewport(viewport.x, viewport.y, viewport.width, viewport.height);
     }
 
     void Framebuffer::ClearColorAttachment(int index, const glm::vec4& color)
@@ -143,29 +144,27 @@ namespace flex
             if (attachment.format == Format::DEPTH24STENCIL8)
             {
                 glCreateTextures(GL_TEXTURE_2D, 1, &m_DepthAttachment);
-                glBindTexture(GL_TEXTURE_2D, m_DepthAttachment);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+                glTextureParameteri(m_DepthAttachment, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+                glTextureParameteri(m_DepthAttachment, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+                glTextureParameteri(m_DepthAttachment, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                glTextureParameteri(m_DepthAttachment, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
                 float borderColor[] = { 1.0f,1.0f,1.0f,1.0f };
-                glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-                glTexStorage2D(GL_TEXTURE_2D, 1, internalFormat, m_CreateInfo.width, m_CreateInfo.height);
-                glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, m_DepthAttachment, 0);
+                glTextureParameterfv(m_DepthAttachment, GL_TEXTURE_BORDER_COLOR, borderColor);
+                glTextureStorage2D(m_DepthAttachment, 1, internalFormat, m_CreateInfo.width, m_CreateInfo.height);
+                glNamedFramebufferTexture(m_Handle, GL_DEPTH_STENCIL_ATTACHMENT, m_DepthAttachment, 0);
             }
             else
             {
                 uint32_t& tex = m_ColorAttachments.emplace_back();
                 glCreateTextures(GL_TEXTURE_2D, 1, &tex);
-                glBindTexture(GL_TEXTURE_2D, tex);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+                glTextureParameteri(tex, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                glTextureParameteri(tex, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                glTextureParameteri(tex, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                glTextureParameteri(tex, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
                 bool isFloat = internalFormat == GL_RGB16F || internalFormat == GL_RGB32F || internalFormat == GL_RGBA16F || internalFormat == GL_RGBA32F;
                 GLenum dataType = isFloat ? GL_FLOAT : GL_UNSIGNED_BYTE; // could refine to GL_HALF_FLOAT for 16F
-                glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, m_CreateInfo.width, m_CreateInfo.height, 0, format, dataType, nullptr);
-                glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + (GLuint)(m_ColorAttachments.size() - 1), GL_TEXTURE_2D, tex, 0);
+                glTextureStorage2D(tex, 1, internalFormat, m_CreateInfo.width, m_CreateInfo.height);
+                glNamedFramebufferTexture(m_Handle, GL_COLOR_ATTACHMENT0 + (GLuint)(m_ColorAttachments.size() - 1), tex, 0);
 #if defined(GL_VERSION_4_4)
                 if (isFloat)
                 {
@@ -185,7 +184,7 @@ namespace flex
         {
             std::vector<GLenum> bufs; bufs.reserve(m_ColorAttachments.size());
             for (size_t i = 0; i < m_ColorAttachments.size(); ++i) bufs.push_back(GL_COLOR_ATTACHMENT0 + (GLenum)i);
-            glDrawBuffers((GLsizei)bufs.size(), bufs.data());
+            glNamedFramebufferDrawBuffers(m_Handle, (GLsizei)bufs.size(), bufs.data());
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,315 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#include "GeometryPool.h"
+#include "Mesh.h"
+#include "RenderState.h"
+#include "VertexBuffer.h"
+#include "VertexFormat.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+
+namespace flex
+{
+    // Attribute location and buffer binding of the optional color stream
+    static constexpr GLuint kColorLocation = 3;
+    static constexpr GLuint kColorBinding = 2;
+
+    RangeAllocator::RangeAllocator(uint32_t capacity)
+    {
+        Grow(capacity);
+    }
+
+    bool RangeAllocator::Allocate(uint32_t count, uint32_t &outOffset)
+    {
+        for (auto it = m_FreeRanges.begin(); it != m_FreeRanges.end(); ++it)
+        {
+            if (it->count < count)
+            {
+                continue;
+            }
+
+            outOffset = it->offset;
+            it->offset += count;
+            it->count -= count;
+            if (it->count == 0)
+            {
+                m_FreeRanges.erase(it);
+            }
+
+            m_Used += count;
+            return true;
+        }
+
+        return false;
+    }
+
+    void RangeAllocator::Free(uint32_t offset, uint32_t count)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        auto next = std::lower_bound(m_FreeRanges.begin(), m_FreeRanges.end(), offset,
+            [](const Range &range, uint32_t value) { return range.offset < value; });
+
+        assert((next == m_FreeRanges.end() || offset + count <= next->offset) && "Range freed twice");
+
+        auto inserted = m_FreeRanges.insert(next, { offset, count });
+
+        // Merge with the following range, then with the preceding one
+        auto following = inserted + 1;
+        if (following != m_FreeRanges.end() && inserted->offset + inserted->count == following->offset)
+        {
+            inserted->count += following->count;
+            inserted = m_FreeRanges.erase(following) - 1;
+        }
+
+        if (inserted != m_FreeRanges.begin())
+        {
+            auto preceding = inserted - 1;
+            if (preceding->offset + preceding->count == inserted->offset)
+            {
+                preceding->count += inserted->count;
+                m_FreeRanges.erase(inserted);
+            }
+        }
+
+        m_Used -= count;
+    }
+
+    void RangeAllocator::Grow(uint32_t newCapacity)
+    {
+        if (newCapacity <= m_Capacity)
+        {
+            return;
+        }
+
+        const uint32_t added = newCapacity - m_Capacity;
+        if (!m_FreeRanges.empty() && m_FreeRanges.back().offset + m_FreeRanges.back().count == m_Capacity)
+        {
+            m_FreeRanges.back().count += added;
+        }
+        else
+        {
+            m_FreeRanges.push_back({ m_Capacity, added });
+        }
+
+        m_Capacity = newCapacity;
+    }
+
+    GeometryPool::GeometryPool(uint32_t vertexCapacity, uint32_t indexCapacity)
+    {
+        glCreateVertexArrays(1, &m_VertexArray);
+        assert(m_VertexArray != 0 && "Failed to create geometry pool vertex array!");
+
+        // Binding 0 holds positions, binding 1 the PackedVertex attributes, binding 2 the optional colors.
+        // Locations match pbr.vert
+        struct AttributeFormat
+        {
+            VertexAttribute attribute;
+            GLuint binding;
+            GLuint offset;
+        };
+
+        const AttributeFormat kAttributes[] =
+        {
+            { { VertexAttribType::VECTOR_FLOAT_3, false }, 0, 0 },
+            { { VertexAttribType::VECTOR_SHORT_2, true }, 1, offsetof(PackedVertex, normal) },
+            { { VertexAttribType::VECTOR_BYTE_4, true }, 1, offsetof(PackedVertex, tangent) },
+            { { VertexAttribType::VECTOR_UBYTE_4, true }, kColorBinding, 0 },
+            { { VertexAttribType::VECTOR_HALF_2, false }, 1, offsetof(PackedVertex, uv) },
+        };
+
+        for (GLuint i = 0; i < std::size(kAttributes); ++i)
+        {
+            const VertexAttribute &attribute = kAttributes[i].attribute;
+            if (i != kColorLocation)
+            {
+                glEnableVertexArrayAttrib(m_VertexArray, i);
+            }
+            glVertexArrayAttribFormat(m_VertexArray, i, GetVertexElementCount(attribute.type), GetGLVertexElementType(attribute.type),
+                attribute.normalized ? GL_TRUE : GL_FALSE, kAttributes[i].offset);
+            glVertexArrayAttribBinding(m_VertexArray, i, kAttributes[i].binding);
+        }
+
+        // Current attribute values are context state, nothing else in the renderer sets this location
+        glVertexAttrib4f(kColorLocation, 1.0f, 1.0f, 1.0f, 1.0f);
+
+        GrowVertexBuffer(vertexCapacity);
+        GrowIndexBuffer((indexCapacity + 1) & ~1u);
+    }
+
+    GeometryPool::~GeometryPool()
+    {
+        RenderState::DeleteBuffer(m_PositionBuffer);
+        RenderState::DeleteBuffer(m_AttributeBuffer);
+        RenderState::DeleteBuffer(m_ColorBuffer);
+        RenderState::DeleteBuffer(m_IndexBuffer);
+        RenderState::DeleteVertexArray(m_VertexArray);
+    }
+
+    // Slots of the 16-bit index buffer a range of indexCount indices takes, always even
+    static uint32_t GetIndexUnits(IndexType type, uint32_t indexCount)
+    {
+        return type == IndexType::UINT16 ? (indexCount + 1) & ~1u : indexCount * 2;
+    }
+
+    GeometryAllocation GeometryPool::Allocate(const Vertex *vertices, uint32_t vertexCount, const uint32_t *indices, uint32_t indexCount)
+    {
+        GeometryAllocation allocation;
+        if (vertexCount == 0 || indexCount == 0)
+        {
+            return allocation;
+        }
+
+        if (!m_VertexRanges.Allocate(vertexCount, allocation.baseVertex))
+        {
+            GrowVertexBuffer(m_VertexRanges.GetCapacity() + vertexCount);
+            m_VertexRanges.Allocate(vertexCount, allocation.baseVertex);
+        }
+
+        allocation.indexType = GetIndexType(vertexCount);
+        const uint32_t indexUnits = GetIndexUnits(allocation.indexType, indexCount);
+        uint32_t indexOffset = 0;
+        if (!m_IndexRanges.Allocate(indexUnits, indexOffset))
+        {
+            GrowIndexBuffer(m_IndexRanges.GetCapacity() + indexUnits);
+            m_IndexRanges.Allocate(indexUnits, indexOffset);
+        }
+
+        allocation.vertexCount = vertexCount;
+        allocation.indexCount = indexCount;
+        allocation.firstIndex = allocation.indexType == IndexType::UINT16 ? indexOffset : indexOffset / 2;
+
+        // Packed here, on upload, so the import code and the mesh cache keep working on flex::Vertex
+        std::vector<glm::vec3> positions(vertexCount);
+        std::vector<PackedVertex> attributes(vertexCount);
+        std::vector<uint32_t> colors(vertexCount);
+        bool hasColors = false;
+        for (uint32_t i = 0; i < vertexCount; ++i)
+        {
+            positions[i] = vertices[i].position;
+            attributes[i] = PackVertex(vertices[i]);
+            colors[i] = PackColor(vertices[i].color);
+            hasColors |= colors[i] != kPackedWhite;
+        }
+
+        glNamedBufferSubData(m_PositionBuffer, static_cast<GLintptr>(allocation.baseVertex) * sizeof(glm::vec3), vertexCount * sizeof(glm::vec3), positions.data());
+        glNamedBufferSubData(m_AttributeBuffer, static_cast<GLintptr>(allocation.baseVertex) * sizeof(PackedVertex), vertexCount * sizeof(PackedVertex), attributes.data());
+
+        if (hasColors && !m_ColorBuffer)
+        {
+            CreateColorStream();
+        }
+        if (m_ColorBuffer)
+        {
+            // The range may have belonged to a colored mesh, white ones are cleared rather than uploaded
+            const GLintptr colorOffset = static_cast<GLintptr>(allocation.baseVertex) * sizeof(uint32_t);
+            if (hasColors)
+            {
+                glNamedBufferSubData(m_ColorBuffer, colorOffset, vertexCount * sizeof(uint32_t), colors.data());
+            }
+            else
+            {
+                glClearNamedBufferSubData(m_ColorBuffer, GL_R32UI, colorOffset, vertexCount * sizeof(uint32_t), GL_RED_INTEGER, GL_UNSIGNED_INT, &kPackedWhite);
+            }
+        }
+
+        if (allocation.indexType == IndexType::UINT16)
+        {
+            const std::vector<uint16_t> narrowIndices(indices, indices + indexCount);
+            glNamedBufferSubData(m_IndexBuffer, static_cast<GLintptr>(indexOffset) * sizeof(uint16_t), indexCount * sizeof(uint16_t), narrowIndices.data());
+        }
+        else
+        {
+            glNamedBufferSubData(m_IndexBuffer, static_cast<GLintptr>(indexOffset) * sizeof(uint16_t), indexCount * sizeof(uint32_t), indices);
+        }
+
+        return allocation;
+    }
+
+    size_t GeometryPool::GetGeometryBytes(uint32_t vertexCount, uint32_t indexCount)
+    {
+        return size_t(vertexCount) * (sizeof(glm::vec3) + sizeof(PackedVertex)) + size_t(indexCount) * GetIndexTypeSize(GetIndexType(vertexCount));
+    }
+
+    void GeometryPool::Free(const GeometryAllocation &allocation)
+    {
+        if (!allocation.IsValid())
+        {
+            return;
+        }
+
+        m_VertexRanges.Free(allocation.baseVertex, allocation.vertexCount);
+        const uint32_t indexOffset = allocation.indexType == IndexType::UINT16 ? allocation.firstIndex : allocation.firstIndex * 2;
+        m_IndexRanges.Free(indexOffset, GetIndexUnits(allocation.indexType, allocation.indexCount));
+    }
+
+    void GeometryPool::Bind()
+    {
+        RenderState::BindVertexArray(m_VertexArray);
+    }
+
+    static uint32_t ReallocateBuffer(uint32_t oldBuffer, size_t oldSize, size_t newSize)
+    {
+        uint32_t buffer = 0;
+        glCreateBuffers(1, &buffer);
+        glNamedBufferStorage(buffer, newSize, nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+        if (oldBuffer)
+        {
+            if (oldSize > 0)
+            {
+                glCopyNamedBufferSubData(oldBuffer, buffer, 0, 0, oldSize);
+            }
+            RenderState::DeleteBuffer(oldBuffer);
+        }
+
+        return buffer;
+    }
+
+    void GeometryPool::GrowVertexBuffer(uint32_t minCapacity)
+    {
+        const uint32_t oldCapacity = m_VertexRanges.GetCapacity();
+        const uint32_t newCapacity = std::max(minCapacity, oldCapacity * 2);
+
+        m_PositionBuffer = ReallocateBuffer(m_PositionBuffer, size_t(oldCapacity) * sizeof(glm::vec3), size_t(newCapacity) * sizeof(glm::vec3));
+        m_AttributeBuffer = ReallocateBuffer(m_AttributeBuffer, size_t(oldCapacity) * sizeof(PackedVertex), size_t(newCapacity) * sizeof(PackedVertex));
+        glVertexArrayVertexBuffer(m_VertexArray, 0, m_PositionBuffer, 0, sizeof(glm::vec3));
+        glVertexArrayVertexBuffer(m_VertexArray, 1, m_AttributeBuffer, 0, sizeof(PackedVertex));
+        if (m_ColorBuffer)
+        {
+            // The new tail is written by Allocate before any draw reads it
+            m_ColorBuffer = ReallocateBuffer(m_ColorBuffer, size_t(oldCapacity) * sizeof(uint32_t), size_t(newCapacity) * sizeof(uint32_t));
+            glVertexArrayVertexBuffer(m_VertexArray, kColorBinding, m_ColorBuffer, 0, sizeof(uint32_t));
+        }
+        m_VertexRanges.Grow(newCapacity);
+    }
+
+    void GeometryPool::CreateColorStream()
+    {
+        // Meshes uploaded before this one are white
+        const size_t size = size_t(m_VertexRanges.GetCapacity()) * sizeof(uint32_t);
+        m_ColorBuffer = ReallocateBuffer(0, 0, size);
+        glClearNamedBufferSubData(m_ColorBuffer, GL_R32UI, 0, size, GL_RED_INTEGER, GL_UNSIGNED_INT, &kPackedWhite);
+
+        glVertexArrayVertexBuffer(m_VertexArray, kColorBinding, m_ColorBuffer, 0, sizeof(uint32_t));
+        glEnableVertexArrayAttrib(m_VertexArray, kColorLocation);
+    }
+
+    void GeometryPool::GrowIndexBuffer(uint32_t minCapacity)
+    {
+        const uint32_t oldCapacity = m_IndexRanges.GetCapacity();
+        const uint32_t newCapacity = std::max(minCapacity, oldCapacity * 2);
+
+        m_IndexBuffer = ReallocateBuffer(m_IndexBuffer, size_t(oldCapacity) * sizeof(uint16_t), size_t(newCapacity) * sizeof(uint16_t));
+        glVertexArrayElementBuffer(m_VertexArray, m_IndexBuffer);
+        m_IndexRanges.Grow(newCapacity);
+    }
+}
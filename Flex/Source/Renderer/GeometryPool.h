@@ -0,0 +1,109 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#ifndef GEOMETRY_POOL_H
+#define GEOMETRY_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "RendererCommon.h"
+
+namespace flex
+{
+    struct Vertex;
+
+    // First fit allocator over [0, capacity) in element units, adjacent free ranges are merged
+    class RangeAllocator
+    {
+    public:
+        explicit RangeAllocator(uint32_t capacity = 0);
+
+        bool Allocate(uint32_t count, uint32_t &outOffset);
+        void Free(uint32_t offset, uint32_t count);
+        void Grow(uint32_t newCapacity);
+
+        uint32_t GetCapacity() const { return m_Capacity; }
+        uint32_t GetUsed() const { return m_Used; }
+        size_t GetFreeRangeCount() const { return m_FreeRanges.size(); }
+
+    private:
+        struct Range
+        {
+            uint32_t offset;
+            uint32_t count;
+        };
+
+        std::vector<Range> m_FreeRanges; // Sorted by offset
+        uint32_t m_Capacity = 0;
+        uint32_t m_Used = 0;
+    };
+
+    // Location of a mesh inside the pool, used as baseVertex / firstIndex of its draws.
+    // firstIndex counts indices of indexType, as the draw calls expect
+    struct GeometryAllocation
+    {
+        uint32_t baseVertex = 0;
+        uint32_t vertexCount = 0;
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        IndexType indexType = IndexType::UINT32;
+
+        bool IsValid() const { return indexCount > 0; }
+    };
+
+    // Matches the std430 layout consumed by glMultiDrawElementsIndirect
+    struct DrawElementsIndirectCommand
+    {
+        uint32_t count;
+        uint32_t instanceCount;
+        uint32_t firstIndex;
+        int32_t baseVertex;
+        uint32_t baseInstance;
+    };
+
+    // Shared vertex and index buffers for every static mesh, behind a single vertex array.
+    // Vertices are split into a position stream and a PackedVertex stream sharing the same ranges, plus an RGBA8
+    // color stream created with the first mesh that has non white vertex colors. Until then the color
+    // attribute is disabled and reads its constant white value.
+    // Meshes with at most 65536 vertices store 16-bit indices. Both widths share one index buffer
+    // managed in 16-bit units, every range has an even size so 32-bit ranges stay 4 byte aligned.
+    // Buffers grow by doubling, existing allocations keep their offsets.
+    class GeometryPool
+    {
+    public:
+        // indexCapacity in 16-bit indices
+        GeometryPool(uint32_t vertexCapacity, uint32_t indexCapacity);
+        ~GeometryPool();
+
+        GeometryAllocation Allocate(const Vertex *vertices, uint32_t vertexCount, const uint32_t *indices, uint32_t indexCount);
+        void Free(const GeometryAllocation &allocation);
+
+        void Bind();
+
+        static IndexType GetIndexType(uint32_t vertexCount) { return vertexCount <= 65536 ? IndexType::UINT16 : IndexType::UINT32; }
+        // Pool memory a mesh of these counts occupies, without the optional color stream
+        static size_t GetGeometryBytes(uint32_t vertexCount, uint32_t indexCount);
+
+        uint32_t GetVertexArray() const { return m_VertexArray; }
+        bool HasColorStream() const { return m_ColorBuffer != 0; }
+        const RangeAllocator &GetVertexRanges() const { return m_VertexRanges; }
+        const RangeAllocator &GetIndexRanges() const { return m_IndexRanges; }
+
+    private:
+        void GrowVertexBuffer(uint32_t minCapacity);
+        void GrowIndexBuffer(uint32_t minCapacity);
+        void CreateColorStream();
+
+        uint32_t m_VertexArray = 0;
+        uint32_t m_PositionBuffer = 0;
+        uint32_t m_AttributeBuffer = 0;
+        uint32_t m_ColorBuffer = 0;
+        uint32_t m_IndexBuffer = 0;
+
+        RangeAllocator m_VertexRanges;
+        RangeAllocator m_IndexRanges;
+    };
+}
+
+#endif
@@ -1,21 +1,22 @@
 // Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
 
 #include "IndexBuffer.h"
+#include "RenderState.h"
 #include <glad/glad.h>
 
 namespace flex
 {
-    IndexBuffer::IndexBuffer(const void *data, uint32_t count)
-        : m_Count(count)
+    IndexBuffer::IndexBuffer(const void *data, uint32_t count, IndexType type)
+        : m_Count(count), m_Type(type)
     {
+        // Named, binding GL_ELEMENT_ARRAY_BUFFER here would change whichever vertex array is bound
         glCreateBuffers(1, &m_Handle);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_Handle);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint32_t), data, GL_STATIC_DRAW);
+        glNamedBufferData(m_Handle, count * GetIndexTypeSize(type), data, GL_STATIC_DRAW);
     }
 
     IndexBuffer::~IndexBuffer()
     {
-        glDeleteBuffers(1, &m_Handle);
+        RenderState::DeleteBuffer(m_Handle);
     }
 
     void IndexBuffer::Bind()
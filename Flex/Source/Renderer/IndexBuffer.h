@@ -5,20 +5,25 @@
 
 #include <cstdint>
 
+#include "RendererCommon.h"
+
 namespace flex
 {
     class IndexBuffer
     {
     public:
-        IndexBuffer(const void *data, uint32_t count);
+        // data holds count indices of the given type
+        IndexBuffer(const void *data, uint32_t count, IndexType type = IndexType::UINT32);
 
         ~IndexBuffer();
 
         void Bind();
         uint32_t GetCount() const { return m_Count; }
         uint32_t GetHandle() const { return m_Handle; }
+        IndexType GetType() const { return m_Type; }
     private:
         uint32_t m_Count = 0;
+        IndexType m_Type = IndexType::UINT32;
         uint32_t m_Handle = 0;
     };
 }
@@ -3,12 +3,17 @@
 #include "Material.h"
 
 #include "Renderer.h"
-#include "UniformBuffer.h"
-#include "Shader.h"
+#include "MaterialTable.h"
+#include "TextureTable.h"
+
+#include <atomic>
 
 namespace flex
 {
+    static std::atomic<uint32_t> s_NextMaterialId = 1;
+
     Material::Material()
+        : id(s_NextMaterialId++)
     {
         // Neutral defaults per glTF PBR spec when a texture is absent
         baseColorTexture = Renderer::GetWhiteTexture();           // baseColorFactor will tint
@@ -17,17 +22,78 @@ namespace flex
         normalTexture = Renderer::GetWhiteTexture();              // flat normal
         occlusionTexture = Renderer::GetWhiteTexture();           // full occlusion (no darkening)
 
-        shader = Renderer::CreateShaderFromFile(
-            {
-                ShaderData{"resources/shaders/pbr.vert.glsl", GL_VERTEX_SHADER, 0},
-                ShaderData{"resources/shaders/pbr.frag.glsl", GL_FRAGMENT_SHADER, 0}
-            }, "MaterialPBR");
+        m_Slot = Renderer::GetMaterialTable()->AllocateSlot();
+    }
 
-        m_Buffer = UniformBuffer::Create(sizeof(Material::Params), UNIFORM_BINDING_LOC_MATERIAL);
+    Material::~Material()
+    {
+        if (MaterialTable *table = Renderer::GetMaterialTable())
+        {
+            table->FreeSlot(m_Slot);
+        }
     }
 
     void Material::UpdateData()
     {
-        m_Buffer->SetData(&params, sizeof(Material::Params));
+        const std::array<uint32_t, MATERIAL_TEXTURE_COUNT> handles = GetTextureHandles();
+        if (!m_Dirty && handles == m_TextureHandles)
+        {
+            return;
+        }
+        m_TextureHandles = handles;
+
+        TextureTable *textures = Renderer::GetTextureTable();
+
+        // Each slot's fallback stands for the constant its shader variant uses without sampling
+        const Ref<Texture2D> white = Renderer::GetWhiteTexture();
+        const Ref<Texture2D> black = Renderer::GetBlackTexture();
+        const Ref<Texture2D> flatNormal = Renderer::GetFlatNormalTexture();
+
+        // Textures still loading are drawn as their fallback, the material stays dirty until they arrive
+        bool pending = false;
+        const auto resolve = [&pending](const Ref<Texture2D> &texture, const Ref<Texture2D> &fallback)
+        {
+            if (texture && !texture->IsReady())
+            {
+                pending = true;
+                return fallback;
+            }
+            return texture;
+        };
+        const Ref<Texture2D> baseColor = resolve(baseColorTexture, white);
+        const Ref<Texture2D> emissive = resolve(emissiveTexture, white);
+        const Ref<Texture2D> metallicRoughness = resolve(metallicRoughnessTexture, black);
+        const Ref<Texture2D> normal = resolve(normalTexture, white);
+        const Ref<Texture2D> occlusion = resolve(occlusionTexture, white);
+
+        MaterialRecord record = {};
+        record.params = params;
+        // White leaves the factors as they are, the flat normal leaves the surface normal
+        record.textures[MATERIAL_TEXTURE_BASE_COLOR] = textures->Acquire(baseColor, white);
+        record.textures[MATERIAL_TEXTURE_EMISSIVE] = textures->Acquire(emissive, white);
+        record.textures[MATERIAL_TEXTURE_METALLIC_ROUGHNESS] = textures->Acquire(metallicRoughness, white);
+        record.textures[MATERIAL_TEXTURE_NORMAL] = textures->Acquire(normal, flatNormal);
+        record.textures[MATERIAL_TEXTURE_OCCLUSION] = textures->Acquire(occlusion, white);
+
+        const auto isMap = [](const Ref<Texture2D> &texture, const Ref<Texture2D> &fallback)
+        {
+            return texture && texture != fallback;
+        };
+
+        m_Features = 0;
+        m_Features |= isMap(baseColor, white) ? PBR_FEATURE_BASE_COLOR_MAP : 0u;
+        m_Features |= isMap(emissive, white) ? PBR_FEATURE_EMISSIVE_MAP : 0u;
+        m_Features |= isMap(metallicRoughness, black) ? PBR_FEATURE_METALLIC_ROUGHNESS_MAP : 0u;
+        m_Features |= isMap(normal, white) && isMap(normal, flatNormal) ? PBR_FEATURE_NORMAL_MAP : 0u;
+        m_Features |= isMap(occlusion, white) ? PBR_FEATURE_OCCLUSION_MAP : 0u;
+
+        Renderer::GetMaterialTable()->Set(m_Slot, record);
+        m_Dirty = pending;
+    }
+
+    std::array<uint32_t, MATERIAL_TEXTURE_COUNT> Material::GetTextureHandles() const
+    {
+        const auto handle = [](const Ref<Texture2D> &texture) { return texture ? texture->GetHandle() : 0u; };
+        return { handle(baseColorTexture), handle(emissiveTexture), handle(metallicRoughnessTexture), handle(normalTexture), handle(occlusionTexture) };
     }
-}
\ No newline at end of file
+}
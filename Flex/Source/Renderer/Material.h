@@ -7,19 +7,48 @@
 #include "Renderer.h"
 #include <glm/glm.hpp>
 
+#include <array>
+
 namespace flex
 {
-    class UniformBuffer;
-
     enum class MaterialType
     {
         Opaque,
         Transparent,
     };
 
+    // Order of the material texture references, same as MATERIAL_TEXTURE_* in pbr.frag
+    enum MaterialTexture : uint32_t
+    {
+        MATERIAL_TEXTURE_BASE_COLOR = 0,
+        MATERIAL_TEXTURE_EMISSIVE,
+        MATERIAL_TEXTURE_METALLIC_ROUGHNESS,
+        MATERIAL_TEXTURE_NORMAL,
+        MATERIAL_TEXTURE_OCCLUSION,
+        MATERIAL_TEXTURE_COUNT
+    };
+
+    // Variant bits of the PBR shader, HAS_*_MAP and DEBUG_SHADOW_* in pbr.frag. The map bits follow
+    // MaterialTexture and come from Material::GetFeatures, the debug bits are picked per frame
+    enum PBRFeature : uint32_t
+    {
+        PBR_FEATURE_BASE_COLOR_MAP = 1u << MATERIAL_TEXTURE_BASE_COLOR,
+        PBR_FEATURE_EMISSIVE_MAP = 1u << MATERIAL_TEXTURE_EMISSIVE,
+        PBR_FEATURE_METALLIC_ROUGHNESS_MAP = 1u << MATERIAL_TEXTURE_METALLIC_ROUGHNESS,
+        PBR_FEATURE_NORMAL_MAP = 1u << MATERIAL_TEXTURE_NORMAL,
+        PBR_FEATURE_OCCLUSION_MAP = 1u << MATERIAL_TEXTURE_OCCLUSION,
+        PBR_FEATURE_DEBUG_SHADOW_CASCADES = 1u << MATERIAL_TEXTURE_COUNT,
+        PBR_FEATURE_DEBUG_SHADOW_VISIBILITY = 2u << MATERIAL_TEXTURE_COUNT,
+    };
+
     struct Material
     {
         Material();
+        ~Material();
+
+        // Owns its material table slot
+        Material(const Material &) = delete;
+        Material &operator=(const Material &) = delete;
 
         std::string name;
 
@@ -30,21 +59,38 @@ namespace flex
             float metallicFactor = 1.0f;
             float roughnessFactor = 1.0f;
             float occlusionStrength = 0.0f;
-        } params;
+            float padding = 0.0f; // std430 array stride
+        } params; // Call MarkDirty after editing
 
         Ref<Texture2D> baseColorTexture;
         Ref<Texture2D> emissiveTexture;
         Ref<Texture2D> metallicRoughnessTexture;
         Ref<Texture2D> normalTexture;
-        Ref<Texture2D> occlusionTexture;
-
-        Ref<Shader> shader;
+        Ref<Texture2D> occlusionTexture; // Call MarkDirty after swapping a texture
 
         MaterialType type = MaterialType::Opaque;
 
+        // Process unique, packed into render queue sort keys
+        uint32_t id = 0;
+
+        void MarkDirty() { m_Dirty = true; }
+        // Copies params and texture references into the material table when marked dirty
+        // or when one of its textures got new storage (TextureStreamer)
         void UpdateData();
+
+        // Index into u_Materials.params, stable for the material's lifetime
+        uint32_t GetSlot() const { return m_Slot; }
+        // PBRFeature map bits of the textures that aren't one of the renderer's fallbacks, updated by UpdateData
+        uint32_t GetFeatures() const { return m_Features; }
+
     private:
-        Ref<UniformBuffer> m_Buffer;
+        // GL handles of the textures at the last update, in MaterialTexture order
+        std::array<uint32_t, MATERIAL_TEXTURE_COUNT> GetTextureHandles() const;
+
+        std::array<uint32_t, MATERIAL_TEXTURE_COUNT> m_TextureHandles = {};
+        uint32_t m_Slot = 0;
+        uint32_t m_Features = 0;
+        bool m_Dirty = true;
     };
 }
 
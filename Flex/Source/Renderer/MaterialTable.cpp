@@ -0,0 +1,72 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#include "MaterialTable.h"
+#include "StorageBuffer.h"
+#include "TextureTable.h"
+#include "RendererCommon.h"
+#include "Renderer.h"
+
+#include <algorithm>
+
+namespace flex
+{
+    MaterialTable::MaterialTable(uint32_t initialCapacity)
+    {
+        m_Records.reserve(initialCapacity);
+        m_Buffer = StorageBuffer::Create(initialCapacity * sizeof(MaterialRecord), STORAGE_BINDING_LOC_MATERIALS);
+    }
+
+    MaterialTable::~MaterialTable()
+    {
+    }
+
+    uint32_t MaterialTable::AllocateSlot()
+    {
+        if (!m_FreeSlots.empty())
+        {
+            const uint32_t slot = m_FreeSlots.back();
+            m_FreeSlots.pop_back();
+            return slot;
+        }
+
+        m_Records.emplace_back();
+        return static_cast<uint32_t>(m_Records.size() - 1);
+    }
+
+    void MaterialTable::FreeSlot(uint32_t slot)
+    {
+        m_FreeSlots.push_back(slot);
+    }
+
+    void MaterialTable::Set(uint32_t slot, const MaterialRecord &record)
+    {
+        m_Records[slot] = record;
+        m_DirtyBegin = std::min(m_DirtyBegin, slot);
+        m_DirtyEnd = std::max(m_DirtyEnd, slot + 1);
+    }
+
+    void MaterialTable::Flush()
+    {
+        m_LastFlushSlots = 0;
+
+        const size_t tableBytes = m_Records.size() * sizeof(MaterialRecord);
+        if (tableBytes > m_Buffer->GetSize())
+        {
+            // Growing reallocates the buffer, so the whole table goes up again
+            m_Buffer->SetData(m_Records.data(), tableBytes);
+            m_LastFlushSlots = static_cast<uint32_t>(m_Records.size());
+        }
+        else if (m_DirtyBegin < m_DirtyEnd)
+        {
+            const size_t offset = m_DirtyBegin * sizeof(MaterialRecord);
+            m_Buffer->SetData(&m_Records[m_DirtyBegin], (m_DirtyEnd - m_DirtyBegin) * sizeof(MaterialRecord), offset);
+            m_LastFlushSlots = m_DirtyEnd - m_DirtyBegin;
+        }
+
+        m_DirtyBegin = UINT32_MAX;
+        m_DirtyEnd = 0;
+
+        m_Buffer->Bind();
+        Renderer::GetTextureTable()->Bind();
+    }
+}
@@ -0,0 +1,57 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#ifndef MATERIAL_TABLE_H
+#define MATERIAL_TABLE_H
+
+#include "Core/Types.h"
+#include "Material.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace flex
+{
+    class StorageBuffer;
+
+    // Matches MaterialParams in pbr.frag (std430)
+    struct MaterialRecord
+    {
+        Material::Params params;
+        uint64_t textures[MATERIAL_TEXTURE_COUNT]; // TextureTable::Acquire references, MaterialTexture order
+        uint32_t padding[2];
+    };
+
+    static_assert(sizeof(MaterialRecord) == 96, "MaterialRecord must match the std430 array stride");
+
+    // Every MaterialRecord in one shader storage buffer (STORAGE_BINDING_LOC_MATERIALS).
+    // Materials own a stable slot for their lifetime, shaders read u_Materials.params[slot].
+    // Only slots written since the last Flush are uploaded.
+    class MaterialTable
+    {
+    public:
+        MaterialTable(uint32_t initialCapacity = 256);
+        ~MaterialTable();
+
+        uint32_t AllocateSlot();
+        void FreeSlot(uint32_t slot);
+
+        void Set(uint32_t slot, const MaterialRecord &record);
+
+        // Uploads the dirty slot range, binds the buffer and the material textures
+        void Flush();
+
+        uint32_t GetSlotCount() const { return static_cast<uint32_t>(m_Records.size()); }
+        uint32_t GetLastFlushSlots() const { return m_LastFlushSlots; }
+
+    private:
+        std::vector<MaterialRecord> m_Records;
+        std::vector<uint32_t> m_FreeSlots;
+        Ref<StorageBuffer> m_Buffer;
+
+        uint32_t m_DirtyBegin = UINT32_MAX;
+        uint32_t m_DirtyEnd = 0;
+        uint32_t m_LastFlushSlots = 0;
+    };
+}
+
+#endif
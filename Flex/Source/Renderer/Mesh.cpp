@@ -2,9 +2,14 @@
 
 #include "Mesh.h"
 #include "Material.h"
+#include "MeshOptimizer.h"
+#include "Core/ThreadPool.h"
 #include <iostream>
 #include <filesystem>
 #include <cassert>
+#include <algorithm>
+#include <cmath>
+#include <atomic>
 
 #ifndef GLM_ENABLE_EXPERIMENTAL
     #define GLM_ENABLE_EXPERIMENTAL
@@ -15,33 +20,75 @@
 
 namespace flex
 {
-    // Definition of the static mesh cache
-    std::unordered_map<MeshKey, Ref<Mesh>, MeshKeyHasher, MeshKeyEqual> MeshLoader::m_MeshCache;
+    MeshCache MeshLoader::m_MeshCache;
+    TextureCache MeshLoader::m_TextureCache;
 
-    Mesh::Mesh(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices)
+    static std::atomic<uint32_t> s_NextMeshId = 1;
+
+    Mesh::Mesh()
+        : id(s_NextMeshId++)
+    {
+    }
+
+    Mesh::Mesh(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices, const AABB &bounds)
+        : bounds(bounds), id(s_NextMeshId++)
     {
-        this->vertexArray = CreateRef<VertexArray>();
-        this->vertexBuffer = CreateRef<VertexBuffer>(vertices.data(), vertices.size() * sizeof(Vertex));
-        this->indexBuffer = CreateRef<IndexBuffer>(indices.data(), static_cast<uint32_t>(indices.size()));
+        if (!this->bounds.IsValid())
+        {
+            for (const Vertex &vertex : vertices)
+            {
+                this->bounds.Expand(vertex.position);
+            }
+        }
 
-        vertexBuffer->SetAttributes(
+        // Sphere around the box center, tighter than the box's circumscribed sphere
+        if (this->bounds.IsValid())
+        {
+            boundingSphere.center = this->bounds.GetCenter();
+            float maxDistanceSq = 0.0f;
+            for (const Vertex &vertex : vertices)
             {
-                {VertexAttribType::VECTOR_FLOAT_3, false}, // position
-                {VertexAttribType::VECTOR_FLOAT_3, false}, // normal
-                {VertexAttribType::VECTOR_FLOAT_3, false}, // tangent
-                {VertexAttribType::VECTOR_FLOAT_3, false}, // bitangent
-                {VertexAttribType::VECTOR_FLOAT_3, false}, // color
-                {VertexAttribType::VECTOR_FLOAT_2, false}, // uv
-            },
-            sizeof(Vertex)
-        );
-        vertexArray->SetVertexBuffer(vertexBuffer);
-        vertexArray->SetIndexBuffer(indexBuffer);
+                const glm::vec3 offset = vertex.position - boundingSphere.center;
+                maxDistanceSq = std::max(maxDistanceSq, glm::dot(offset, offset));
+            }
+            boundingSphere.radius = std::sqrt(maxDistanceSq);
+        }
+
+        float surfaceArea = 0.0f;
+        float uvArea = 0.0f;
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            const Vertex &v0 = vertices[indices[i + 0]];
+            const Vertex &v1 = vertices[indices[i + 1]];
+            const Vertex &v2 = vertices[indices[i + 2]];
+            surfaceArea += glm::length(glm::cross(v1.position - v0.position, v2.position - v0.position));
+
+            const glm::vec2 e1 = v1.uv - v0.uv;
+            const glm::vec2 e2 = v2.uv - v0.uv;
+            uvArea += std::abs(e1.x * e2.y - e1.y * e2.x);
+        }
+        if (surfaceArea > 0.0f)
+        {
+            uvDensity = std::sqrt(uvArea / surfaceArea);
+        }
+
+        if (GeometryPool *pool = Renderer::GetGeometryPool())
+        {
+            geometry = pool->Allocate(vertices.data(), static_cast<uint32_t>(vertices.size()), indices.data(), static_cast<uint32_t>(indices.size()));
+        }
     }
 
-    Ref<Mesh> Mesh::Create(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices)
+    Mesh::~Mesh()
     {
-        return CreateRef<Mesh>(vertices, indices);
+        if (GeometryPool *pool = Renderer::GetGeometryPool())
+        {
+            pool->Free(geometry);
+        }
+    }
+
+    Ref<Mesh> Mesh::Create(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices, const AABB &bounds)
+    {
+        return CreateRef<Mesh>(vertices, indices, bounds);
     }
 
     MeshInstance::MeshInstance(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices)
@@ -96,6 +143,9 @@ namespace flex
         tinygltf::TinyGLTF loader;
         std::string err, warn;
 
+        // Images stay encoded, the TextureLoader decodes them on worker threads
+        loader.SetImagesAsIs(true);
+
         bool ok = false;
         if (filename.ends_with(".glb"))
             ok = loader.LoadBinaryFromFile(&gltfModel, &err, &warn, filename);
@@ -135,7 +185,18 @@ namespace flex
             }
         } 
 
-        // Load meshes referenced by nodes
+        // Decode every primitive referenced by a node first, the optimizer then runs on them in parallel
+        struct PrimitiveData
+        {
+            size_t node;
+            const tinygltf::Primitive *primitive;
+            std::vector<Vertex> vertices;
+            std::vector<uint32_t> indices;
+            AABB bounds;
+            MeshOptimizeStats stats;
+        };
+        std::vector<PrimitiveData> primitives;
+
         for (size_t i = 0; i < gltfModel.nodes.size(); ++i)
         {
             const tinygltf::Node &n = gltfModel.nodes[i];
@@ -149,41 +210,48 @@ namespace flex
 
             for (const auto &primitive : gltfMesh.primitives)
             {
-                std::vector<Vertex> vertices;
-                std::vector<uint32_t> indices;
+                PrimitiveData &data = primitives.emplace_back();
+                data.node = i;
+                data.primitive = &primitive;
 
                 // Get vertices
-                LoadVertexData(vertices, primitive, gltfModel);
+                LoadVertexData(data.vertices, data.bounds, primitive, gltfModel);
 
                 // Get indices
-                LoadIndicesData(indices, primitive, gltfModel);
+                LoadIndicesData(data.indices, primitive, gltfModel);
+            }
+        }
 
-                // Try to reuse an existing mesh from the cache using the vertex/index counts as key
-                MeshKey key{ static_cast<uint32_t>(vertices.size()), static_cast<uint32_t>(indices.size()) };
-                Ref<Mesh> mesh;
-                auto it = m_MeshCache.find(key);
-                if (it != m_MeshCache.end())
-                {
-                    mesh = it->second;
-                }
-                else
-                {
-                    mesh = Mesh::Create(vertices, indices);
-                    m_MeshCache.emplace(key, mesh);
-                }
+        ThreadPool::ParallelFor(primitives.size(), 1, [&primitives](size_t begin, size_t end)
+        {
+            for (size_t p = begin; p < end; ++p)
+            {
+                primitives[p].stats = MeshOptimizer::Optimize(primitives[p].vertices, primitives[p].indices);
+            }
+        });
+
+        for (PrimitiveData &data : primitives)
+        {
+            if (data.stats.acmrBefore > 0.0f)
+            {
+                std::cout << "  Optimized " << data.indices.size() / 3 << " triangles: ACMR " << data.stats.acmrBefore << " -> " << data.stats.acmrAfter
+                    << ", ATVR " << data.stats.atvrBefore << " -> " << data.stats.atvrAfter << "\n";
+            }
+
+            // Identical geometry, within this file or across files, shares one mesh
+            Ref<Mesh> mesh = m_MeshCache.FindOrCreate(data.vertices, data.indices, data.bounds);
 
-                // Create Mesh Instance
-                Ref<MeshInstance> meshInstance = CreateRef<MeshInstance>();
-                meshInstance->mesh = mesh;
-                meshInstance->material = CreateRef<Material>();
-                meshInstance->meshIndex = static_cast<int>(scene.flatMeshes.size());
+            // Create Mesh Instance
+            Ref<MeshInstance> meshInstance = CreateRef<MeshInstance>();
+            meshInstance->mesh = mesh;
+            meshInstance->material = CreateRef<Material>();
+            meshInstance->meshIndex = static_cast<int>(scene.flatMeshes.size());
 
-                // Material
-                LoadMaterial(meshInstance, primitive, gltfModel.materials, textures);
+            // Material
+            LoadMaterial(meshInstance, *data.primitive, gltfModel.materials, textures);
 
-                scene.nodes[i].meshInstances.push_back(meshInstance);
-                scene.flatMeshes.push_back(meshInstance);
-            }
+            scene.nodes[data.node].meshInstances.push_back(meshInstance);
+            scene.flatMeshes.push_back(meshInstance);
         }
 
         // Compute world transforms via DFS
@@ -204,12 +272,23 @@ namespace flex
         for (const int root : scene.roots)
             recurse(root, glm::mat4(1.0f));
 
+        m_MeshCache.CollectExpired();
+        const MeshCacheStats &stats = m_MeshCache.GetStats();
+        std::cout << "Mesh dedup: " << stats.requested << " primitives, " << stats.created << " unique ("
+            << stats.GetDedupRatio() << "x), " << stats.bytesSaved / 1024 << " KB saved\n";
+
+        m_TextureCache.CollectExpired();
+        const TextureCacheStats textureStats = m_TextureCache.GetStats();
+        std::cout << "Texture cache: " << textureStats.requested << " requested, " << textureStats.created << " uploaded ("
+            << textureStats.GetHitRate() * 100.0f << "% hits), " << textureStats.bytesSaved / 1024 << " KB VRAM saved\n";
+
         return scene;
     }
 
     void MeshLoader::ClearCache()
     {
-        m_MeshCache.clear();
+        m_MeshCache.Clear();
+        m_TextureCache.Clear();
     }
 
     Ref<MeshInstance> MeshLoader::CreateFallbackQuad()
@@ -240,6 +319,16 @@ namespace flex
     {
         std::vector<Ref<Texture2D>> gltfTextures;
         std::cout << "Loading " << model.textures.size() << " textures from glTF\n";
+
+        // Normal maps keep two channels in BC5, everything else goes to BC7
+        std::vector<bool> normalMaps(model.textures.size(), false);
+        for (const tinygltf::Material &material : model.materials)
+        {
+            if (material.normalTexture.index >= 0 && material.normalTexture.index < static_cast<int>(normalMaps.size()))
+            {
+                normalMaps[material.normalTexture.index] = true;
+            }
+        }
         
         for (size_t i = 0; i < model.textures.size(); ++i)
         {
@@ -255,30 +344,31 @@ namespace flex
                 TextureCreateInfo createInfo;
                 createInfo.width = image.width;
                 createInfo.height = image.height;
-                createInfo.flip = true;
+                createInfo.flip = false; // glTF UVs start at the top left, the first row already is v = 0
                 createInfo.clampMode = WrapMode::REPEAT;
-                createInfo.filter = FilterMode::LINEAR;
-                createInfo.format = Format::RGBA8;
+                createInfo.filter = FilterMode::LINEAR_MIPMAP_LINEAR;
+                createInfo.format = normalMaps[i] ? Format::BC5 : Format::BC7;
+                createInfo.anisotropy = 8.0f; // Keeps grazing angle floors sharp with the trilinear mips
 
                 Ref<Texture2D> texture;
+
+                // Image referenced by URI (external file), data URIs count as embedded
+                const bool external = !image.uri.empty() && image.uri.rfind("data:", 0) != 0;
+                const std::string texturePath = external ? "Resources/models/" + image.uri : std::string();
                 
                 if (!image.image.empty())
                 {
-                    // Image data is embedded in the glTF
-                    texture = CreateRef<Texture2D>(createInfo, (void*)image.image.data(), image.image.size());
-                    std::cout << "    Loaded embedded texture\n";
+                    // Encoded file bytes read by tinygltf, shared with other models by path or by content
+                    texture = m_TextureCache.FindOrDecode(image.image.data(), image.image.size(), createInfo, texturePath);
+                    std::cout << "    Queued " << (external ? "external" : "embedded") << " texture\n";
                 }
-                else if (!image.uri.empty())
+                else if (external)
                 {
-
-                    // Image is referenced by URI (external file)
-                    std::string texturePath = "Resources/models/" + image.uri;
-                    
                     // Check if file exists
                     if (std::filesystem::exists(texturePath))
                     {
-                        texture = CreateRef<Texture2D>(createInfo, texturePath);
-                        std::cout << "    Loaded external texture: " << texturePath << "\n";
+                        texture = m_TextureCache.FindOrLoad(texturePath, createInfo);
+                        std::cout << "    Queued external texture: " << texturePath << "\n";
                     }
                 }
                 
@@ -417,7 +507,7 @@ namespace flex
         }
     }
 
-    void MeshLoader::LoadVertexData(std::vector<Vertex> &vertices, const tinygltf::Primitive &primitive, const tinygltf::Model &model)
+    void MeshLoader::LoadVertexData(std::vector<Vertex> &vertices, AABB &bounds, const tinygltf::Primitive &primitive, const tinygltf::Model &model)
     {
         // Get vertex positions
         glm::vec3* positions = nullptr;
@@ -464,6 +554,7 @@ namespace flex
         {
             Vertex vertex{};
             vertex.position = positions[i];
+            bounds.Expand(vertex.position);
             vertex.color = glm::vec3(1.0f, 1.0f, 1.0f);
 
             if (normals)
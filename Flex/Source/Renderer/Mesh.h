@@ -11,11 +11,12 @@
 #include <tinygltf.h>
 
 #include "Core/Types.h"
+#include "Math/Bounds.hpp"
 
-#include "VertexArray.h"
-#include "VertexBuffer.h"
-#include "IndexBuffer.h"
+#include "GeometryPool.h"
 #include "Texture.h"
+#include "MeshCache.h"
+#include "TextureCache.h"
 
 #include "Renderer.h"
 
@@ -26,6 +27,7 @@ namespace flex
 {
     struct Material;
 
+    // Import side vertex, the GeometryPool stores it as a position plus a PackedVertex (VertexFormat.h)
     struct Vertex
     {
         glm::vec3 position;
@@ -39,12 +41,30 @@ namespace flex
     // Mesh Primitives struct
     struct Mesh
     {
-        Ref<VertexArray> vertexArray;
-        Ref<VertexBuffer> vertexBuffer;
-        Ref<IndexBuffer> indexBuffer;
-        
-        Mesh(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices);
-        static Ref<Mesh> Create(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices);
+        // Range in Renderer's geometry pool, empty for headless meshes
+        GeometryAllocation geometry;
+
+        // Local space bounds, used for culling
+        AABB bounds;
+        BoundingSphere boundingSphere;
+
+        // UV units per local unit, from the ratio of UV to surface area. 0 without UVs.
+        // Texture streaming picks mip levels from it
+        float uvDensity = 0.0f;
+
+        // Process unique, packed into render queue sort keys
+        uint32_t id = 0;
+
+        Mesh(); // No GPU resources, bounds only
+        // Bounds are computed from the vertices when not provided
+        Mesh(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices, const AABB &bounds = AABB());
+        ~Mesh();
+
+        // Owns its pool range
+        Mesh(const Mesh &) = delete;
+        Mesh &operator=(const Mesh &) = delete;
+
+        static Ref<Mesh> Create(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices, const AABB &bounds = AABB());
     };
 
     // Actual Mesh Instance contains additional mesh data
@@ -82,30 +102,6 @@ namespace flex
         std::vector<Ref<MeshInstance>> flatMeshes; // All meshes collected (for convenience)
     };
 
-    // Custom key for caching meshes. Two meshes are considered equal
-    // if they have the same vertex and index counts.
-    struct MeshKey
-    {
-        uint32_t vertexCount;
-        uint32_t indicesCount;
-    };
-
-    struct MeshKeyHasher
-    {
-        std::size_t operator()(const MeshKey& k) const noexcept
-        {
-            uint64_t key = (static_cast<uint64_t>(k.vertexCount) << 32) ^ static_cast<uint64_t>(k.indicesCount);
-            return std::hash<uint64_t>{}(key);
-        }
-    };
-
-    struct MeshKeyEqual
-    {
-        bool operator()(const MeshKey& a, const MeshKey& b) const noexcept { return a.vertexCount == b.vertexCount && a.indicesCount == b.indicesCount; }
-    };
-
-    using MeshMap = std::unordered_map<MeshKey, Ref<Mesh>, MeshKeyHasher, MeshKeyEqual>;
-
     class MeshLoader
     {
     public:
@@ -113,19 +109,22 @@ namespace flex
         static Ref<MeshInstance> CreateSkyboxCube();
 
         static void LoadMaterial(const Ref<MeshInstance>& meshInstance, const tinygltf::Primitive &primitive, const std::vector<tinygltf::Material> &materials, const std::vector<Ref<Texture2D>> &loadedTextures);
-        static void LoadVertexData(std::vector<Vertex> &vertices, const tinygltf::Primitive &primitive, const tinygltf::Model &model);
+        static void LoadVertexData(std::vector<Vertex> &vertices, AABB &bounds, const tinygltf::Primitive &primitive, const tinygltf::Model &model);
         static void LoadIndicesData(std::vector<uint32_t> &indices, const tinygltf::Primitive &primitive, const tinygltf::Model &model);
 
         // Load full scene graph retaining hierarchy & transforms
         static MeshScene LoadSceneGraphFromGLTF(const std::string &filename);
 
         static void ClearCache();
+        static const MeshCache &GetMeshCache() { return m_MeshCache; }
+        static const TextureCache &GetTextureCache() { return m_TextureCache; }
 
     private:
         static std::vector<Ref<Texture2D>> LoadTexturesFromGLTF(const tinygltf::Model& model);
         static const unsigned char* GetBufferData(const tinygltf::Model& model, const tinygltf::Accessor& accessor);
 
-        static MeshMap m_MeshCache;
+        static MeshCache m_MeshCache;
+        static TextureCache m_TextureCache;
     };
 }
 
@@ -0,0 +1,80 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#include "MeshCache.h"
+#include "Mesh.h"
+#include "GeometryPool.h"
+
+#include <algorithm>
+
+namespace flex
+{
+    Hash128 MeshCache::HashGeometry(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices, uint64_t seed)
+    {
+        // Counts first so data can't shift across the vertex / index boundary
+        const Hash128 parts[] =
+        {
+            { vertices.size(), indices.size() },
+            HashData(vertices.data(), vertices.size() * sizeof(Vertex), seed),
+            HashData(indices.data(), indices.size() * sizeof(uint32_t), seed),
+        };
+        return HashData(parts, sizeof(parts), seed);
+    }
+
+    Ref<Mesh> MeshCache::FindOrCreate(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices, const AABB &bounds)
+    {
+        return FindOrCreate(HashGeometry(vertices, indices), vertices, indices, bounds);
+    }
+
+    Ref<Mesh> MeshCache::FindOrCreate(const Hash128 &key, const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices,
+        const AABB &bounds)
+    {
+        ++m_Stats.requested;
+
+        std::vector<Entry> &bucket = m_Entries[key];
+        std::erase_if(bucket, [](const Entry &entry) { return entry.mesh.expired(); });
+
+        // Both digests have to collide at once before different data shares a mesh
+        const Hash128 check = HashGeometry(vertices, indices, kCheckSeed);
+        for (const Entry &entry : bucket)
+        {
+            if (entry.check == check)
+            {
+                if (Ref<Mesh> mesh = entry.mesh.lock())
+                {
+                    m_Stats.bytesSaved += GeometryPool::GetGeometryBytes(static_cast<uint32_t>(vertices.size()), static_cast<uint32_t>(indices.size()));
+                    return mesh;
+                }
+            }
+        }
+
+        Ref<Mesh> mesh = Mesh::Create(vertices, indices, bounds);
+        bucket.push_back({ mesh, check });
+        ++m_Stats.created;
+        return mesh;
+    }
+
+    void MeshCache::CollectExpired()
+    {
+        for (auto &[hash, bucket] : m_Entries)
+        {
+            std::erase_if(bucket, [](const Entry &entry) { return entry.mesh.expired(); });
+        }
+        std::erase_if(m_Entries, [](const auto &pair) { return pair.second.empty(); });
+    }
+
+    void MeshCache::Clear()
+    {
+        m_Entries.clear();
+        m_Stats = {};
+    }
+
+    uint32_t MeshCache::GetLiveMeshCount() const
+    {
+        uint32_t count = 0;
+        for (const auto &[hash, bucket] : m_Entries)
+        {
+            count += static_cast<uint32_t>(std::count_if(bucket.begin(), bucket.end(), [](const Entry &entry) { return !entry.mesh.expired(); }));
+        }
+        return count;
+    }
+}
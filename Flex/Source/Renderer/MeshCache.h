@@ -0,0 +1,66 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include "Core/Types.h"
+#include "Core/Hash.h"
+#include "Math/Bounds.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace flex
+{
+    struct Mesh;
+    struct Vertex;
+
+    struct MeshCacheStats
+    {
+        uint32_t requested = 0; // Primitives passed to FindOrCreate
+        uint32_t created = 0;   // Of those, uploaded as a new mesh
+        uint64_t bytesSaved = 0; // Pool bytes the reused meshes would have taken
+
+        float GetDedupRatio() const { return created ? static_cast<float>(requested) / static_cast<float>(created) : 1.0f; }
+    };
+
+    // Import time deduplication of static meshes keyed by a 128-bit hash of their vertex and index data.
+    // Entries hold weak references, a mesh is freed with its last MeshInstance and its entry is dropped lazily
+    class MeshCache
+    {
+    public:
+        static Hash128 HashGeometry(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices, uint64_t seed = 0);
+
+        // Returns a live mesh with identical data, or creates one
+        Ref<Mesh> FindOrCreate(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices, const AABB &bounds = AABB());
+        // Same with the bucket key already computed, e.g. HashGeometry on a worker thread
+        Ref<Mesh> FindOrCreate(const Hash128 &key, const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices,
+            const AABB &bounds = AABB());
+
+        void CollectExpired();
+        void Clear();
+
+        // Meshes still referenced by an instance
+        uint32_t GetLiveMeshCount() const;
+        const MeshCacheStats &GetStats() const { return m_Stats; }
+
+    private:
+        // A hit is confirmed by a second digest with an independent seed, entries that only share the key
+        // live side by side in one bucket
+        struct Entry
+        {
+            std::weak_ptr<Mesh> mesh;
+            Hash128 check;
+        };
+
+        static constexpr uint64_t kCheckSeed = 0x5bd1e9955bd1e995ull;
+
+        std::unordered_map<Hash128, std::vector<Entry>, Hash128Hasher> m_Entries;
+        MeshCacheStats m_Stats;
+    };
+}
+
+#endif
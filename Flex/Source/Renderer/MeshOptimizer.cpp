@@ -0,0 +1,298 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#include "MeshOptimizer.h"
+#include "Mesh.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace flex
+{
+    namespace
+    {
+        struct CacheMisses
+        {
+            uint32_t misses = 0;
+            uint32_t referenced = 0;
+        };
+
+        CacheMisses SimulateFifoCache(const std::vector<uint32_t> &indices, uint32_t vertexCount, uint32_t cacheSize)
+        {
+            // A vertex is still cached while fewer than cacheSize misses happened since it was loaded
+            std::vector<uint32_t> loadedAt(vertexCount, UINT32_MAX);
+            CacheMisses result;
+            for (uint32_t index : indices)
+            {
+                if (loadedAt[index] == UINT32_MAX)
+                {
+                    ++result.referenced;
+                }
+                else if (result.misses - loadedAt[index] < cacheSize)
+                {
+                    continue;
+                }
+
+                loadedAt[index] = result.misses++;
+            }
+            return result;
+        }
+
+        // Triangles of every vertex as one flat list
+        struct Adjacency
+        {
+            std::vector<uint32_t> offsets;
+            std::vector<uint32_t> triangles;
+        };
+
+        Adjacency BuildAdjacency(const std::vector<uint32_t> &indices, uint32_t vertexCount)
+        {
+            Adjacency adjacency;
+            adjacency.offsets.assign(vertexCount + 1, 0);
+            for (uint32_t index : indices)
+            {
+                ++adjacency.offsets[index + 1];
+            }
+            std::partial_sum(adjacency.offsets.begin(), adjacency.offsets.end(), adjacency.offsets.begin());
+
+            std::vector<uint32_t> cursor(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+            adjacency.triangles.resize(indices.size());
+            for (uint32_t i = 0; i < indices.size(); ++i)
+            {
+                adjacency.triangles[cursor[indices[i]]++] = i / 3;
+            }
+            return adjacency;
+        }
+    }
+
+    MeshOptimizeStats MeshOptimizer::Optimize(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices)
+    {
+        MeshOptimizeStats stats;
+        const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+        const bool validIndices = std::all_of(indices.begin(), indices.end(), [vertexCount](uint32_t index) { return index < vertexCount; });
+        if (indices.size() < 3 || indices.size() % 3 != 0 || !validIndices)
+        {
+            return stats;
+        }
+
+        stats.acmrBefore = ComputeACMR(indices, vertexCount);
+        stats.atvrBefore = ComputeATVR(indices, vertexCount);
+
+        const std::vector<uint32_t> clusters = OptimizeVertexCache(indices, vertexCount);
+        OptimizeOverdraw(indices, clusters, vertices);
+        OptimizeVertexFetch(vertices, indices);
+
+        stats.acmrAfter = ComputeACMR(indices, static_cast<uint32_t>(vertices.size()));
+        stats.atvrAfter = ComputeATVR(indices, static_cast<uint32_t>(vertices.size()));
+        return stats;
+    }
+
+    std::vector<uint32_t> MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t> &indices, uint32_t vertexCount, uint32_t cacheSize)
+    {
+        const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+        const Adjacency adjacency = BuildAdjacency(indices, vertexCount);
+
+        std::vector<uint32_t> liveTriangles(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; ++v)
+        {
+            liveTriangles[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+        }
+
+        std::vector<uint32_t> cacheTime(vertexCount, 0);
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<uint32_t> deadEnd;
+        std::vector<uint32_t> candidates;
+        std::vector<uint32_t> output;
+        output.reserve(indices.size());
+        std::vector<uint32_t> clusters;
+
+        uint32_t timeStamp = cacheSize + 1;
+        uint32_t cursor = 0; // Next vertex in input order for dead end recovery
+        int64_t fanning = vertexCount > 0 ? 0 : -1;
+        bool hardBoundary = true;
+
+        while (fanning >= 0)
+        {
+            const uint32_t f = static_cast<uint32_t>(fanning);
+            candidates.clear();
+
+            // Emit every remaining triangle around the fanning vertex
+            for (uint32_t a = adjacency.offsets[f]; a < adjacency.offsets[f + 1]; ++a)
+            {
+                const uint32_t triangle = adjacency.triangles[a];
+                if (emitted[triangle])
+                {
+                    continue;
+                }
+
+                if (hardBoundary)
+                {
+                    clusters.push_back(static_cast<uint32_t>(output.size() / 3));
+                    hardBoundary = false;
+                }
+
+                for (uint32_t corner = 0; corner < 3; ++corner)
+                {
+                    const uint32_t v = indices[triangle * 3 + corner];
+                    output.push_back(v);
+                    deadEnd.push_back(v);
+                    candidates.push_back(v);
+                    --liveTriangles[v];
+                    if (timeStamp - cacheTime[v] > cacheSize)
+                    {
+                        cacheTime[v] = timeStamp++;
+                    }
+                }
+                emitted[triangle] = true;
+            }
+
+            // Next fanning vertex: the oldest candidate that stays in cache while its fan is emitted
+            int64_t best = -1;
+            int64_t bestPriority = -1;
+            for (uint32_t v : candidates)
+            {
+                if (liveTriangles[v] == 0)
+                {
+                    continue;
+                }
+
+                int64_t priority = 0;
+                if (timeStamp - cacheTime[v] + 2 * liveTriangles[v] <= cacheSize)
+                {
+                    priority = timeStamp - cacheTime[v];
+                }
+                if (priority > bestPriority)
+                {
+                    bestPriority = priority;
+                    best = v;
+                }
+            }
+
+            if (best < 0)
+            {
+                // Dead end, fall back to recently used vertices, then to input order
+                hardBoundary = true;
+                while (!deadEnd.empty() && best < 0)
+                {
+                    const uint32_t v = deadEnd.back();
+                    deadEnd.pop_back();
+                    if (liveTriangles[v] > 0)
+                    {
+                        best = v;
+                    }
+                }
+                while (cursor < vertexCount && best < 0)
+                {
+                    if (liveTriangles[cursor] > 0)
+                    {
+                        best = cursor;
+                    }
+                    ++cursor;
+                }
+            }
+
+            fanning = best;
+        }
+
+        indices = std::move(output);
+        return clusters;
+    }
+
+    void MeshOptimizer::OptimizeOverdraw(std::vector<uint32_t> &indices, const std::vector<uint32_t> &clusters, const std::vector<Vertex> &vertices, float threshold)
+    {
+        const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+        if (clusters.size() < 2)
+        {
+            return;
+        }
+
+        glm::vec3 meshCenter(0.0f);
+        for (uint32_t index : indices)
+        {
+            meshCenter += vertices[index].position;
+        }
+        meshCenter /= static_cast<float>(indices.size());
+
+        // Clusters facing away from the center tend to occlude the ones facing in, draw them first
+        struct Cluster
+        {
+            uint32_t first;
+            uint32_t count;
+            float sortKey;
+        };
+
+        std::vector<Cluster> sorted(clusters.size());
+        for (size_t c = 0; c < clusters.size(); ++c)
+        {
+            const uint32_t first = clusters[c];
+            const uint32_t end = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+
+            glm::vec3 center(0.0f);
+            glm::vec3 normal(0.0f); // Area weighted
+            for (uint32_t t = first; t < end; ++t)
+            {
+                const glm::vec3 &p0 = vertices[indices[t * 3 + 0]].position;
+                const glm::vec3 &p1 = vertices[indices[t * 3 + 1]].position;
+                const glm::vec3 &p2 = vertices[indices[t * 3 + 2]].position;
+                center += (p0 + p1 + p2) / 3.0f;
+                normal += glm::cross(p1 - p0, p2 - p0);
+            }
+            center /= static_cast<float>(end - first);
+
+            sorted[c] = { first, end - first, glm::dot(center - meshCenter, normal) };
+        }
+
+        std::stable_sort(sorted.begin(), sorted.end(), [](const Cluster &a, const Cluster &b) { return a.sortKey > b.sortKey; });
+
+        std::vector<uint32_t> reordered;
+        reordered.reserve(indices.size());
+        for (const Cluster &cluster : sorted)
+        {
+            reordered.insert(reordered.end(), indices.begin() + cluster.first * 3, indices.begin() + (cluster.first + cluster.count) * 3);
+        }
+
+        const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+        if (ComputeACMR(reordered, vertexCount) <= ComputeACMR(indices, vertexCount) * threshold)
+        {
+            indices = std::move(reordered);
+        }
+    }
+
+    void MeshOptimizer::OptimizeVertexFetch(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices)
+    {
+        std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+        std::vector<Vertex> reordered;
+        reordered.reserve(vertices.size());
+
+        for (uint32_t &index : indices)
+        {
+            if (remap[index] == UINT32_MAX)
+            {
+                remap[index] = static_cast<uint32_t>(reordered.size());
+                reordered.push_back(vertices[index]);
+            }
+            index = remap[index];
+        }
+
+        vertices = std::move(reordered);
+    }
+
+    float MeshOptimizer::ComputeACMR(const std::vector<uint32_t> &indices, uint32_t vertexCount, uint32_t cacheSize)
+    {
+        if (indices.empty())
+        {
+            return 0.0f;
+        }
+        const CacheMisses result = SimulateFifoCache(indices, vertexCount, cacheSize);
+        return static_cast<float>(result.misses) / static_cast<float>(indices.size() / 3);
+    }
+
+    float MeshOptimizer::ComputeATVR(const std::vector<uint32_t> &indices, uint32_t vertexCount, uint32_t cacheSize)
+    {
+        if (indices.empty())
+        {
+            return 0.0f;
+        }
+        const CacheMisses result = SimulateFifoCache(indices, vertexCount, cacheSize);
+        return static_cast<float>(result.misses) / static_cast<float>(result.referenced);
+    }
+}
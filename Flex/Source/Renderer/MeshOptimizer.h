@@ -0,0 +1,46 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <cstdint>
+#include <vector>
+
+namespace flex
+{
+    struct Vertex;
+
+    // Average cache miss ratio (misses per triangle, 0.5 is ideal for large regular meshes)
+    // and average transform to vertex ratio (misses per referenced vertex, 1.0 is ideal)
+    struct MeshOptimizeStats
+    {
+        float acmrBefore = 0.0f;
+        float acmrAfter = 0.0f;
+        float atvrBefore = 0.0f;
+        float atvrAfter = 0.0f;
+    };
+
+    // Import time reordering of indexed triangle lists, CPU only.
+    // Tipsify for the post-transform cache, then its clusters sorted outside-in against overdraw
+    // (Sander, Nehab, Barczak 2007), then vertices renumbered in first use order for fetch locality
+    class MeshOptimizer
+    {
+    public:
+        static constexpr uint32_t kCacheSize = 16;
+
+        // Runs every stage in place, vertices that no triangle uses are dropped
+        static MeshOptimizeStats Optimize(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices);
+
+        // Returns the hard boundaries of the new order as first triangle of each cluster
+        static std::vector<uint32_t> OptimizeVertexCache(std::vector<uint32_t> &indices, uint32_t vertexCount, uint32_t cacheSize = kCacheSize);
+        // Keeps the cache order when sorting the clusters would push the ACMR over threshold times the current one
+        static void OptimizeOverdraw(std::vector<uint32_t> &indices, const std::vector<uint32_t> &clusters, const std::vector<Vertex> &vertices, float threshold = 1.05f);
+        static void OptimizeVertexFetch(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices);
+
+        // Simulated FIFO cache of cacheSize entries
+        static float ComputeACMR(const std::vector<uint32_t> &indices, uint32_t vertexCount, uint32_t cacheSize = kCacheSize);
+        static float ComputeATVR(const std::vector<uint32_t> &indices, uint32_t vertexCount, uint32_t cacheSize = kCacheSize);
+    };
+}
+
+#endif
@@ -0,0 +1,170 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#include "ProgramCache.h"
+#include "RenderState.h"
+#include "Core/FileSystem.h"
+
+#include <glad/glad.h>
+
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace flex
+{
+    namespace
+    {
+        constexpr uint32_t kMagic = 0x42505846; // "FXPB"
+        constexpr uint32_t kVersion = 1;
+        // Far past any real program binary, larger sizes mean the file is corrupt
+        constexpr uint32_t kMaxBinarySize = 64u << 20;
+
+        struct FileHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint64_t key;
+            uint32_t binaryFormat;
+            uint32_t binarySize;
+        };
+
+        // FNV-1a
+        uint64_t HashBytes(uint64_t hash, const void *data, size_t size)
+        {
+            const uint8_t *bytes = static_cast<const uint8_t *>(data);
+            for (size_t i = 0; i < size; ++i)
+            {
+                hash ^= bytes[i];
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        uint64_t HashString(uint64_t hash, std::string_view str)
+        {
+            // The length keeps "ab" + "c" and "a" + "bc" apart
+            const uint64_t length = str.size();
+            hash = HashBytes(hash, &length, sizeof(length));
+            return HashBytes(hash, str.data(), str.size());
+        }
+
+        std::string_view GetGLString(GLenum name)
+        {
+            const char *str = reinterpret_cast<const char *>(glGetString(name));
+            return str ? str : "";
+        }
+    }
+
+    ProgramCache::ProgramCache(const std::filesystem::path &directory)
+        : m_Directory(directory)
+    {
+        GLint formatCount = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+        m_Enabled = formatCount > 0;
+
+        uint64_t key = HashBytes(14695981039346656037ull, &kVersion, sizeof(kVersion));
+        key = HashString(key, GetGLString(GL_VENDOR));
+        key = HashString(key, GetGLString(GL_RENDERER));
+        key = HashString(key, GetGLString(GL_VERSION));
+        m_DriverKey = key;
+
+        if (!m_Enabled)
+        {
+            std::cout << "Program cache disabled, the driver exposes no program binary formats\n";
+        }
+    }
+
+    uint64_t ProgramCache::AppendKey(uint64_t key, uint32_t stage, std::string_view source)
+    {
+        key = HashBytes(key, &stage, sizeof(stage));
+        return HashString(key, source);
+    }
+
+    uint32_t ProgramCache::Load(uint64_t key)
+    {
+        if (!m_Enabled)
+        {
+            return 0;
+        }
+
+        const std::filesystem::path path = GetPath(key);
+        std::ifstream file(path, std::ios::binary);
+        FileHeader header = {};
+        if (!file || !file.read(reinterpret_cast<char *>(&header), sizeof(header))
+            || header.magic != kMagic || header.version != kVersion || header.key != key)
+        {
+            ++m_Misses;
+            return 0;
+        }
+
+        // The size comes from disk, it has to fit the file before it is allocated
+        std::error_code error;
+        const uintmax_t fileSize = std::filesystem::file_size(path, error);
+        if (error || header.binarySize == 0 || header.binarySize > kMaxBinarySize
+            || header.binarySize > fileSize - sizeof(header))
+        {
+            ++m_Misses;
+            return 0;
+        }
+
+        std::vector<char> binary(header.binarySize);
+        if (!file.read(binary.data(), static_cast<std::streamsize>(binary.size())))
+        {
+            ++m_Misses;
+            return 0;
+        }
+        file.close();
+
+        const GLuint program = glCreateProgram();
+        glProgramBinary(program, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+
+        // Drivers may refuse binaries they wrote themselves, e.g. after an update that kept the version string
+        GLint status = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+        if (status == GL_FALSE)
+        {
+            RenderState::DeleteProgram(program);
+            std::filesystem::remove(path, error);
+            ++m_Misses;
+            return 0;
+        }
+
+        ++m_Hits;
+        return program;
+    }
+
+    void ProgramCache::Store(uint64_t key, uint32_t program)
+    {
+        if (!m_Enabled)
+        {
+            return;
+        }
+
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+        {
+            return;
+        }
+
+        FileHeader header = { kMagic, kVersion, key, 0, 0 };
+        std::vector<char> binary(static_cast<size_t>(length));
+        GLsizei written = 0;
+        GLenum binaryFormat = 0;
+        glGetProgramBinary(program, length, &written, &binaryFormat, binary.data());
+        header.binaryFormat = binaryFormat;
+        header.binarySize = static_cast<uint32_t>(written);
+
+        WriteFileAtomic(GetPath(key), [&](std::ofstream &file)
+        {
+            file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            file.write(binary.data(), written);
+        });
+    }
+
+    std::filesystem::path ProgramCache::GetPath(uint64_t key) const
+    {
+        return m_Directory / std::format("{:016x}.bin", key);
+    }
+}
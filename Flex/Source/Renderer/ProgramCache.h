@@ -0,0 +1,47 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace flex
+{
+    // Linked program binaries on disk, one file per program named after its key.
+    // The key covers the exact source text of every stage and the driver vendor, renderer and version,
+    // so an edited shader, a new define or a driver update all miss and recompile
+    class ProgramCache
+    {
+    public:
+        ProgramCache(const std::filesystem::path &directory);
+
+        bool IsEnabled() const { return m_Enabled; }
+
+        // Starts a key from the driver identity, extend it with AppendKey per stage
+        uint64_t BeginKey() const { return m_DriverKey; }
+        static uint64_t AppendKey(uint64_t key, uint32_t stage, std::string_view source);
+
+        // Creates a linked program from the cached binary, 0 on a miss or when the driver rejects it
+        uint32_t Load(uint64_t key);
+        // Writes the binary of a program linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+        void Store(uint64_t key, uint32_t program);
+
+        uint32_t GetHitCount() const { return m_Hits; }
+        uint32_t GetMissCount() const { return m_Misses; }
+
+    private:
+        std::filesystem::path GetPath(uint64_t key) const;
+
+        std::filesystem::path m_Directory;
+        uint64_t m_DriverKey = 0;
+        bool m_Enabled = false;
+
+        uint32_t m_Hits = 0;
+        uint32_t m_Misses = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,264 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#include "RenderQueue.h"
+#include "Shader.h"
+#include "ShaderVariants.h"
+#include "Material.h"
+#include "Mesh.h"
+#include "StreamingBuffer.h"
+#include "RenderState.h"
+#include "MaterialTable.h"
+#include "RendererCommon.h"
+#include "Renderer.h"
+
+#include <glad/glad.h>
+
+#include <array>
+#include <bit>
+
+namespace flex
+{
+    namespace
+    {
+        constexpr uint64_t kShaderBits = 12;
+        constexpr uint64_t kIndexTypeBits = 1;
+        constexpr uint64_t kMaterialBits = 13;
+        constexpr uint64_t kMeshBits = 16;
+        constexpr uint64_t kDepthBits = 20;
+
+        constexpr uint64_t Mask(uint64_t bits) { return (uint64_t(1) << bits) - 1; }
+
+        bool CanBatch(const DrawItem &a, const DrawItem &b)
+        {
+            return a.shader == b.shader && a.material == b.material && a.mesh == b.mesh;
+        }
+
+        // Non negative floats keep their order when compared as integers,
+        // the top bits give a logarithmic depth without needing the far plane
+        uint64_t QuantizeDepth(float viewDepth)
+        {
+            const float depth = viewDepth > 0.0f ? viewDepth : 0.0f;
+            return (std::bit_cast<uint32_t>(depth) >> (32 - kDepthBits - 1)) & Mask(kDepthBits);
+        }
+    }
+
+    void RenderQueue::Clear()
+    {
+        m_Items.clear();
+        m_Entries.clear();
+        m_Batches.clear();
+        m_Runs.clear();
+        m_ShaderIndices.clear();
+        m_MaterialIndices.clear();
+        m_MeshIndices.clear();
+    }
+
+    uint32_t RenderQueue::GetDenseIndex(std::unordered_map<uint32_t, uint32_t> &indices, uint32_t id)
+    {
+        return indices.try_emplace(id, static_cast<uint32_t>(indices.size())).first->second;
+    }
+
+    void RenderQueue::Submit(RenderPass pass, ShaderVariants &shaders, uint32_t features, Material *material, const Mesh *mesh,
+        const glm::mat4 &transform, float viewDepth)
+    {
+        // Materials without a map get a variant that doesn't sample it, the queue groups draws per variant
+        if (material)
+        {
+            material->UpdateData();
+            features |= material->GetFeatures();
+        }
+        Submit(pass, shaders.Get(features), material, mesh, transform, viewDepth);
+    }
+
+    void RenderQueue::Submit(RenderPass pass, Shader *shader, Material *material, const Mesh *mesh, const glm::mat4 &transform, float viewDepth)
+    {
+        const uint32_t shaderId = shader ? shader->GetProgram() : 0;
+        const uint32_t materialId = material ? material->id : 0;
+
+        const uint64_t key = MakeSortKey(pass, GetDenseIndex(m_ShaderIndices, shaderId), GetDenseIndex(m_MaterialIndices, materialId),
+            GetDenseIndex(m_MeshIndices, mesh->id), viewDepth, mesh->geometry.indexType);
+        m_Entries.push_back({ key, static_cast<uint32_t>(m_Items.size()) });
+        m_Items.push_back({ shader, material, mesh, &transform });
+    }
+
+    void RenderQueue::Sort()
+    {
+        RadixSort(m_Entries, m_Scratch);
+
+        // Identical draws are adjacent after sorting, except transparent ones split by depth order
+        m_Batches.clear();
+        const uint32_t count = static_cast<uint32_t>(m_Entries.size());
+        uint32_t first = 0;
+        while (first < count)
+        {
+            uint32_t last = first + 1;
+            while (last < count && CanBatch(GetItem(first), GetItem(last)))
+            {
+                ++last;
+            }
+
+            m_Batches.push_back({ first, last - first });
+            first = last;
+        }
+
+        // Materials are indexed per instance, so only a shader or index type change ends a multi draw
+        m_Runs.clear();
+        const uint32_t batchCount = static_cast<uint32_t>(m_Batches.size());
+        uint32_t firstBatch = 0;
+        while (firstBatch < batchCount)
+        {
+            const DrawItem &item = GetItem(m_Batches[firstBatch].first);
+            const IndexType indexType = item.mesh->geometry.indexType;
+
+            uint32_t lastBatch = firstBatch + 1;
+            while (lastBatch < batchCount)
+            {
+                const DrawItem &next = GetItem(m_Batches[lastBatch].first);
+                if (next.shader != item.shader || next.mesh->geometry.indexType != indexType)
+                {
+                    break;
+                }
+                ++lastBatch;
+            }
+
+            m_Runs.push_back({ firstBatch, lastBatch - firstBatch, indexType });
+            firstBatch = lastBatch;
+        }
+    }
+
+    RenderQueueStats RenderQueue::Execute()
+    {
+        RenderQueueStats stats;
+        GeometryPool *pool = Renderer::GetGeometryPool();
+        if (m_Entries.empty() || !pool)
+        {
+            return stats;
+        }
+
+        // Written straight into the mapped ring, in the order the batches read them
+        StreamingBuffer *stream = Renderer::GetStreamingBuffer();
+        const size_t instanceBytes = m_Entries.size() * sizeof(InstanceData);
+        const StreamAllocation instances = stream->Allocate(instanceBytes, stream->GetStorageAlignment());
+        InstanceData *instance = static_cast<InstanceData *>(instances.data);
+        for (size_t i = 0; i < m_Entries.size(); ++i, ++instance)
+        {
+            const DrawItem &item = GetItem(i);
+            instance->transform = *item.transform;
+            instance->materialIndex = item.material ? item.material->GetSlot() : 0;
+        }
+
+        const size_t commandBytes = m_Batches.size() * sizeof(DrawElementsIndirectCommand);
+        const StreamAllocation commands = stream->Allocate(commandBytes, sizeof(DrawElementsIndirectCommand));
+        DrawElementsIndirectCommand *command = static_cast<DrawElementsIndirectCommand *>(commands.data);
+        for (const DrawBatch &batch : m_Batches)
+        {
+            const GeometryAllocation &geometry = GetItem(batch.first).mesh->geometry;
+            *command++ = { geometry.indexCount, batch.count, geometry.firstIndex, static_cast<int32_t>(geometry.baseVertex), batch.first };
+        }
+
+        stream->BindRange(GL_SHADER_STORAGE_BUFFER, STORAGE_BINDING_LOC_INSTANCES, instances, instanceBytes);
+        RenderState::BindDrawIndirectBuffer(commands.buffer);
+
+        // Only materials edited since the last pass are uploaded, textures are referenced from the table
+        Renderer::GetMaterialTable()->Flush();
+
+        pool->Bind();
+        ++stats.vertexArrayBinds;
+
+        for (const DrawRun &run : m_Runs)
+        {
+            GetItem(m_Batches[run.firstBatch].first).shader->Use();
+            ++stats.shaderBinds;
+
+            glMultiDrawElementsIndirect(GL_TRIANGLES, ToGLIndexType(run.indexType),
+                reinterpret_cast<const void *>(commands.offset + run.firstBatch * sizeof(DrawElementsIndirectCommand)),
+                static_cast<GLsizei>(run.batchCount), 0);
+            ++stats.drawCalls;
+        }
+
+        stats.drawCommands = static_cast<uint32_t>(m_Batches.size());
+        stats.instances = static_cast<uint32_t>(m_Entries.size());
+        return stats;
+    }
+
+    uint64_t RenderQueue::MakeSortKey(RenderPass pass, uint32_t shaderId, uint32_t materialId, uint32_t meshId, float viewDepth, IndexType indexType)
+    {
+        const uint64_t passBits = static_cast<uint64_t>(pass) << 62;
+        // Shader and index type together decide where a multi draw run ends
+        const uint64_t shader = ((shaderId & Mask(kShaderBits)) << kIndexTypeBits) | (indexType == IndexType::UINT32 ? 1 : 0);
+        const uint64_t material = materialId & Mask(kMaterialBits);
+        const uint64_t mesh = meshId & Mask(kMeshBits);
+        const uint64_t depth = QuantizeDepth(viewDepth);
+
+        if (pass == RenderPass::Transparent)
+        {
+            // Blending needs the far items first, state grouping only breaks ties
+            const uint64_t invertedDepth = ~depth & Mask(kDepthBits);
+            return passBits
+                | (invertedDepth << (kShaderBits + kIndexTypeBits + kMaterialBits + kMeshBits))
+                | (shader << (kMaterialBits + kMeshBits))
+                | (material << kMeshBits)
+                | mesh;
+        }
+
+        return passBits
+            | (shader << (kMaterialBits + kMeshBits + kDepthBits))
+            | (material << (kMeshBits + kDepthBits))
+            | (mesh << kDepthBits)
+            | depth;
+    }
+
+    void RenderQueue::RadixSort(std::vector<SortEntry> &entries, std::vector<SortEntry> &scratch)
+    {
+        const size_t count = entries.size();
+        if (count < 2)
+        {
+            return;
+        }
+
+        // One read to build every digit histogram up front
+        std::array<std::array<uint32_t, 256>, 8> histograms = {};
+        for (const SortEntry &entry : entries)
+        {
+            for (int digit = 0; digit < 8; ++digit)
+            {
+                ++histograms[digit][(entry.key >> (digit * 8)) & 0xFF];
+            }
+        }
+
+        scratch.resize(count);
+        SortEntry *src = entries.data();
+        SortEntry *dst = scratch.data();
+
+        for (int digit = 0; digit < 8; ++digit)
+        {
+            std::array<uint32_t, 256> &histogram = histograms[digit];
+            const uint32_t firstBucket = static_cast<uint32_t>((src[0].key >> (digit * 8)) & 0xFF);
+            if (histogram[firstBucket] == count)
+            {
+                continue;
+            }
+
+            uint32_t offset = 0;
+            for (uint32_t &bucket : histogram)
+            {
+                const uint32_t bucketCount = bucket;
+                bucket = offset;
+                offset += bucketCount;
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                const uint32_t bucket = static_cast<uint32_t>((src[i].key >> (digit * 8)) & 0xFF);
+                dst[histogram[bucket]++] = src[i];
+            }
+
+            std::swap(src, dst);
+        }
+
+        if (src != entries.data())
+        {
+            entries.swap(scratch);
+        }
+    }
+}
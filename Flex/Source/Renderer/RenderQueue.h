@@ -0,0 +1,127 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "GeometryPool.h"
+
+namespace flex
+{
+    class Shader;
+    class ShaderVariants;
+    struct Material;
+    struct Mesh;
+
+    // Highest bits of the sort key, passes are drawn in this order
+    enum class RenderPass : uint8_t
+    {
+        Opaque = 0,
+        Transparent = 1,
+    };
+
+    struct DrawItem
+    {
+        Shader *shader = nullptr;
+        Material *material = nullptr; // nullptr for depth only passes
+        const Mesh *mesh = nullptr;
+        const glm::mat4 *transform = nullptr; // Must stay valid until Execute
+    };
+
+    // Per instance record read by the instanced vertex shaders, std430 layout
+    struct InstanceData
+    {
+        glm::mat4 transform;
+        uint32_t materialIndex; // Material::GetSlot, 0 for depth only passes
+        uint32_t padding[3];
+    };
+
+    struct RenderQueueStats
+    {
+        uint32_t drawCalls = 0;      // glMultiDrawElementsIndirect calls
+        uint32_t drawCommands = 0;   // Indirect commands, one per batch
+        uint32_t instances = 0;
+        uint32_t shaderBinds = 0;
+        uint32_t vertexArrayBinds = 0;
+
+        uint32_t GetStateChanges() const { return shaderBinds + vertexArrayBinds; }
+    };
+
+    // Per frame list of draws sorted by a packed 64 bit key so consecutive draws share state.
+    // Opaque:      pass(2) | shader(12) | index(1) | material(13) | mesh(16) | depth(20), front to back within a state group
+    // Transparent: pass(2) | ~depth(20) | shader(12) | index(1) | material(13) | mesh(16), strictly back to front
+    // Shader, material and mesh ids are remapped to dense indices in submission order every frame, so process wide
+    // ids past the field widths don't alias as long as a frame has fewer distinct ones than a field holds.
+    // Consecutive items sharing shader, material and mesh are merged into one instanced draw command,
+    // and consecutive commands sharing a shader and index type go out as one multi draw indirect call. Material
+    // params and textures are looked up per instance (MaterialTable, TextureTable), so materials never split a call.
+    class RenderQueue
+    {
+    public:
+        struct SortEntry
+        {
+            uint64_t key;
+            uint32_t index;
+        };
+
+        // Range of sorted items drawn with a single indirect command
+        struct DrawBatch
+        {
+            uint32_t first;
+            uint32_t count;
+        };
+
+        // Range of batches drawn with a single glMultiDrawElementsIndirect
+        struct DrawRun
+        {
+            uint32_t firstBatch;
+            uint32_t batchCount;
+            IndexType indexType;
+        };
+
+        void Clear();
+        // Updates the material's data and draws it with the variant of features plus its map features
+        void Submit(RenderPass pass, ShaderVariants &shaders, uint32_t features, Material *material, const Mesh *mesh,
+            const glm::mat4 &transform, float viewDepth);
+        // The shader is already chosen, material data has to be up to date (see the overload above)
+        void Submit(RenderPass pass, Shader *shader, Material *material, const Mesh *mesh, const glm::mat4 &transform, float viewDepth);
+        // Sorts the items and merges them into batches and runs
+        void Sort();
+
+        // Streams InstanceData in sorted order and one DrawElementsIndirectCommand per batch, then
+        // draws every run with one glMultiDrawElementsIndirect out of the geometry pool.
+        // Shaders read their instance at gl_BaseInstance + gl_InstanceID (see pbr_instanced.vert.glsl)
+        RenderQueueStats Execute();
+
+        size_t GetSize() const { return m_Items.size(); }
+        const DrawItem &GetItem(size_t sortedIndex) const { return m_Items[m_Entries[sortedIndex].index]; }
+        const std::vector<DrawBatch> &GetBatches() const { return m_Batches; }
+        const std::vector<DrawRun> &GetRuns() const { return m_Runs; }
+
+        static uint64_t MakeSortKey(RenderPass pass, uint32_t shaderId, uint32_t materialId, uint32_t meshId, float viewDepth,
+            IndexType indexType = IndexType::UINT32);
+
+        // LSD radix sort on the key, 8 bits per pass. Passes where every key shares the digit are skipped
+        static void RadixSort(std::vector<SortEntry> &entries, std::vector<SortEntry> &scratch);
+
+    private:
+        // Frame local index of id, in first submission order
+        static uint32_t GetDenseIndex(std::unordered_map<uint32_t, uint32_t> &indices, uint32_t id);
+
+        std::vector<DrawItem> m_Items;
+        std::vector<SortEntry> m_Entries;
+        std::vector<SortEntry> m_Scratch;
+        std::vector<DrawBatch> m_Batches;
+        std::vector<DrawRun> m_Runs;
+        std::unordered_map<uint32_t, uint32_t> m_ShaderIndices;
+        std::unordered_map<uint32_t, uint32_t> m_MaterialIndices;
+        std::unordered_map<uint32_t, uint32_t> m_MeshIndices;
+    };
+}
+
+#endif
@@ -0,0 +1,317 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#include "RenderState.h"
+
+#include <numeric>
+
+namespace flex
+{
+    namespace
+    {
+        constexpr uint32_t kUnknown = UINT32_MAX;
+        constexpr uint32_t kMaxTextureUnits = 32;
+        constexpr uint32_t kMaxBufferBindings = 16;
+
+        enum CachedCapability : uint32_t
+        {
+            CAPABILITY_DEPTH_TEST,
+            CAPABILITY_CULL_FACE,
+            CAPABILITY_BLEND,
+            CAPABILITY_DEPTH_CLAMP,
+            CAPABILITY_COUNT
+        };
+
+        struct BufferRange
+        {
+            uint32_t buffer = kUnknown;
+            size_t offset = 0;
+            size_t size = 0;
+        };
+
+        struct CachedState
+        {
+            uint32_t program = kUnknown;
+            std::array<uint32_t, kMaxTextureUnits> textureUnits;
+            uint32_t vertexArray = kUnknown;
+            uint32_t framebuffer = kUnknown;
+            uint32_t drawIndirectBuffer = kUnknown;
+            std::array<BufferRange, kMaxBufferBindings> uniformBuffers;
+            std::array<BufferRange, kMaxBufferBindings> storageBuffers;
+
+            std::array<int, 4> viewport = { -1, -1, -1, -1 };
+            std::array<uint32_t, CAPABILITY_COUNT> capabilities; // 0 / 1 / kUnknown
+            uint32_t depthFunc = kUnknown;
+            uint32_t depthWrite = kUnknown;
+            uint32_t cullFace = kUnknown;
+            std::array<uint32_t, 2> blendFunc = { kUnknown, kUnknown };
+
+            CachedState()
+            {
+                textureUnits.fill(kUnknown);
+                capabilities.fill(kUnknown);
+            }
+        };
+
+        CachedState s_State;
+        RenderStateStats s_FrameStats;
+        RenderStateStats s_LastFrameStats;
+
+        // Updates the cached value and tells whether the call has to be issued
+        template<typename T>
+        bool Change(T &cached, const T &value, RenderStateCall call)
+        {
+            const size_t index = static_cast<size_t>(call);
+            if (cached == value)
+            {
+                ++s_FrameStats.skipped[index];
+                return false;
+            }
+
+            cached = value;
+            ++s_FrameStats.issued[index];
+            return true;
+        }
+
+        uint32_t ToCachedCapability(GLenum capability)
+        {
+            switch (capability)
+            {
+                case GL_DEPTH_TEST: return CAPABILITY_DEPTH_TEST;
+                case GL_CULL_FACE: return CAPABILITY_CULL_FACE;
+                case GL_BLEND: return CAPABILITY_BLEND;
+                case GL_DEPTH_CLAMP: return CAPABILITY_DEPTH_CLAMP;
+                default: return CAPABILITY_COUNT;
+            }
+        }
+    }
+
+    uint32_t RenderStateStats::GetIssued() const
+    {
+        return std::accumulate(issued.begin(), issued.end(), 0u);
+    }
+
+    uint32_t RenderStateStats::GetSkipped() const
+    {
+        return std::accumulate(skipped.begin(), skipped.end(), 0u);
+    }
+
+    void RenderState::UseProgram(uint32_t program)
+    {
+        if (Change(s_State.program, program, RenderStateCall::Program))
+        {
+            glUseProgram(program);
+        }
+    }
+
+    void RenderState::BindTextureUnit(uint32_t unit, uint32_t texture)
+    {
+        if (unit >= kMaxTextureUnits)
+        {
+            ++s_FrameStats.issued[static_cast<size_t>(RenderStateCall::Texture)];
+            glBindTextureUnit(unit, texture);
+            return;
+        }
+
+        if (Change(s_State.textureUnits[unit], texture, RenderStateCall::Texture))
+        {
+            glBindTextureUnit(unit, texture);
+        }
+    }
+
+    void RenderState::BindVertexArray(uint32_t vertexArray)
+    {
+        if (Change(s_State.vertexArray, vertexArray, RenderStateCall::VertexArray))
+        {
+            glBindVertexArray(vertexArray);
+        }
+    }
+
+    void RenderState::BindFramebuffer(uint32_t framebuffer)
+    {
+        if (Change(s_State.framebuffer, framebuffer, RenderStateCall::Framebuffer))
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        }
+    }
+
+    void RenderState::BindDrawIndirectBuffer(uint32_t buffer)
+    {
+        if (Change(s_State.drawIndirectBuffer, buffer, RenderStateCall::Buffer))
+        {
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer);
+        }
+    }
+
+    void RenderState::BindBufferRange(GLenum target, uint32_t index, uint32_t buffer, size_t offset, size_t size)
+    {
+        std::array<BufferRange, kMaxBufferBindings> *ranges = nullptr;
+        if (target == GL_UNIFORM_BUFFER)
+        {
+            ranges = &s_State.uniformBuffers;
+        }
+        else if (target == GL_SHADER_STORAGE_BUFFER)
+        {
+            ranges = &s_State.storageBuffers;
+        }
+
+        if (ranges && index < kMaxBufferBindings)
+        {
+            BufferRange &range = (*ranges)[index];
+            if (range.buffer == buffer && range.offset == offset && range.size == size)
+            {
+                ++s_FrameStats.skipped[static_cast<size_t>(RenderStateCall::Buffer)];
+                return;
+            }
+            range = { buffer, offset, size };
+        }
+
+        ++s_FrameStats.issued[static_cast<size_t>(RenderStateCall::Buffer)];
+        if (size == 0)
+        {
+            glBindBufferBase(target, index, buffer);
+        }
+        else
+        {
+            glBindBufferRange(target, index, buffer, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
+        }
+    }
+
+    void RenderState::SetViewport(int x, int y, int width, int height)
+    {
+        if (Change(s_State.viewport, { x, y, width, height }, RenderStateCall::Viewport))
+        {
+            glViewport(x, y, width, height);
+        }
+    }
+
+    void RenderState::SetEnabled(GLenum capability, bool enabled)
+    {
+        const uint32_t cached = ToCachedCapability(capability);
+        if (cached == CAPABILITY_COUNT)
+        {
+            ++s_FrameStats.issued[static_cast<size_t>(RenderStateCall::Capability)];
+        }
+        else if (!Change(s_State.capabilities[cached], uint32_t(enabled), RenderStateCall::Capability))
+        {
+            return;
+        }
+
+        if (enabled)
+        {
+            glEnable(capability);
+        }
+        else
+        {
+            glDisable(capability);
+        }
+    }
+
+    void RenderState::SetDepthFunc(GLenum func)
+    {
+        if (Change(s_State.depthFunc, uint32_t(func), RenderStateCall::Depth))
+        {
+            glDepthFunc(func);
+        }
+    }
+
+    void RenderState::SetDepthWrite(bool enabled)
+    {
+        if (Change(s_State.depthWrite, uint32_t(enabled), RenderStateCall::Depth))
+        {
+            glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+        }
+    }
+
+    void RenderState::SetCullFace(GLenum face)
+    {
+        if (Change(s_State.cullFace, uint32_t(face), RenderStateCall::Cull))
+        {
+            glCullFace(face);
+        }
+    }
+
+    void RenderState::SetBlendFunc(GLenum source, GLenum destination)
+    {
+        if (Change(s_State.blendFunc, { uint32_t(source), uint32_t(destination) }, RenderStateCall::Blend))
+        {
+            glBlendFunc(source, destination);
+        }
+    }
+
+    void RenderState::DeleteProgram(uint32_t program)
+    {
+        // A program in use stays current until another one is used, the name may not
+        if (s_State.program == program)
+        {
+            s_State.program = kUnknown;
+        }
+        glDeleteProgram(program);
+    }
+
+    void RenderState::DeleteTexture(uint32_t texture)
+    {
+        for (uint32_t &bound : s_State.textureUnits)
+        {
+            if (bound == texture)
+            {
+                bound = 0;
+            }
+        }
+        glDeleteTextures(1, &texture);
+    }
+
+    void RenderState::DeleteFramebuffer(uint32_t framebuffer)
+    {
+        if (s_State.framebuffer == framebuffer)
+        {
+            s_State.framebuffer = 0;
+        }
+        glDeleteFramebuffers(1, &framebuffer);
+    }
+
+    void RenderState::DeleteVertexArray(uint32_t vertexArray)
+    {
+        if (s_State.vertexArray == vertexArray)
+        {
+            s_State.vertexArray = 0;
+        }
+        glDeleteVertexArrays(1, &vertexArray);
+    }
+
+    void RenderState::DeleteBuffer(uint32_t buffer)
+    {
+        if (s_State.drawIndirectBuffer == buffer)
+        {
+            s_State.drawIndirectBuffer = 0;
+        }
+
+        for (auto *ranges : { &s_State.uniformBuffers, &s_State.storageBuffers })
+        {
+            for (BufferRange &range : *ranges)
+            {
+                if (range.buffer == buffer)
+                {
+                    range = { 0, 0, 0 };
+                }
+            }
+        }
+        glDeleteBuffers(1, &buffer);
+    }
+
+    void RenderState::Invalidate()
+    {
+        s_State = CachedState();
+    }
+
+    void RenderState::EndFrame()
+    {
+        s_LastFrameStats = s_FrameStats;
+        s_FrameStats = RenderStateStats();
+        Invalidate();
+    }
+
+    const RenderStateStats &RenderState::GetLastFrameStats()
+    {
+        return s_LastFrameStats;
+    }
+}
@@ -0,0 +1,77 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#ifndef RENDER_STATE_H
+#define RENDER_STATE_H
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace flex
+{
+    enum class RenderStateCall : uint8_t
+    {
+        Program,
+        Texture,
+        VertexArray,
+        Buffer,
+        Framebuffer,
+        Viewport,
+        Capability, // glEnable / glDisable
+        Depth,      // glDepthFunc / glDepthMask
+        Cull,
+        Blend,
+        Count
+    };
+
+    struct RenderStateStats
+    {
+        std::array<uint32_t, static_cast<size_t>(RenderStateCall::Count)> issued = {};
+        std::array<uint32_t, static_cast<size_t>(RenderStateCall::Count)> skipped = {};
+
+        uint32_t GetIssued() const;
+        uint32_t GetSkipped() const;
+    };
+
+    // Shadow copy of the GL state the renderer touches. Calls that would set what is already set never reach
+    // the driver. Objects bound through here must be deleted through here too, GL resets bindings of deleted
+    // names and a reused name would otherwise look bound. The element array buffer is vertex array state and
+    // is not tracked. Everything is forgotten at EndFrame, so state changed by other code between frames
+    // (ImGui backends, loaders) can't leak into the next frame.
+    class RenderState
+    {
+    public:
+        static void UseProgram(uint32_t program);
+        static void BindTextureUnit(uint32_t unit, uint32_t texture);
+        static void BindVertexArray(uint32_t vertexArray);
+        static void BindFramebuffer(uint32_t framebuffer);
+        static void BindDrawIndirectBuffer(uint32_t buffer);
+        // Indexed GL_UNIFORM_BUFFER / GL_SHADER_STORAGE_BUFFER binding, size 0 binds the whole buffer
+        static void BindBufferRange(GLenum target, uint32_t index, uint32_t buffer, size_t offset, size_t size);
+
+        static void SetViewport(int x, int y, int width, int height);
+        // GL_DEPTH_TEST, GL_CULL_FACE, GL_BLEND and GL_DEPTH_CLAMP are cached, other caps always go through
+        static void SetEnabled(GLenum capability, bool enabled);
+        static void SetDepthFunc(GLenum func);
+        static void SetDepthWrite(bool enabled);
+        static void SetCullFace(GLenum face);
+        static void SetBlendFunc(GLenum source, GLenum destination);
+
+        static void DeleteProgram(uint32_t program);
+        static void DeleteTexture(uint32_t texture);
+        static void DeleteFramebuffer(uint32_t framebuffer);
+        static void DeleteVertexArray(uint32_t vertexArray);
+        static void DeleteBuffer(uint32_t buffer);
+
+        // Forgets every cached value, the next call of each kind reaches the driver
+        static void Invalidate();
+        // Publishes this frame's counters and invalidates
+        static void EndFrame();
+
+        static const RenderStateStats &GetLastFrameStats();
+    };
+}
+
+#endif
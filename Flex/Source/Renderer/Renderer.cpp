@@ -4,6 +4,16 @@
 #include "VertexArray.h"
 #include "IndexBuffer.h"
 #include "Texture.h"
+#include "Mesh.h"
+#include "GeometryPool.h"
+#include "StreamingBuffer.h"
+#include "MaterialTable.h"
+#include "RenderState.h"
+#include "TextureTable.h"
+#include "ProgramCache.h"
+#include "ShaderVariants.h"
+#include "TextureLoader.h"
+#include "TextureStreamer.h"
 
 #include <glad/glad.h>
 #include <unordered_map>
@@ -18,6 +28,16 @@ namespace flex
         std::shared_ptr<Texture2D> flatNormalTexture;
 
         std::unordered_map<std::string, Ref<Shader>> shaderCache;
+        std::unordered_map<std::string, Ref<ShaderVariants>> variantCache;
+
+        Scope<GeometryPool> geometryPool;
+        Scope<StreamingBuffer> streamingBuffer;
+        Scope<TextureTable> textureTable;
+        Scope<MaterialTable> materialTable;
+        Scope<ProgramCache> programCache;
+        Scope<TextureLoader> textureLoader;
+        Scope<TextureStreamer> textureStreamer;
+        uint32_t pendingShaders = 0;
     };
 
     static RendererData *s_Data = nullptr;
@@ -25,6 +45,20 @@ namespace flex
     void Renderer::Init()
     {
         s_Data = new RendererData();
+        s_Data->programCache = CreateScope<ProgramCache>("Cache/Shaders");
+        Shader::EnableParallelCompile();
+
+        // 1M vertices / 6M 16-bit indices (12 MB) up front, the pool doubles when a load needs more
+        s_Data->geometryPool = CreateScope<GeometryPool>(1u << 20, 6u << 20);
+
+        // Three 8 MB regions, one written by the CPU while the GPU may still read the other two
+        s_Data->streamingBuffer = CreateScope<StreamingBuffer>(8u << 20, 3);
+        s_Data->textureTable = CreateScope<TextureTable>();
+        s_Data->materialTable = CreateScope<MaterialTable>();
+
+        // Two 64 MB staging regions, one 4K RGBA8 texture each
+        s_Data->textureLoader = CreateScope<TextureLoader>(64u << 20, 2, "Cache/Textures");
+        s_Data->textureStreamer = CreateScope<TextureStreamer>(256u << 20, s_Data->textureLoader->GetStaging());
     }
 
     void Renderer::Shutdown()
@@ -32,9 +66,21 @@ namespace flex
         if (s_Data)
         {
             delete s_Data;
+            s_Data = nullptr;
         }
     }
 
+    void Renderer::EndFrame()
+    {
+        s_Data->streamingBuffer->EndFrame();
+        s_Data->textureTable->CollectExpired();
+        RenderState::EndFrame();
+        s_Data->pendingShaders = PollShaders();
+        // The streamer's uploads share the loader's staging region, which the loader fences at the end of its update
+        s_Data->textureStreamer->Update();
+        s_Data->textureLoader->Update();
+    }
+
     void Renderer::Draw(std::shared_ptr<VertexArray> vertexArray, uint32_t count)
     {
         vertexArray->Bind();
@@ -43,20 +89,62 @@ namespace flex
 
     void Renderer::DrawIndexed(std::shared_ptr<VertexArray> vertexArray, std::shared_ptr<IndexBuffer> indexBuffer)
     {
-        uint32_t count = 0;
-        if (indexBuffer)
-        {
-            indexBuffer->Bind();
-            count = indexBuffer->GetCount();
-        }
-        else
-        {
-            vertexArray->GetIndexBuffer()->Bind();
-            count = vertexArray->GetIndexBuffer()->GetCount();
-        }
+        const std::shared_ptr<IndexBuffer> indices = indexBuffer ? indexBuffer : vertexArray->GetIndexBuffer();
+        indices->Bind();
 
         vertexArray->Bind();
-        glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
+        glDrawElements(GL_TRIANGLES, indices->GetCount(), ToGLIndexType(indices->GetType()), nullptr);
+    }
+
+    void Renderer::DrawMesh(const Mesh &mesh)
+    {
+        if (!mesh.geometry.IsValid())
+            return;
+
+        s_Data->geometryPool->Bind();
+        glDrawElementsBaseVertex(GL_TRIANGLES, mesh.geometry.indexCount, ToGLIndexType(mesh.geometry.indexType),
+            reinterpret_cast<const void *>(static_cast<uintptr_t>(mesh.geometry.firstIndex) * GetIndexTypeSize(mesh.geometry.indexType)),
+            static_cast<GLint>(mesh.geometry.baseVertex));
+    }
+
+    GeometryPool *Renderer::GetGeometryPool()
+    {
+        return s_Data ? s_Data->geometryPool.get() : nullptr;
+    }
+
+    StreamingBuffer *Renderer::GetStreamingBuffer()
+    {
+        return s_Data ? s_Data->streamingBuffer.get() : nullptr;
+    }
+
+    MaterialTable *Renderer::GetMaterialTable()
+    {
+        return s_Data ? s_Data->materialTable.get() : nullptr;
+    }
+
+    TextureTable *Renderer::GetTextureTable()
+    {
+        return s_Data ? s_Data->textureTable.get() : nullptr;
+    }
+
+    ProgramCache *Renderer::GetProgramCache()
+    {
+        return s_Data ? s_Data->programCache.get() : nullptr;
+    }
+
+    TextureLoader *Renderer::GetTextureLoader()
+    {
+        return s_Data ? s_Data->textureLoader.get() : nullptr;
+    }
+
+    TextureStreamer *Renderer::GetTextureStreamer()
+    {
+        return s_Data ? s_Data->textureStreamer.get() : nullptr;
+    }
+
+    uint32_t Renderer::GetPendingShaderCount()
+    {
+        return s_Data ? s_Data->pendingShaders : 0;
     }
 
     std::shared_ptr<Texture2D> Renderer::GetWhiteTexture()
@@ -118,18 +206,31 @@ namespace flex
 	Ref<Shader> Renderer::CreateShaderFromFile(const std::vector<ShaderData>& shaders, const std::string& name)
 	{
         // Get loaded shader
-        if (Ref<Shader> existingShader = GetShaderByName(name); existingShader)
+        if (auto it = s_Data->shaderCache.find(name); it != s_Data->shaderCache.end())
         {
-            return existingShader;
+            return it->second;
 		}
 
-        // Create new shader
+        // Submitted only, the program links while the caller keeps loading and is collected
+        // by PollShaders or on first use
 		Ref<Shader> shader = CreateRef<Shader>();
-		shader->CreateFromFile(shaders).Compile();
+		shader->CreateFromFile(shaders).CompileAsync();
 		s_Data->shaderCache[name] = shader;
         return shader;
 	}
 
+    Ref<ShaderVariants> Renderer::CreateShaderVariants(const std::vector<ShaderData>& shaders, const std::vector<std::string>& featureDefines, const std::string& name)
+    {
+        if (auto it = s_Data->variantCache.find(name); it != s_Data->variantCache.end())
+        {
+            return it->second;
+        }
+
+        Ref<ShaderVariants> variants = CreateRef<ShaderVariants>(shaders, featureDefines);
+        s_Data->variantCache[name] = variants;
+        return variants;
+    }
+
 	void Renderer::RegisterShader(const Ref<Shader>& shader, const std::string& name)
 	{
         if (shader && !s_Data->shaderCache.contains(name))
@@ -138,11 +239,32 @@ namespace flex
         }
 	}
 
-	Ref<Shader> Renderer::GetShaderByName(const std::string& name)
+	Ref<Shader> Renderer::GetShaderByName(const std::string& name, const Ref<Shader>& fallback)
 	{
-        if (s_Data->shaderCache.contains(name))
-			return s_Data->shaderCache[name];
-		return nullptr;
+        auto it = s_Data->shaderCache.find(name);
+        if (it != s_Data->shaderCache.end() && it->second->Poll())
+        {
+            return it->second;
+        }
+		return fallback;
 	}
 
+    uint32_t Renderer::PollShaders()
+    {
+        uint32_t pending = 0;
+        for (auto &[name, shader] : s_Data->shaderCache)
+        {
+            if (!shader->Poll())
+            {
+                ++pending;
+            }
+        }
+
+        for (auto &[name, variants] : s_Data->variantCache)
+        {
+            pending += variants->Poll();
+        }
+        return pending;
+    }
+
 }
\ No newline at end of file
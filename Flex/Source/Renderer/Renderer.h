@@ -7,21 +7,52 @@
 #include "Shader.h"
 
 #include <string>
+#include <vector>
 
 namespace flex
 {
     class IndexBuffer;
     class VertexArray;
     class Texture2D;
+    class GeometryPool;
+    class StreamingBuffer;
+    class MaterialTable;
+    class TextureTable;
+    class ProgramCache;
+    class TextureLoader;
+    class TextureStreamer;
+    class ShaderVariants;
+    struct Mesh;
 
     class Renderer
     {
     public:
         static void Init();
         static void Shutdown();
+
+        // Call once per frame after presenting, recycles the streaming buffer region written this frame
+        // and rolls over the RenderState counters
+        static void EndFrame();
         
         static void Draw(std::shared_ptr<VertexArray> vertexArray, uint32_t count);
         static void DrawIndexed(std::shared_ptr<VertexArray> vertexArray, std::shared_ptr<IndexBuffer> indexBuffer = nullptr);
+        // Draws a single mesh out of the geometry pool
+        static void DrawMesh(const Mesh &mesh);
+
+        // Shared buffers every Mesh is allocated from, nullptr before Init or after Shutdown
+        static GeometryPool *GetGeometryPool();
+        // Per frame uniform, instance and draw command data
+        static StreamingBuffer *GetStreamingBuffer();
+        // Material::Params of every live material, indexed by Material::GetSlot
+        static MaterialTable *GetMaterialTable();
+        // Material texture references, bindless handles or texture array layers
+        static TextureTable *GetTextureTable();
+        // Linked program binaries from earlier runs
+        static ProgramCache *GetProgramCache();
+        // Background image decoding, uploads run in EndFrame
+        static TextureLoader *GetTextureLoader();
+        // Mip residency of block compressed textures under a VRAM budget, updated in EndFrame
+        static TextureStreamer *GetTextureStreamer();
 
         static std::shared_ptr<Texture2D> GetWhiteTexture();
         static std::shared_ptr<Texture2D> GetBlackTexture();
@@ -30,9 +61,18 @@ namespace flex
         // Flat normal texture (0.5,0.5,1.0) used as a neutral normal map fallback
         static std::shared_ptr<Texture2D> GetFlatNormalTexture();
 
+        // Returns at once, see Shader::CompileAsync
 		static Ref<Shader> CreateShaderFromFile(const std::vector<ShaderData> &shaders, const std::string& name);
         static void RegisterShader(const Ref<Shader> &shader, const std::string &name);
-		static Ref<Shader> GetShaderByName(const std::string& name);
+        // Feature keyed variants of an uber shader, cached by name next to the shaders
+        static Ref<ShaderVariants> CreateShaderVariants(const std::vector<ShaderData> &shaders, const std::vector<std::string> &featureDefines, const std::string &name);
+        // The named shader once its program is ready, fallback while it is still compiling or unknown
+		static Ref<Shader> GetShaderByName(const std::string& name, const Ref<Shader> &fallback = nullptr);
+        // Collects finished compiles without blocking, returns how many are still compiling.
+        // Called by EndFrame, loaders can call it between steps
+        static uint32_t PollShaders();
+        // Compiles still pending at the last EndFrame
+        static uint32_t GetPendingShaderCount();
     };
 }
 
@@ -5,12 +5,26 @@
 
 #include <glad/glad.h>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
+
+// GL_EXT_texture_compression_s3tc, not part of the bundled glad loader
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+    #define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+    #define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
 
 #define UNIFORM_BINDING_LOC_CAMERA 0
 #define UNIFORM_BINDING_LOC_SCENE 1
-#define UNIFORM_BINDING_LOC_MATERIAL 2
 #define UNIFORM_BINDING_LOC_CSM 3
 
+#define STORAGE_BINDING_LOC_INSTANCES 0
+#define STORAGE_BINDING_LOC_MATERIALS 1
+
+// Units 7 .. 7 + MAX_MATERIAL_TEXTURE_ARRAYS - 1, only used without bindless textures
+#define TEXTURE_BINDING_LOC_MATERIAL_ARRAYS 7
+#define MAX_MATERIAL_TEXTURE_ARRAYS 8
+
 namespace flex
 {
 
@@ -49,6 +63,12 @@ namespace flex
         LINEAR_MIPMAP_NEAREST,
     };
 
+    enum class IndexType
+    {
+        UINT16,
+        UINT32,
+    };
+
     enum class Format
     {
         R8,
@@ -61,8 +81,60 @@ namespace flex
         RGBA32F,
 
         DEPTH24STENCIL8,
+
+        // 4x4 texel blocks, encoded on the CPU by TextureCompressor
+        BC1, // RGB, 8 bytes per block
+        BC3, // RGBA, 16 bytes per block
+        BC5, // RG, 16 bytes per block, normal maps
+        BC7, // RGBA, 16 bytes per block
     };
 
+    static GLenum ToGLIndexType(IndexType type)
+    {
+        return type == IndexType::UINT16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    }
+
+    static uint32_t GetIndexTypeSize(IndexType type)
+    {
+        return type == IndexType::UINT16 ? 2 : 4;
+    }
+
+    static bool IsMipmapFilter(FilterMode filter)
+    {
+        return filter == FilterMode::LINEAR_MIPMAP_LINEAR || filter == FilterMode::LINEAR_MIPMAP_NEAREST;
+    }
+
+    static bool IsCompressedFormat(Format format)
+    {
+        return format == Format::BC1 || format == Format::BC3 || format == Format::BC5 || format == Format::BC7;
+    }
+
+    // Bytes per 4x4 block of a compressed format
+    static uint32_t GetFormatBlockSize(Format format)
+    {
+        assert(IsCompressedFormat(format));
+        return format == Format::BC1 ? 8 : 16;
+    }
+
+    // Bytes per texel, see GetFormatBlockSize for compressed formats
+    static uint32_t GetFormatSize(Format format)
+    {
+        switch (format)
+        {
+            case Format::R8: return 1;
+            case Format::RGB8: return 3;
+            case Format::RGB16F: return 6;
+            case Format::RGB32F: return 12;
+            case Format::RGBA8: return 4;
+            case Format::RGBA16F: return 8;
+            case Format::RGBA32F: return 16;
+            case Format::DEPTH24STENCIL8: return 4;
+            default:
+                assert(false);
+                return 0;
+        }
+    }
+
     static GLenum ToGLRasterizeFillMode(RasterizeFillMode mode)
     {
         switch (mode)
@@ -144,12 +216,33 @@ namespace flex
             case Format::RGBA32F: return GL_RGBA32F;
             
             case Format::DEPTH24STENCIL8: return GL_DEPTH24_STENCIL8;
+
+            case Format::BC1: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+            case Format::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            case Format::BC5: return GL_COMPRESSED_RG_RGTC2;
+            case Format::BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
             default:
                 assert(false);
                 return GL_INVALID_ENUM;
             break;
         }
     }
+
+    // For extensions the bundled glad loader doesn't know about
+    static bool HasGLExtension(const char *name)
+    {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; ++i)
+        {
+            const char *extension = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, i));
+            if (extension && std::strcmp(extension, name) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
 }
 
 #endif
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "SSAO.h"
 
 #include "Renderer.h"
+#include "RenderState.h"
 
 #include <glad/glad.h>
 #include <random>
@@ -75,13 +76,15 @@ namespace flex
             // Accelerate samples near origin
             scale = glm::mix(0.1f, 1.0f, scale * scale);
             sample *= scale;
-            m_Kernel.push_back(glm::vec4(sample, 0.0f));
+            m_Kernel.push_back(sample);
         }
+
+        m_KernelDirty = true;
     }
 
     void SSAO::BuildNoise()
     {
-        if (m_NoiseTex) glDeleteTextures(1, &m_NoiseTex);
+        if (m_NoiseTex) RenderState::DeleteTexture(m_NoiseTex);
         std::uniform_real_distribution<float> dist(0.0f, 1.0f);
         std::default_random_engine rng;
         std::vector<glm::vec3> noise; noise.reserve(16);
@@ -94,12 +97,12 @@ namespace flex
             );
         }
         glCreateTextures(GL_TEXTURE_2D, 1, &m_NoiseTex);
-        glBindTexture(GL_TEXTURE_2D, m_NoiseTex);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, 4, 4, 0, GL_RGB, GL_FLOAT, noise.data());
+        glTextureParameteri(m_NoiseTex, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTextureParameteri(m_NoiseTex, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTextureParameteri(m_NoiseTex, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTextureParameteri(m_NoiseTex, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTextureStorage2D(m_NoiseTex, 1, GL_RGB16F, 4, 4);
+        glTextureSubImage2D(m_NoiseTex, 0, 0, 0, 4, 4, GL_RGB, GL_FLOAT, noise.data());
     }
 
     void SSAO::Generate(uint32_t depthTex, const glm::mat4 &proj, float radius, float bias, float power)
@@ -112,13 +115,13 @@ namespace flex
         // step 1 raw AO
         Viewport vp{0,0,(uint32_t)m_Width,(uint32_t)m_Height};
         m_AOFB->Bind(vp);
-        glDisable(GL_DEPTH_TEST);
-        glDisable(GL_CULL_FACE);
-        glBindVertexArray(m_Vao);
+        RenderState::SetEnabled(GL_DEPTH_TEST, false);
+        RenderState::SetEnabled(GL_CULL_FACE, false);
+        RenderState::BindVertexArray(m_Vao);
         glClearColor(1,1,1,1); glClear(GL_COLOR_BUFFER_BIT);
         m_AOShader->Use();
-        glBindTextureUnit(0, depthTex); // sampler2D u_Depth
-        glBindTextureUnit(1, m_NoiseTex);
+        RenderState::BindTextureUnit(0, depthTex); // sampler2D u_Depth
+        RenderState::BindTextureUnit(1, m_NoiseTex);
         m_AOShader->SetUniform("u_Depth", 0);
         m_AOShader->SetUniform("u_Noise", 1);
         m_AOShader->SetUniform("u_Radius", radius);
@@ -127,9 +130,11 @@ namespace flex
         glm::mat4 invProj = glm::inverse(proj);
         m_AOShader->SetUniform("u_Projection", proj);
         m_AOShader->SetUniform("u_ProjectionInv", invProj);
-        for (int i=0;i<32;++i)
+        if (m_KernelDirty)
         {
-            m_AOShader->SetUniform(("u_Samples["+std::to_string(i)+"]").c_str(), glm::vec3(m_Kernel[i]));
+            // The kernel never changes, it stays in the program's uniform storage
+            m_AOShader->SetUniformArray("u_Samples", m_Kernel.data(), static_cast<int>(m_Kernel.size()));
+            m_KernelDirty = false;
         }
         glDrawArrays(GL_TRIANGLES,0,3);
 
@@ -137,9 +142,9 @@ namespace flex
         m_BlurFB->Bind(vp);
         glClear(GL_COLOR_BUFFER_BIT);
         m_BlurShader->Use();
-        glBindTextureUnit(0, m_AOFB->GetColorAttachment(0));
+        RenderState::BindTextureUnit(0, m_AOFB->GetColorAttachment(0));
         m_BlurShader->SetUniform("u_Src",0);
-        glBindVertexArray(m_Vao);
+        RenderState::BindVertexArray(m_Vao);
         glDrawArrays(GL_TRIANGLES,0,3);
     }
 }
@@ -35,7 +35,8 @@ namespace flex
         Ref<Shader> m_AOShader;
         Ref<Shader> m_BlurShader;
 
-        std::vector<glm::vec4> m_Kernel; // 4D to keep std140 alignment simple when uploading manually if needed
+        std::vector<glm::vec3> m_Kernel;
+        bool m_KernelDirty = false; // Uploaded on the next Generate, once the program is linked
         uint32_t m_NoiseTex = 0;
         uint32_t m_Vao = 0; // fullscreen triangle VAO
         int m_Width = 0;
@@ -1,6 +1,10 @@
 // Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
 
 #include "Shader.h"
+#include "RenderState.h"
+#include "Renderer.h"
+#include "ProgramCache.h"
+#include "RendererCommon.h"
 
 #include <sstream>
 #include <fstream>
@@ -8,8 +12,10 @@
 #include <cassert>
 #include <csignal>
 #include <filesystem>
+#include <algorithm>
 
 #include <glm/gtc/type_ptr.hpp>
+#include <SDL3/SDL_video.h>
 
 namespace flex
 {
@@ -24,22 +30,50 @@ namespace flex
         }
     }
 
+    // Not in the bundled glad loader, same value for the KHR and ARB extensions
+#ifndef GL_COMPLETION_STATUS_KHR
+    #define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+    using PFNMaxShaderCompilerThreads = void (APIENTRY *)(GLuint count);
+    static bool s_ParallelCompile = false;
+
+    static bool IsFloatType(GLenum type)
+    {
+        switch (type)
+        {
+            case GL_FLOAT:
+            case GL_FLOAT_VEC2:
+            case GL_FLOAT_VEC3:
+            case GL_FLOAT_VEC4:
+            case GL_FLOAT_MAT2:
+            case GL_FLOAT_MAT3:
+            case GL_FLOAT_MAT4:
+                return true;
+            default:
+                return false;
+        }
+    }
+
     Shader::Shader()
         : m_Program(0)
     {
     }
 
-    Shader &Shader::CreateFromFile(const std::vector<ShaderData> &shaders)
+    Shader &Shader::CreateFromFile(const std::vector<ShaderData> &shaders, const std::vector<std::string> &defines)
     {
-        m_Shaders.clear();
-
         m_Shaders = shaders;
-        for (auto &shaderData : m_Shaders)
+        m_Defines = defines;
+        m_FromFile = true;
+
+        m_Sources.clear();
+        for (const ShaderData &shaderData : m_Shaders)
         {
-            if (!CompileShader(&shaderData))
+            if (!ReadSource(shaderData.str, m_Sources.emplace_back()))
             {
                 assert(false);
             }
+            InjectDefines(m_Sources.back(), m_Defines);
 		}
 
         return *this;
@@ -47,254 +81,455 @@ namespace flex
 
     Shader &Shader::CreateFromSource(const std::vector<ShaderData>& shaders)
     {
-		m_Shaders.clear();
         m_Shaders = shaders;
+        m_FromFile = false;
 
-        for (auto &shaderData : m_Shaders)
+        m_Sources.clear();
+        for (const ShaderData &shaderData : m_Shaders)
         {
-            if (!CompileShaderFromString(&shaderData, shaderData.str))
-            {
-                assert(false);
-			}
-        } 
+            m_Sources.push_back(shaderData.str);
+        }
 
         return *this;
     }
 
     Shader &Shader::Compile()
     {
-        GLuint program = glCreateProgram();
+        CompileAsync();
+        Wait();
+        return *this;
+    }
 
-        for (auto &[filepath, type, shader] : m_Shaders)
+    Shader &Shader::CompileAsync()
+    {
+        if (m_Program != 0)
         {
-            glAttachShader(program, shader);
+            RenderState::DeleteProgram(m_Program);
+            m_Program = 0;
         }
 
-        glLinkProgram(program);
-
-        int status = GL_FALSE;
-        glGetProgramiv(program, GL_LINK_STATUS, &status);
-
-        if (status == GL_FALSE)
+        // A cached binary skips both compiling and linking
+        ProgramCache *cache = Renderer::GetProgramCache();
+        const bool useCache = cache && cache->IsEnabled();
+        if (useCache)
         {
-            std::cerr << "Failed to link shader program\n";
+            m_CacheKey = cache->BeginKey();
+            for (size_t i = 0; i < m_Shaders.size(); ++i)
+            {
+                m_CacheKey = ProgramCache::AppendKey(m_CacheKey, m_Shaders[i].type, m_Sources[i]);
+            }
 
-            int logSize = 0;
-            glGetProgramiv(program, GL_INFO_LOG_LENGTH, &logSize);
-            std::vector<char> messageLog(logSize);
-            glGetProgramInfoLog(program, logSize, &logSize, messageLog.data());
-            std::cerr << messageLog.data() << '\n';;
+            if (const uint32_t program = cache->Load(m_CacheKey))
+            {
+                m_Program = program;
+                m_Status = Status::Ready;
+                Reflect();
+                std::cout << "Shader program loaded from cache: \"" << GetName() << "\"\n";
+                return *this;
+            }
+        }
 
-            glDeleteProgram(program);
+        // Nothing is queried here, any status query would wait for the driver
+        for (size_t i = 0; i < m_Shaders.size(); ++i)
+        {
+            const char *shaderCode = m_Sources[i].c_str();
+            m_Shaders[i].shader = glCreateShader(m_Shaders[i].type);
+            glShaderSource(m_Shaders[i].shader, 1, &shaderCode, nullptr);
+            glCompileShader(m_Shaders[i].shader);
+        }
 
-            std::exit(EXIT_FAILURE);
+        m_Program = glCreateProgram();
+        if (useCache)
+        {
+            glProgramParameteri(m_Program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
         }
 
         for (auto &[filepath, type, shader] : m_Shaders)
         {
-            glDeleteShader(shader);
+            glAttachShader(m_Program, shader);
         }
 
-        m_Program = program;
-
-		assert(glGetError() == GL_NO_ERROR);
+        glLinkProgram(m_Program);
+        m_Status = Status::Compiling;
 
         return *this;
     }
 
-    bool Shader::CompileShader(ShaderData *shaderData)
+    bool Shader::Poll()
     {
-        if (const bool fileExists = std::filesystem::exists(shaderData->str); !fileExists)
+        if (m_Status != Status::Compiling)
         {
-            assert(fileExists && "Shader file does not exists!");
+            return IsReady();
         }
 
-        std::ifstream shaderFile(shaderData->str);
-        std::stringstream stream;
-        stream << shaderFile.rdbuf();
-        std::string sourceStr = stream.str();
-        const char *shaderCode = sourceStr.c_str();
-
-        uint32_t shader = glCreateShader(shaderData->type);
-        glShaderSource(shader, 1, &shaderCode, nullptr);
-
-        // Compile shader and get compile status
-        glCompileShader(shader);
-        int status = GL_FALSE;
+        // Without the extension the driver compiles on this thread anyway, finishing here behaves like Compile
+        GLint completed = GL_TRUE;
+        if (s_ParallelCompile)
+        {
+            glGetProgramiv(m_Program, GL_COMPLETION_STATUS_KHR, &completed);
+        }
+        if (completed == GL_TRUE)
+        {
+            Finish();
+        }
 
-        glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+        return IsReady();
+    }
 
-        // Failed to compile shader
-        if (status == GL_FALSE)
+    void Shader::Wait()
+    {
+        if (m_Status == Status::Compiling)
         {
-            std::cerr << "Failed to compile " << GetShaderStageString(shaderData->type) << " \"" << shaderData->str <<"\"\n";
-
-            // Get shader info log
-            int logSize = 0;
-            glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logSize);
-            std::vector<char> messageLog(logSize);
-            glGetShaderInfoLog(shader, logSize, &logSize, messageLog.data());
-            std::cerr << messageLog.data() << '\n';;
+            Finish();
+        }
+    }
 
-            glDeleteShader(shader);
+    bool Shader::EnableParallelCompile()
+    {
+        const char *function = nullptr;
+        if (HasGLExtension("GL_KHR_parallel_shader_compile"))
+        {
+            function = "glMaxShaderCompilerThreadsKHR";
+        }
+        else if (HasGLExtension("GL_ARB_parallel_shader_compile"))
+        {
+            function = "glMaxShaderCompilerThreadsARB";
+        }
 
+        const auto maxShaderCompilerThreads = function
+            ? reinterpret_cast<PFNMaxShaderCompilerThreads>(SDL_GL_GetProcAddress(function))
+            : nullptr;
+        if (!maxShaderCompilerThreads)
+        {
+            std::cout << "Parallel shader compile not supported, programs link when first polled\n";
             return false;
         }
 
-        shaderData->shader = shader;
-        
-        std::cout << "Shader " << GetShaderStageString(shaderData->type) << " Success to compile: \"" << shaderData->str << '\n';
+        // Let the driver pick the thread count
+        maxShaderCompilerThreads(0xFFFFFFFFu);
+        s_ParallelCompile = true;
         return true;
     }
 
-    bool Shader::CompileShaderFromString(ShaderData *shaderData, const std::string &source)
+    void Shader::Finish()
     {
-        const char *shaderCode = source.c_str();
+        int status = GL_FALSE;
+        glGetProgramiv(m_Program, GL_LINK_STATUS, &status);
 
-        uint32_t shader = glCreateShader(shaderData->type);
-        glShaderSource(shader, 1, &shaderCode, nullptr);
+        if (status == GL_FALSE)
+        {
+            ReportErrors(m_Program);
+            RenderState::DeleteProgram(m_Program);
 
-        // Compile shader and get compile status
-        glCompileShader(shader);
-        int status = GL_FALSE;
+            std::exit(EXIT_FAILURE);
+        }
 
-        glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+        for (auto &[filepath, type, shader] : m_Shaders)
+        {
+            glDetachShader(m_Program, shader);
+            glDeleteShader(shader);
+            shader = 0;
+        }
 
-        // Failed to compile shader
-        if (status == GL_FALSE)
+        if (ProgramCache *cache = Renderer::GetProgramCache(); cache && cache->IsEnabled())
         {
-            std::cerr << "Failed to compile " << GetShaderStageString(shaderData->type) << " from string\n";
+            cache->Store(m_CacheKey, m_Program);
+        }
+
+        m_Status = Status::Ready;
+        Reflect();
+
+        std::cout << "Shader program linked: \"" << GetName() << "\"\n";
+
+		assert(glGetError() == GL_NO_ERROR);
+    }
+
+    void Shader::ReportErrors(uint32_t program) const
+    {
+        for (const ShaderData &shaderData : m_Shaders)
+        {
+            int status = GL_FALSE;
+            glGetShaderiv(shaderData.shader, GL_COMPILE_STATUS, &status);
+            if (status == GL_TRUE)
+            {
+                continue;
+            }
+
+            std::cerr << "Failed to compile " << GetShaderStageString(shaderData.type) << " \""
+                << (m_FromFile ? shaderData.str : "from string") << "\"\n";
 
             // Get shader info log
             int logSize = 0;
-            glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logSize);
+            glGetShaderiv(shaderData.shader, GL_INFO_LOG_LENGTH, &logSize);
             std::vector<char> messageLog(logSize);
-            glGetShaderInfoLog(shader, logSize, &logSize, messageLog.data());
-            std::cerr << messageLog.data() << '\n';;
+            glGetShaderInfoLog(shaderData.shader, logSize, &logSize, messageLog.data());
+            std::cerr << messageLog.data() << '\n';
+        }
 
-            glDeleteShader(shader);
+        std::cerr << "Failed to link shader program\n";
+
+        int logSize = 0;
+        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &logSize);
+        std::vector<char> messageLog(logSize);
+        glGetProgramInfoLog(program, logSize, &logSize, messageLog.data());
+        std::cerr << messageLog.data() << '\n';
+    }
 
-            assert(false);
+    bool Shader::ReadSource(const std::string &filepath, std::string &source)
+    {
+        if (const bool fileExists = std::filesystem::exists(filepath); !fileExists)
+        {
+            assert(fileExists && "Shader file does not exists!");
             return false;
         }
 
-        shaderData->shader = shader;
-        
-        std::cout << "Shader " << GetShaderStageString(shaderData->type) << " Success to compile from string\n";
+        std::ifstream shaderFile(filepath);
+        std::stringstream stream;
+        stream << shaderFile.rdbuf();
+        source = stream.str();
         return true;
     }
 
-    void Shader::Reload()
+    void Shader::InjectDefines(std::string &source, const std::vector<std::string> &defines)
     {
-        bool success = true;
-        for (auto &[filepath, shader, type] : m_Shaders)
-        {
-            ShaderData shaderData;
-            shaderData.type = type;
-            shaderData.str = filepath;
-            
-            if (!CompileShader(&shaderData))
+        if (defines.empty())
+        {
+            return;
+        }
+
+        // #version has to stay the first directive
+        size_t insertAt = 0;
+        std::string block;
+        if (const size_t version = source.find("#version"); version != std::string::npos)
+        {
+            const size_t lineEnd = source.find('\n', version);
+            if (lineEnd == std::string::npos)
+            {
+                insertAt = source.size();
+                block = '\n';
+            }
+            else
             {
-                success = false;
-                break;
+                insertAt = lineEnd + 1;
             }
+        }
+
+        for (const std::string &define : defines)
+        {
+            block += "#define " + define + '\n';
+        }
+        source.insert(insertAt, block);
+    }
 
-            shader = shaderData.shader;
+    void Shader::Reload()
+    {
+        if (!m_FromFile)
+        {
+            return;
         }
 
-        if (success)
+        std::vector<std::string> sources;
+        for (const ShaderData &shaderData : m_Shaders)
         {
-            Compile();
+            if (!ReadSource(shaderData.str, sources.emplace_back()))
+            {
+                return;
+            }
         }
+
+        for (std::string &source : sources)
+        {
+            InjectDefines(source, m_Defines);
+        }
+
+        m_Sources = std::move(sources);
+        Compile();
     }
 
     void Shader::Use()
     {
-        glUseProgram(m_Program);
+        Wait();
+        RenderState::UseProgram(m_Program);
     }
 
     void Shader::Use(uint32_t program)
     {
         if (glIsProgram(program))
-            glUseProgram(program);
+            RenderState::UseProgram(program);
     }
 
-    void Shader::SetUniform(std::string_view name, int value)
+    int Shader::GetUniformBlockBinding(UniformName name)
     {
-        int location = GetUniformLocation(name);
-        if (location != -1)
+        Wait();
+        auto it = std::lower_bound(m_UniformBlocks.begin(), m_UniformBlocks.end(), name.hash,
+            [](const UniformBlockInfo &block, uint64_t hash) { return block.hash < hash; });
+        return it != m_UniformBlocks.end() && it->hash == name.hash ? it->binding : -1;
+    }
+
+    void Shader::SetUniform(UniformHandle<int> uniform, int value)
+    {
+        if (uniform.IsValid())
         {
-            glUniform1i(location, value);
+            glProgramUniform1i(m_Program, uniform.location, value);
         }
     }
 
-    void Shader::SetUniform(std::string_view name, float value)
+    void Shader::SetUniform(UniformHandle<float> uniform, float value)
     {
-        int location = GetUniformLocation(name);
-        if (location != -1)
+        if (uniform.IsValid())
         {
-            glUniform1f(location, value);
+            glProgramUniform1f(m_Program, uniform.location, value);
         }
     }
 
-    void Shader::SetUniform(std::string_view name, const glm::vec3 &vec)
+    void Shader::SetUniform(UniformHandle<glm::vec2> uniform, const glm::vec2 &vec)
     {
-        int location = GetUniformLocation(name);
-        if (location != -1)
+        if (uniform.IsValid())
         {
-            glUniform3f(location, vec.x, vec.y, vec.z);
+            glProgramUniform2f(m_Program, uniform.location, vec.x, vec.y);
         }
     }
 
-    void Shader::SetUniform(std::string_view name, const glm::vec4 &vec)
+    void Shader::SetUniform(UniformHandle<glm::vec3> uniform, const glm::vec3 &vec)
     {
-        int location = GetUniformLocation(name);
-        if (location != -1)
+        if (uniform.IsValid())
         {
-            glUniform4f(location, vec.x, vec.y, vec.z, vec.w);
+            glProgramUniform3f(m_Program, uniform.location, vec.x, vec.y, vec.z);
         }
     }
 
-    void Shader::SetUniform(std::string_view name, const glm::mat3 &mat)
+    void Shader::SetUniform(UniformHandle<glm::vec4> uniform, const glm::vec4 &vec)
     {
-        int location = GetUniformLocation(name);
-        if (location != -1)
+        if (uniform.IsValid())
+        {
+            glProgramUniform4f(m_Program, uniform.location, vec.x, vec.y, vec.z, vec.w);
+        }
+    }
+
+    void Shader::SetUniform(UniformHandle<glm::mat3> uniform, const glm::mat3 &mat)
+    {
+        if (uniform.IsValid())
+        {
+            glProgramUniformMatrix3fv(m_Program, uniform.location, 1, GL_FALSE, glm::value_ptr(mat));
+        }
+    }
+
+    void Shader::SetUniform(UniformHandle<glm::mat4> uniform, const glm::mat4 &mat)
+    {
+        if (uniform.IsValid())
         {
-            glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+            glProgramUniformMatrix4fv(m_Program, uniform.location, 1, GL_FALSE, glm::value_ptr(mat));
         }
     }
 
-    void Shader::SetUniform(std::string_view name, const glm::mat4 &mat)
+    void Shader::SetUniformArray(UniformName name, const int *values, int count)
     {
-        int location = GetUniformLocation(name);
+        const int location = FindUniformLocation(name, GL_INT);
         if (location != -1)
         {
-            glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+            glProgramUniform1iv(m_Program, location, count, values);
         }
     }
 
-    void Shader::SetUniformArray(std::string_view name, int *value, int count)
+    void Shader::SetUniformArray(UniformName name, const glm::vec3 *values, int count)
     {
-        int location = GetUniformLocation(name);
+        const int location = FindUniformLocation(name, GL_FLOAT_VEC3);
         if (location != -1)
         {
-            glUniform1iv(location, count, value);
+            glProgramUniform3fv(m_Program, location, count, glm::value_ptr(values[0]));
         }
     }
 
-    int Shader::GetUniformLocation(const std::string_view name)
+    void Shader::Reflect()
     {
-        auto it = m_UniformLocations.find(name);
-        if (it != m_UniformLocations.end())
-            return it->second;
+        m_Uniforms.clear();
+        m_UniformBlocks.clear();
+        m_ReportedUniforms.clear();
+
+        GLint maxNameLength = 0;
+        glGetProgramInterfaceiv(m_Program, GL_UNIFORM, GL_MAX_NAME_LENGTH, &maxNameLength);
+        GLint maxBlockNameLength = 0;
+        glGetProgramInterfaceiv(m_Program, GL_UNIFORM_BLOCK, GL_MAX_NAME_LENGTH, &maxBlockNameLength);
+        std::string name(static_cast<size_t>(std::max(maxNameLength, maxBlockNameLength)), '\0');
+
+        GLint uniformCount = 0;
+        glGetProgramInterfaceiv(m_Program, GL_UNIFORM, GL_ACTIVE_RESOURCES, &uniformCount);
+        m_Uniforms.reserve(static_cast<size_t>(uniformCount));
+
+        const GLenum uniformProps[] = { GL_BLOCK_INDEX, GL_LOCATION, GL_TYPE, GL_ARRAY_SIZE };
+        for (GLint i = 0; i < uniformCount; ++i)
+        {
+            GLint values[4] = {};
+            glGetProgramResourceiv(m_Program, GL_UNIFORM, i, 4, uniformProps, 4, nullptr, values);
+
+            // Block members are reached through their buffer
+            if (values[0] != -1 || values[1] == -1)
+            {
+                continue;
+            }
+
+            GLsizei length = 0;
+            glGetProgramResourceName(m_Program, GL_UNIFORM, i, static_cast<GLsizei>(name.size()), &length, name.data());
 
-        int location = glGetUniformLocation(m_Program, name.data());
-        if (location == -1)
+            // Arrays are reported as "name[0]", callers use the plain name
+            std::string_view uniformName(name.data(), static_cast<size_t>(length));
+            if (uniformName.ends_with("[0]"))
+            {
+                uniformName.remove_suffix(3);
+            }
+
+            m_Uniforms.push_back({ HashUniformName(uniformName), values[1], static_cast<GLenum>(values[2]), values[3] });
+        }
+
+        GLint blockCount = 0;
+        glGetProgramInterfaceiv(m_Program, GL_UNIFORM_BLOCK, GL_ACTIVE_RESOURCES, &blockCount);
+        m_UniformBlocks.reserve(static_cast<size_t>(blockCount));
+
+        const GLenum blockProps[] = { GL_BUFFER_BINDING };
+        for (GLint i = 0; i < blockCount; ++i)
         {
-            std::cerr << "Warning: Uniform '" << name << "' not found in shader program.\n";
+            GLint binding = 0;
+            glGetProgramResourceiv(m_Program, GL_UNIFORM_BLOCK, i, 1, blockProps, 1, nullptr, &binding);
+
+            GLsizei length = 0;
+            glGetProgramResourceName(m_Program, GL_UNIFORM_BLOCK, i, static_cast<GLsizei>(name.size()), &length, name.data());
+            m_UniformBlocks.push_back({ HashUniformName(std::string_view(name.data(), static_cast<size_t>(length))), binding });
         }
-        
-        m_UniformLocations[name] = location;
-        return location;
+
+        std::sort(m_Uniforms.begin(), m_Uniforms.end(), [](const UniformInfo &a, const UniformInfo &b) { return a.hash < b.hash; });
+        std::sort(m_UniformBlocks.begin(), m_UniformBlocks.end(), [](const UniformBlockInfo &a, const UniformBlockInfo &b) { return a.hash < b.hash; });
+        assert(std::adjacent_find(m_Uniforms.begin(), m_Uniforms.end(),
+            [](const UniformInfo &a, const UniformInfo &b) { return a.hash == b.hash; }) == m_Uniforms.end() && "Uniform name hash collision!");
+    }
+
+    int Shader::FindUniformLocation(UniformName name, GLenum type)
+    {
+        Wait();
+        auto it = std::lower_bound(m_Uniforms.begin(), m_Uniforms.end(), name.hash,
+            [](const UniformInfo &uniform, uint64_t hash) { return uniform.hash < hash; });
+
+        const bool found = it != m_Uniforms.end() && it->hash == name.hash;
+        // Samplers, images and bools are set as int
+        const bool typeMatches = found && (it->type == type || (type == GL_INT && !IsFloatType(it->type)));
+        if (typeMatches)
+        {
+            return it->location;
+        }
+
+        // Optimized out uniforms are common while editing shaders, say it once instead of every frame
+        if (std::find(m_ReportedUniforms.begin(), m_ReportedUniforms.end(), name.hash) == m_ReportedUniforms.end())
+        {
+            m_ReportedUniforms.push_back(name.hash);
+            if (found)
+            {
+                std::cerr << "Warning: Uniform '" << name.name << "' type does not match the value set.\n";
+            }
+            else
+            {
+                std::cerr << "Warning: Uniform '" << name.name << "' not found in shader program.\n";
+            }
+        }
+
+        return -1;
     }
 }
\ No newline at end of file
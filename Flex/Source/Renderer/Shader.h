@@ -7,7 +7,7 @@
 #include <cstdint>
 #include <vector>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 
 #include <glm/glm.hpp>
 
@@ -20,37 +20,161 @@ namespace flex
         uint32_t shader = 0;
     };
 
+    // FNV-1a, names hashed at compile time match the ones reflected at link time
+    constexpr uint64_t HashUniformName(std::string_view name)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (char c : name)
+        {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // A uniform name hashed at compile time, built implicitly from string literals
+    struct UniformName
+    {
+        consteval UniformName(const char *literal)
+            : hash(HashUniformName(literal)), name(literal)
+        {
+        }
+
+        uint64_t hash;
+        const char *name; // Only read for diagnostics
+    };
+
+    // Location of a uniform resolved once with Shader::GetUniform, valid until the program is relinked
+    template<typename T>
+    struct UniformHandle
+    {
+        int location = -1;
+
+        bool IsValid() const { return location != -1; }
+    };
+
+    template<typename T> struct UniformGLType;
+    template<> struct UniformGLType<int> { static constexpr GLenum value = GL_INT; }; // Also bools and samplers
+    template<> struct UniformGLType<float> { static constexpr GLenum value = GL_FLOAT; };
+    template<> struct UniformGLType<glm::vec2> { static constexpr GLenum value = GL_FLOAT_VEC2; };
+    template<> struct UniformGLType<glm::vec3> { static constexpr GLenum value = GL_FLOAT_VEC3; };
+    template<> struct UniformGLType<glm::vec4> { static constexpr GLenum value = GL_FLOAT_VEC4; };
+    template<> struct UniformGLType<glm::mat3> { static constexpr GLenum value = GL_FLOAT_MAT3; };
+    template<> struct UniformGLType<glm::mat4> { static constexpr GLenum value = GL_FLOAT_MAT4; };
+
     class Shader
     {
     public:
         Shader();
 
-        Shader &CreateFromFile(const std::vector<ShaderData> &shaders);
+        // Each define is added to every stage as "#define <define>" right after #version
+        Shader &CreateFromFile(const std::vector<ShaderData> &shaders, const std::vector<std::string> &defines = {});
         Shader &CreateFromSource(const std::vector<ShaderData> &shaders);
+        // Loads the linked program from the ProgramCache when it has one for these sources,
+        // otherwise compiles and links, then stores the result
         Shader &Compile();
+        // Same as Compile without waiting for the driver: every stage and the link are submitted and
+        // the result is collected by Poll, or by Wait on first use
+        Shader &CompileAsync();
+        // Collects a finished compile without blocking, true once the program is ready.
+        // Without parallel compile support (EnableParallelCompile) it finishes the compile, blocking like Wait
+        bool Poll();
+        // Blocks until the program is linked, exits on compile or link errors like Compile
+        void Wait();
+        bool IsReady() const { return m_Status == Status::Ready; }
         void Reload();
 
+        // Lets the driver compile on its own threads (GL_KHR_parallel_shader_compile), false when unsupported
+        static bool EnableParallelCompile();
+
+        // Valid as soon as the compile is submitted
         uint32_t GetProgram() const { return m_Program; }
         void Use();
         static void Use(uint32_t program);
 
-        void SetUniform(std::string_view name, int value);
-        void SetUniform(std::string_view name, float value);
-        void SetUniform(std::string_view name, const glm::vec3 &vec);
-        void SetUniform(std::string_view name, const glm::vec4 &vec);
-        void SetUniform(std::string_view name, const glm::mat3 &mat);
-        void SetUniform(std::string_view name, const glm::mat4 &mat);
+        // Resolves a reflected uniform once, hot paths then set it through the handle.
+        // Arrays resolve to their first element by the plain name
+        template<typename T>
+        UniformHandle<T> GetUniform(UniformName name)
+        {
+            return { FindUniformLocation(name, UniformGLType<T>::value) };
+        }
+
+        // Binding point of a reflected uniform block, -1 when the program has no such block
+        int GetUniformBlockBinding(UniformName name);
+
+        // Uniforms are set on this program directly, it doesn't have to be in use
+        void SetUniform(UniformHandle<int> uniform, int value);
+        void SetUniform(UniformHandle<float> uniform, float value);
+        void SetUniform(UniformHandle<glm::vec2> uniform, const glm::vec2 &vec);
+        void SetUniform(UniformHandle<glm::vec3> uniform, const glm::vec3 &vec);
+        void SetUniform(UniformHandle<glm::vec4> uniform, const glm::vec4 &vec);
+        void SetUniform(UniformHandle<glm::mat3> uniform, const glm::mat3 &mat);
+        void SetUniform(UniformHandle<glm::mat4> uniform, const glm::mat4 &mat);
+
+        // By name, a binary search over the reflected hashes
+        void SetUniform(UniformName name, int value) { SetUniform(GetUniform<int>(name), value); }
+        void SetUniform(UniformName name, float value) { SetUniform(GetUniform<float>(name), value); }
+        void SetUniform(UniformName name, const glm::vec2 &vec) { SetUniform(GetUniform<glm::vec2>(name), vec); }
+        void SetUniform(UniformName name, const glm::vec3 &vec) { SetUniform(GetUniform<glm::vec3>(name), vec); }
+        void SetUniform(UniformName name, const glm::vec4 &vec) { SetUniform(GetUniform<glm::vec4>(name), vec); }
+        void SetUniform(UniformName name, const glm::mat3 &mat) { SetUniform(GetUniform<glm::mat3>(name), mat); }
+        void SetUniform(UniformName name, const glm::mat4 &mat) { SetUniform(GetUniform<glm::mat4>(name), mat); }
 
-        void SetUniformArray(std::string_view name, int *value, int count);
+        void SetUniformArray(UniformName name, const int *values, int count);
+        void SetUniformArray(UniformName name, const glm::vec3 *values, int count);
 
     private:
-        bool CompileShader(ShaderData *shaderData);
-        bool CompileShaderFromString(ShaderData *shaderData, const std::string &source);
-        int GetUniformLocation(const std::string_view name);
+        struct UniformInfo
+        {
+            uint64_t hash;
+            int location;
+            GLenum type;
+            int arraySize;
+        };
+
+        struct UniformBlockInfo
+        {
+            uint64_t hash;
+            int binding;
+        };
+
+        enum class Status : uint8_t
+        {
+            Empty,
+            Compiling,
+            Ready
+        };
+
+        static bool ReadSource(const std::string &filepath, std::string &source);
+        static void InjectDefines(std::string &source, const std::vector<std::string> &defines);
+        // First stage's file, for logs
+        std::string_view GetName() const
+        {
+            if (m_FromFile && !m_Shaders.empty())
+            {
+                return m_Shaders.front().str;
+            }
+            return "from string";
+        }
+        // Exits with the stage and link logs when the submitted program failed
+        void Finish();
+        void ReportErrors(uint32_t program) const;
+        void Reflect();
+        int FindUniformLocation(UniformName name, GLenum type);
 
         uint32_t m_Program;
+        Status m_Status = Status::Empty;
+        uint64_t m_CacheKey = 0;
         std::vector<ShaderData> m_Shaders;
-        std::unordered_map<std::string_view, int> m_UniformLocations;
+        std::vector<std::string> m_Sources; // Per stage, hashed into the program cache key
+        std::vector<std::string> m_Defines;
+        bool m_FromFile = false;
+
+        // Sorted by hash
+        std::vector<UniformInfo> m_Uniforms;
+        std::vector<UniformBlockInfo> m_UniformBlocks;
+        mutable std::vector<uint64_t> m_ReportedUniforms; // Warned about once each
     };
 }
 
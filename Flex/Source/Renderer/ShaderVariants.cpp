@@ -0,0 +1,95 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#include "ShaderVariants.h"
+
+#include <bit>
+#include <cassert>
+
+namespace flex
+{
+    ShaderVariants::ShaderVariants(const std::vector<ShaderData> &shaders, const std::vector<std::string> &featureDefines)
+        : m_Shaders(shaders), m_FeatureDefines(featureDefines)
+    {
+        // Every key has a slot, keep the feature count small
+        assert(featureDefines.size() <= 10 && "Too many shader features!");
+        m_Variants.resize(size_t(1) << featureDefines.size());
+
+        // Stand in for every other variant while they compile
+        Precompile(0);
+    }
+
+    Shader *ShaderVariants::Get(uint32_t features)
+    {
+        assert(features < m_Variants.size() && "Unknown shader feature bit!");
+
+        Shader &variant = Submit(features);
+        if (variant.Poll())
+        {
+            return &variant;
+        }
+
+        // Ready variant with the most of the requested features and none of the others
+        Shader *standIn = nullptr;
+        int standInBits = -1;
+        for (uint32_t key = 0; key < m_Variants.size(); ++key)
+        {
+            const Ref<Shader> &candidate = m_Variants[key];
+            const int bits = std::popcount(key);
+            if ((key & ~features) == 0 && bits > standInBits && candidate && candidate->IsReady())
+            {
+                standIn = candidate.get();
+                standInBits = bits;
+            }
+        }
+
+        if (standIn)
+        {
+            return standIn;
+        }
+
+        // Nothing has finished yet, only happens for the first frames
+        variant.Wait();
+        return &variant;
+    }
+
+    void ShaderVariants::Precompile(uint32_t features)
+    {
+        assert(features < m_Variants.size() && "Unknown shader feature bit!");
+        Submit(features);
+    }
+
+    Shader &ShaderVariants::Submit(uint32_t features)
+    {
+        Ref<Shader> &variant = m_Variants[features];
+        if (!variant)
+        {
+            std::vector<std::string> defines;
+            for (size_t bit = 0; bit < m_FeatureDefines.size(); ++bit)
+            {
+                if (features & (1u << bit))
+                {
+                    defines.push_back(m_FeatureDefines[bit]);
+                }
+            }
+
+            variant = CreateRef<Shader>();
+            variant->CreateFromFile(m_Shaders, defines).CompileAsync();
+            ++m_VariantCount;
+        }
+
+        return *variant;
+    }
+
+    uint32_t ShaderVariants::Poll()
+    {
+        uint32_t pending = 0;
+        for (const Ref<Shader> &variant : m_Variants)
+        {
+            if (variant && !variant->Poll())
+            {
+                ++pending;
+            }
+        }
+        return pending;
+    }
+}
@@ -0,0 +1,44 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#ifndef SHADER_VARIANTS_H
+#define SHADER_VARIANTS_H
+
+#include "Core/Types.h"
+#include "Shader.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace flex
+{
+    // Specialised programs of one uber shader, one per feature key. Bit i of the key compiles the variant
+    // with "#define featureDefines[i]", so disabled features are compiled out instead of branched over.
+    // Variants are submitted on their first Get, or up front with Precompile, and compile asynchronously like any
+    // other shader. The variant without features is submitted with the set
+    class ShaderVariants
+    {
+    public:
+        ShaderVariants(const std::vector<ShaderData> &shaders, const std::vector<std::string> &featureDefines);
+
+        // Indexed by the key, no hashing per draw. Until the variant is linked, the ready variant sharing most of its
+        // features stands in, so draws never wait on the driver. Only blocks when no variant has finished yet
+        Shader *Get(uint32_t features);
+        // Submits the variant without waiting, e.g. for feature combinations known at load time
+        void Precompile(uint32_t features);
+
+        // Collects finished variants without blocking, returns how many are still compiling
+        uint32_t Poll();
+        uint32_t GetVariantCount() const { return m_VariantCount; }
+
+    private:
+        Shader &Submit(uint32_t features);
+
+        std::vector<ShaderData> m_Shaders;
+        std::vector<std::string> m_FeatureDefines;
+        std::vector<Ref<Shader>> m_Variants;
+        uint32_t m_VariantCount = 0;
+    };
+}
+
+#endif
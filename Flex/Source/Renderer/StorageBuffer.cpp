@@ -0,0 +1,62 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#include "StorageBuffer.h"
+#include "RenderState.h"
+#include <glad/glad.h>
+
+#include <cassert>
+
+namespace flex
+{
+    StorageBuffer::StorageBuffer(size_t size, uint32_t index)
+        : m_BindIndex(index)
+    {
+        Allocate(size);
+    }
+
+    StorageBuffer::~StorageBuffer()
+    {
+        RenderState::DeleteBuffer(m_Handle);
+    }
+
+    void StorageBuffer::Allocate(size_t size)
+    {
+        if (m_Handle)
+        {
+            RenderState::DeleteBuffer(m_Handle);
+        }
+
+        m_Size = size;
+        glCreateBuffers(1, &m_Handle);
+        glNamedBufferData(m_Handle, m_Size, nullptr, GL_DYNAMIC_DRAW);
+        RenderState::BindBufferRange(GL_SHADER_STORAGE_BUFFER, m_BindIndex, m_Handle, 0, 0);
+
+        assert(m_Handle != 0 && "Failed to create Storage buffer!");
+    }
+
+    void StorageBuffer::SetData(const void *data, size_t size, size_t offset)
+    {
+        if (offset + size > m_Size)
+        {
+            // Grow geometrically so a rising instance count does not reallocate every frame
+            size_t newSize = m_Size ? m_Size : size;
+            while (newSize < offset + size)
+            {
+                newSize *= 2;
+            }
+            Allocate(newSize);
+        }
+
+        glNamedBufferSubData(m_Handle, offset, size, data);
+    }
+
+    void StorageBuffer::Bind()
+    {
+        RenderState::BindBufferRange(GL_SHADER_STORAGE_BUFFER, m_BindIndex, m_Handle, 0, 0);
+    }
+
+    std::shared_ptr<StorageBuffer> StorageBuffer::Create(size_t size, uint32_t index)
+    {
+        return std::make_shared<StorageBuffer>(size, index);
+    }
+}
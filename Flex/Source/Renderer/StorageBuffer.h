@@ -0,0 +1,36 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#ifndef STORAGE_BUFFER_H
+#define STORAGE_BUFFER_H
+
+#include <memory>
+#include <stdint.h>
+
+namespace flex
+{
+    // Shader storage buffer, grows when SetData writes past the current size
+    class StorageBuffer
+    {
+    public:
+        StorageBuffer(size_t size, uint32_t index);
+        ~StorageBuffer();
+
+        void SetData(const void *data, size_t size, size_t offset = 0);
+
+        void Bind();
+
+        size_t GetSize() const { return m_Size; }
+        uint32_t GetHandle() const { return m_Handle; }
+
+        static std::shared_ptr<StorageBuffer> Create(size_t size, uint32_t index = 0);
+
+    private:
+        void Allocate(size_t size);
+
+        uint32_t m_Handle = 0;
+        uint32_t m_BindIndex;
+        size_t m_Size = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,171 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#include "StreamingBuffer.h"
+#include "RenderState.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+
+namespace flex
+{
+    static size_t AlignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    StreamingBuffer::StreamingBuffer(size_t regionSize, uint32_t regionCount)
+        : m_RegionCount(regionCount)
+    {
+        GLint uniformAlignment = 0;
+        GLint storageAlignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+        glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+        m_UniformAlignment = std::max<size_t>(uniformAlignment, 16);
+        m_StorageAlignment = std::max<size_t>(storageAlignment, 16);
+
+        m_Fences.resize(m_RegionCount, nullptr);
+        CreateBuffer(regionSize);
+    }
+
+    StreamingBuffer::~StreamingBuffer()
+    {
+        for (GLsync fence : m_Fences)
+        {
+            if (fence)
+            {
+                glDeleteSync(fence);
+            }
+        }
+
+        for (const RetiredBuffer &retired : m_Retired)
+        {
+            if (retired.fence)
+            {
+                glDeleteSync(retired.fence);
+            }
+            RenderState::DeleteBuffer(retired.buffer);
+        }
+
+        glUnmapNamedBuffer(m_Buffer);
+        RenderState::DeleteBuffer(m_Buffer);
+    }
+
+    void StreamingBuffer::CreateBuffer(size_t regionSize)
+    {
+        m_RegionSize = AlignUp(regionSize, std::max(m_UniformAlignment, m_StorageAlignment));
+
+        constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        const size_t totalSize = m_RegionSize * m_RegionCount;
+
+        glCreateBuffers(1, &m_Buffer);
+        glNamedBufferStorage(m_Buffer, totalSize, nullptr, flags);
+        m_Mapped = static_cast<uint8_t *>(glMapNamedBufferRange(m_Buffer, 0, totalSize, flags));
+
+        assert(m_Buffer != 0 && m_Mapped && "Failed to create Streaming buffer!");
+    }
+
+    void StreamingBuffer::Grow(size_t minRegionSize)
+    {
+        // Ranges handed out earlier this frame stay valid in the old buffer until the GPU is done with it
+        glUnmapNamedBuffer(m_Buffer);
+        m_Retired.push_back({ m_Buffer, nullptr });
+
+        // The new buffer is idle, older region fences refer to the old one
+        for (GLsync &fence : m_Fences)
+        {
+            if (fence)
+            {
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+        }
+
+        const size_t newRegionSize = std::max(minRegionSize, m_RegionSize * 2);
+        std::cerr << "StreamingBuffer: frame needs more than " << m_RegionSize / 1024 << " KB, growing regions to " << newRegionSize / 1024 << " KB\n";
+
+        CreateBuffer(newRegionSize);
+        m_Head = 0;
+    }
+
+    StreamAllocation StreamingBuffer::Allocate(size_t size, size_t alignment)
+    {
+        size_t offset = AlignUp(m_Head, alignment);
+        if (offset + size > m_RegionSize)
+        {
+            Grow(size + alignment);
+            offset = 0;
+        }
+
+        m_Head = offset + size;
+
+        StreamAllocation allocation;
+        allocation.buffer = m_Buffer;
+        allocation.offset = m_Region * m_RegionSize + offset;
+        allocation.data = m_Mapped + allocation.offset;
+        return allocation;
+    }
+
+    StreamAllocation StreamingBuffer::Write(const void *data, size_t size, size_t alignment)
+    {
+        StreamAllocation allocation = Allocate(size, alignment);
+        std::memcpy(allocation.data, data, size);
+        return allocation;
+    }
+
+    void StreamingBuffer::BindRange(GLenum target, uint32_t index, const StreamAllocation &allocation, size_t size) const
+    {
+        RenderState::BindBufferRange(target, index, allocation.buffer, allocation.offset, size);
+    }
+
+    void StreamingBuffer::EndFrame()
+    {
+        m_Fences[m_Region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        for (RetiredBuffer &retired : m_Retired)
+        {
+            if (!retired.fence)
+            {
+                retired.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            }
+        }
+
+        m_LastFrameBytes = m_Head;
+        m_Region = (m_Region + 1) % m_RegionCount;
+        m_Head = 0;
+        ++m_FrameIndex;
+
+        if (GLsync fence = m_Fences[m_Region])
+        {
+            GLenum result = glClientWaitSync(fence, 0, 0);
+            if (result == GL_TIMEOUT_EXPIRED)
+            {
+                ++m_StallCount;
+                do
+                {
+                    result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000);
+                } while (result == GL_TIMEOUT_EXPIRED);
+            }
+
+            glDeleteSync(fence);
+            m_Fences[m_Region] = nullptr;
+        }
+
+        ReleaseRetiredBuffers();
+    }
+
+    void StreamingBuffer::ReleaseRetiredBuffers()
+    {
+        std::erase_if(m_Retired, [](const RetiredBuffer &retired)
+        {
+            if (!retired.fence || glClientWaitSync(retired.fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+            {
+                return false;
+            }
+
+            glDeleteSync(retired.fence);
+            RenderState::DeleteBuffer(retired.buffer);
+            return true;
+        });
+    }
+}
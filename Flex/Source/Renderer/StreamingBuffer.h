@@ -0,0 +1,78 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#ifndef STREAMING_BUFFER_H
+#define STREAMING_BUFFER_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace flex
+{
+    struct StreamAllocation
+    {
+        uint32_t buffer = 0; // GL buffer the range lives in, may differ between allocations after a grow
+        size_t offset = 0;
+        void *data = nullptr; // Persistently mapped, write only
+    };
+
+    // Per frame transient data (uniform blocks, instance transforms, indirect commands) written linearly
+    // into a persistently mapped, coherent buffer split into regionCount regions. Each frame writes one region
+    // which is fenced at EndFrame and only reused once the GPU has passed that fence, so writes never wait
+    // on the driver the way glBufferSubData on an in-flight buffer does.
+    // Allocations are only valid for the frame they were made in.
+    class StreamingBuffer
+    {
+    public:
+        explicit StreamingBuffer(size_t regionSize, uint32_t regionCount = 3);
+        ~StreamingBuffer();
+
+        StreamAllocation Allocate(size_t size, size_t alignment);
+        StreamAllocation Write(const void *data, size_t size, size_t alignment);
+
+        void BindRange(GLenum target, uint32_t index, const StreamAllocation &allocation, size_t size) const;
+
+        // Fences the region written this frame and moves to the next one, waiting for the GPU if it still reads it
+        void EndFrame();
+
+        uint64_t GetFrameIndex() const { return m_FrameIndex; }
+        size_t GetUniformAlignment() const { return m_UniformAlignment; }
+        size_t GetStorageAlignment() const { return m_StorageAlignment; }
+        size_t GetRegionSize() const { return m_RegionSize; }
+        size_t GetFrameBytes() const { return m_Head; } // Written so far this frame
+        size_t GetLastFrameBytes() const { return m_LastFrameBytes; }
+        uint32_t GetStallCount() const { return m_StallCount; } // Frames that had to wait on a fence
+
+    private:
+        void CreateBuffer(size_t regionSize);
+        void Grow(size_t minRegionSize);
+        void ReleaseRetiredBuffers();
+
+        struct RetiredBuffer
+        {
+            uint32_t buffer;
+            GLsync fence; // nullptr until the frame that last used it ends
+        };
+
+        uint32_t m_Buffer = 0;
+        uint8_t *m_Mapped = nullptr;
+        size_t m_RegionSize = 0;
+        uint32_t m_RegionCount = 0;
+        uint32_t m_Region = 0;
+        size_t m_Head = 0;
+
+        std::vector<GLsync> m_Fences;
+        std::vector<RetiredBuffer> m_Retired;
+
+        size_t m_UniformAlignment = 256;
+        size_t m_StorageAlignment = 256;
+
+        uint64_t m_FrameIndex = 0;
+        size_t m_LastFrameBytes = 0;
+        uint32_t m_StallCount = 0;
+    };
+}
+
+#endif
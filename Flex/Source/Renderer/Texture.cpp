@@ -1,20 +1,40 @@
 // Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
 
 #include "Texture.h"
+#include "RenderState.h"
+#include "TextureCompressor.h"
 
 #include <stb_image.h>
 #include <glad/glad.h>
 #include <iostream>
 #include <cassert>
+#include <algorithm>
+#include <bit>
 
 namespace flex
 {
+    static float GetMaxAnisotropy()
+    {
+        static const float maxAnisotropy = []
+        {
+            GLfloat value = 1.0f;
+            glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &value);
+            return value;
+        }();
+        return maxAnisotropy;
+    }
+
     Texture2D::Texture2D(const TextureCreateInfo &createInfo)
         : m_CreateInfo(createInfo)
     {
         CreateTexture();
     }
 
+    Texture2D::Texture2D(const TextureCreateInfo &createInfo, Pending)
+        : m_CreateInfo(createInfo)
+    {
+    }
+
     Texture2D::Texture2D(const TextureCreateInfo &createInfo, uint32_t hexColor)
         : m_CreateInfo(createInfo)
     {
@@ -45,10 +65,7 @@ namespace flex
                 << " - Size: " << createInfo.width << "x" << createInfo.height << std::endl;
         
         CreateTexture();
-
-        GLenum internalFormat = ToGLInternalFormat(createInfo.format);
-        GLenum format = ToGLFormat(createInfo.format);
-        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, m_CreateInfo.width, m_CreateInfo.height, 0, format, GL_UNSIGNED_BYTE, pixelData);
+        Upload(pixelData, GL_UNSIGNED_BYTE);
 
         delete[] pixelData;
     }
@@ -59,10 +76,7 @@ namespace flex
         m_Channels = 4; // Assuming RGBA format
         
         CreateTexture();
-
-        GLenum internalFormat = ToGLInternalFormat(createInfo.format);
-        GLenum format = ToGLFormat(createInfo.format);
-        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, m_CreateInfo.width, m_CreateInfo.height, 0, format, GL_UNSIGNED_BYTE, data);
+        Upload(data, GL_UNSIGNED_BYTE);
     }
 
     Texture2D::Texture2D(const TextureCreateInfo &createInfo, const std::string &filename)
@@ -71,8 +85,7 @@ namespace flex
         // Don't flip HDR textures - they are typically stored in the correct orientation
         stbi_set_flip_vertically_on_load(createInfo.flip ? 1 : 0);
         
-        CreateTexture();
-        
+        // Storage is immutable, so it is created once the file size is known
         int width, height, loadedChannels;
         m_Channels = 4; // forced RGBA
 
@@ -89,9 +102,10 @@ namespace flex
 
                 std::cout << "Loaded texture: " << filename << " - Width: " << width << ", Height: " << height << ", Channels (src->dst): " << loadedChannels << "->" << m_Channels << std::endl;
 
-                GLenum internalFormat = ToGLInternalFormat(createInfo.format);
-                GLenum format = ToGLFormat(createInfo.format);
-                glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, m_CreateInfo.width, m_CreateInfo.height, 0, format, GL_UNSIGNED_BYTE, data);
+                m_CreateInfo.width = width;
+                m_CreateInfo.height = height;
+                CreateTexture();
+                Upload(data, GL_UNSIGNED_BYTE);
 
                 if (data)
                 {
@@ -100,6 +114,31 @@ namespace flex
                 break;
             }
 
+            case Format::BC1:
+            case Format::BC3:
+            case Format::BC5:
+            case Format::BC7:
+            {
+                uint8_t *data = stbi_load(filename.c_str(), &width, &height, &loadedChannels, 4);
+                if (!data)
+                {
+                    assert(false && "Failed to load texture");
+                    return;
+                }
+
+                m_CreateInfo.width = width;
+                m_CreateInfo.height = height;
+                CreateTexture();
+
+                const CompressedImage image = TextureCompressor::CompressMipChain(data, width, height, createInfo.format, m_MipLevels);
+                for (uint32_t level = 0; level < m_MipLevels; ++level)
+                {
+                    UploadCompressed(level, image.levels[level].data(), image.levels[level].size());
+                }
+                stbi_image_free(data);
+                break;
+            }
+
             case Format::RGB16F:
             case Format::RGB32F:
             case Format::RGBA16F:
@@ -118,13 +157,10 @@ namespace flex
                 std::cout << "Loaded HDR texture: " << filename << " - Width: " << width << ", Height: " << height 
                         << ", Channels: " << loadedChannels << std::endl;
 
-                // Determine format based on loaded channels
-                GLenum internalFormat = ToGLInternalFormat(m_CreateInfo.format);
-                GLenum format = ToGLFormat(m_CreateInfo.format);
-
-                m_CreateInfo.width = static_cast<uint32_t>(width);
-                m_CreateInfo.height = static_cast<uint32_t>(height);
-                glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_FLOAT, data);
+                m_CreateInfo.width = width;
+                m_CreateInfo.height = height;
+                CreateTexture();
+                Upload(data, GL_FLOAT);
                 
                 if (data)
                 {
@@ -139,9 +175,7 @@ namespace flex
     {
         assert(((m_CreateInfo.width * m_CreateInfo.height * m_Channels) == size) && "Invalid image size");
 
-        GLenum format = ToGLInternalFormat(m_CreateInfo.format);
-        glBindTexture(GL_TEXTURE_2D, m_Handle);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_CreateInfo.width, m_CreateInfo.height, format, GL_UNSIGNED_BYTE, data);
+        Upload(data, GL_UNSIGNED_BYTE);
     }
 
     void Texture2D::Resize(int width, int height, unsigned int filterType)
@@ -151,101 +185,142 @@ namespace flex
             return;
 
         uint32_t oldTexture = m_Handle;
+        const int oldWidth = m_CreateInfo.width;
+        const int oldHeight = m_CreateInfo.height;
+        const uint32_t oldMipLevels = m_MipLevels;
         
+        // Immutable storage can't change size, allocate a new texture at the target size
+        m_CreateInfo.width = width;
+        m_CreateInfo.height = height;
         CreateTexture();
-        
-        // Allocate storage for the new texture
-        GLenum internalFormat = ToGLInternalFormat(m_CreateInfo.format);
-        GLenum format = ToGLFormat(m_CreateInfo.format);
-        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, m_CreateInfo.width, m_CreateInfo.height, 0, format, GL_UNSIGNED_BYTE, nullptr);
 
-        // Create a framebuffer to render the old texture into the new one (GPU-based resizing)
+        // Create a framebuffer to render the old texture into the new one (GPU-based resizing).
+        // Named framebuffers, nothing is bound so the cached RenderState bindings stay valid
         uint32_t fbo;
-        glGenFramebuffers(1, &fbo);
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_Handle, 0);
+        glCreateFramebuffers(1, &fbo);
+        glNamedFramebufferTexture(fbo, GL_COLOR_ATTACHMENT0, m_Handle, 0);
         
         // Check framebuffer completeness
-        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        if (glCheckNamedFramebufferStatus(fbo, GL_DRAW_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
         {
             std::cout << "Framebuffer not complete during texture resize!" << std::endl;
-            glDeleteFramebuffers(1, &fbo);
-            glDeleteTextures(1, &m_Handle);
+            RenderState::DeleteFramebuffer(fbo);
+            RenderState::DeleteTexture(m_Handle);
             m_Handle = oldTexture; // Restore old texture
+            m_CreateInfo.width = oldWidth;
+            m_CreateInfo.height = oldHeight;
+            m_MipLevels = oldMipLevels;
             return;
         }
         
-        // Set viewport to new texture size
-        glViewport(0, 0, width, height);
-        
-        // Bind the old texture
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, oldTexture);
-        
         // Create a temporary framebuffer for the source
         uint32_t srcFbo;
-        glGenFramebuffers(1, &srcFbo);
-        glBindFramebuffer(GL_READ_FRAMEBUFFER, srcFbo);
-        glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, oldTexture, 0);
-        
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
+        glCreateFramebuffers(1, &srcFbo);
+        glNamedFramebufferTexture(srcFbo, GL_COLOR_ATTACHMENT0, oldTexture, 0);
         
         // Blit (scale) from old texture to new texture
-        glBlitFramebuffer(0, 0, m_CreateInfo.width, m_CreateInfo.height,     // src rectangle
+        glBlitNamedFramebuffer(srcFbo, fbo,
+                        0, 0, oldWidth, oldHeight,   // src rectangle
                         0, 0, width, height,         // dst rectangle
                         GL_COLOR_BUFFER_BIT,         // mask
                         filterType);                  // filter
         
         // Clean up
-        glDeleteFramebuffers(1, &srcFbo);
-        glDeleteFramebuffers(1, &fbo);
-        glDeleteTextures(1, &oldTexture);
-        
-        m_CreateInfo.width = static_cast<uint32_t>(width);
-        m_CreateInfo.height = static_cast<uint32_t>(height);
-        
-        // Restore default framebuffer
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        RenderState::DeleteFramebuffer(srcFbo);
+        RenderState::DeleteFramebuffer(fbo);
+        RenderState::DeleteTexture(oldTexture);
+
+        if (m_MipLevels > 1)
+        {
+            glGenerateTextureMipmap(m_Handle);
+        }
         
         std::cout << "Texture resized to: " << width << "x" << height << std::endl;
     }
 
     void Texture2D::CreateTexture()
     {
+        m_MipLevels = IsMipmapFilter(m_CreateInfo.filter) ? CalculateMipLevels(m_CreateInfo.width, m_CreateInfo.height) : 1;
+
         glCreateTextures(GL_TEXTURE_2D, 1, &m_Handle);
-        glBindTexture(GL_TEXTURE_2D, m_Handle);
+        glTextureStorage2D(m_Handle, static_cast<GLsizei>(m_MipLevels), ToGLInternalFormat(m_CreateInfo.format), m_CreateInfo.width, m_CreateInfo.height);
         
         int error = glGetError();
         if (error != GL_NO_ERROR)
         {
-            std::cout << "OpenGL error after binding texture: " << error << std::endl;
+            std::cout << "OpenGL error after creating texture storage: " << error << std::endl;
         }
 
-        GLenum filter = ToGLFilter(m_CreateInfo.filter);
+        // Magnification never reads the mip chain
         GLenum clamp = ToGLClampMode(m_CreateInfo.clampMode);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+        glTextureParameteri(m_Handle, GL_TEXTURE_MIN_FILTER, ToGLFilter(m_CreateInfo.filter));
+        glTextureParameteri(m_Handle, GL_TEXTURE_MAG_FILTER, m_CreateInfo.filter == FilterMode::NEAREST ? GL_NEAREST : GL_LINEAR);
 
         // S and T are relevant for 2D textures
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, clamp);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, clamp);
+        glTextureParameteri(m_Handle, GL_TEXTURE_WRAP_S, clamp);
+        glTextureParameteri(m_Handle, GL_TEXTURE_WRAP_T, clamp);
+
+        if (m_CreateInfo.anisotropy > 1.0f)
+        {
+            glTextureParameterf(m_Handle, GL_TEXTURE_MAX_ANISOTROPY, std::min(m_CreateInfo.anisotropy, GetMaxAnisotropy()));
+        }
+    }
+
+    void Texture2D::Upload(const void *data, GLenum type)
+    {
+        glTextureSubImage2D(m_Handle, 0, 0, 0, m_CreateInfo.width, m_CreateInfo.height, ToGLFormat(m_CreateInfo.format), type, data);
+        if (m_MipLevels > 1)
+        {
+            glGenerateTextureMipmap(m_Handle);
+        }
+    }
+
+    void Texture2D::UploadCompressed(uint32_t level, const void *data, size_t size)
+    {
+        const GLsizei width = std::max(m_CreateInfo.width >> level, 1);
+        const GLsizei height = std::max(m_CreateInfo.height >> level, 1);
+        glCompressedTextureSubImage2D(m_Handle, static_cast<GLint>(level), 0, 0, width, height, ToGLInternalFormat(m_CreateInfo.format), static_cast<GLsizei>(size), data);
+    }
+
+    uint32_t Texture2D::CalculateMipLevels(uint32_t width, uint32_t height)
+    {
+        return static_cast<uint32_t>(std::bit_width(std::max({ width, height, 1u })));
+    }
+
+    size_t Texture2D::CalculateMemorySize(uint32_t width, uint32_t height, Format format, uint32_t mipLevels)
+    {
+        size_t size = 0;
+        for (uint32_t level = 0; level < mipLevels; ++level)
+        {
+            const uint32_t levelWidth = std::max(width >> level, 1u);
+            const uint32_t levelHeight = std::max(height >> level, 1u);
+            if (IsCompressedFormat(format))
+            {
+                size += size_t((levelWidth + 3) / 4) * ((levelHeight + 3) / 4) * GetFormatBlockSize(format);
+            }
+            else
+            {
+                size += size_t(levelWidth) * levelHeight * GetFormatSize(format);
+            }
+        }
+        return size;
     }
 
     Texture2D::~Texture2D()
     {
-        glDeleteTextures(1, &m_Handle);
+        RenderState::DeleteTexture(m_Handle);
     }
 
     void Texture2D::Bind(int index)
     {
         m_BindIndex = index;
         // Bind directly to the specified unit (DSA) to avoid affecting GL_ACTIVE_TEXTURE state
-        glBindTextureUnit(index, m_Handle);
+        RenderState::BindTextureUnit(index, m_Handle);
     }
 
     void Texture2D::Unbind()
     {
-        glBindTexture(GL_TEXTURE_2D, 0);
+        RenderState::BindTextureUnit(m_BindIndex, 0);
     }
 
     std::shared_ptr<Texture2D> Create(const TextureCreateInfo &createInfo)
@@ -20,8 +20,9 @@ namespace flex
         int height = 1;
         bool flip = true;
         Format format = Format::RGBA8;
-        FilterMode filter = FilterMode::LINEAR;
+        FilterMode filter = FilterMode::LINEAR; // Mip mapped filters allocate and generate the full mip chain
         WrapMode clampMode = WrapMode::REPEAT;
+        float anisotropy = 1.0f; // Clamped to GL_MAX_TEXTURE_MAX_ANISOTROPY, 1 disables it
     };
 
     class Texture2D
@@ -44,10 +45,16 @@ namespace flex
         uint32_t GetHeight() const { return m_CreateInfo.height; }
 
         WrapMode GetClampMode() const { return m_CreateInfo.clampMode; }
+        FilterMode GetFilter() const { return m_CreateInfo.filter; }
         Format GetFormat() const { return m_CreateInfo.format; }
+        float GetAnisotropy() const { return m_CreateInfo.anisotropy; }
+        uint32_t GetMipLevels() const { return m_MipLevels; }
+        size_t GetMemorySize() const { return CalculateMemorySize(m_CreateInfo.width, m_CreateInfo.height, m_CreateInfo.format, m_MipLevels); }
 
         uint32_t GetChannels() const { return m_Channels; }
         uint32_t GetHandle() const { return m_Handle; }
+        // False while the TextureLoader still decodes or uploads it, binding it until then samples black
+        bool IsReady() const { return m_Handle != 0; }
         int GetBindIndex() const { return m_BindIndex; }
 
         static std::shared_ptr<Texture2D> Create(const TextureCreateInfo &createInfo);
@@ -55,11 +62,29 @@ namespace flex
         static std::shared_ptr<Texture2D> Create(const TextureCreateInfo &createInfo, void *data, size_t size);
         static std::shared_ptr<Texture2D> Create(const TextureCreateInfo &createInfo, const std::string &filename);
 
+        // Levels from width x height down to 1x1
+        static uint32_t CalculateMipLevels(uint32_t width, uint32_t height);
+        // Bytes of the first mipLevels levels
+        static size_t CalculateMemorySize(uint32_t width, uint32_t height, Format format, uint32_t mipLevels);
+
     private:
+        friend class TextureLoader;
+        friend class TextureStreamer;
+
+        // No storage until the TextureLoader uploads it
+        struct Pending {};
+        Texture2D(const TextureCreateInfo &createInfo, Pending);
+
+        // Immutable storage for the current size, level 0 is filled by Upload
         void CreateTexture();
+        // Writes level 0 and rebuilds the rest of the chain from it
+        void Upload(const void *data, GLenum type);
+        // One level of a block compressed format, the driver can't generate those
+        void UploadCompressed(uint32_t level, const void *data, size_t size);
 
         uint32_t m_Handle = 0;
         uint32_t m_Channels = 4;
+        uint32_t m_MipLevels = 1;
 
         TextureCreateInfo m_CreateInfo;
         
@@ -0,0 +1,161 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#include "TextureCache.h"
+#include "TextureLoader.h"
+#include "Renderer.h"
+
+#include <algorithm>
+#include <filesystem>
+
+namespace flex
+{
+    static std::string GetCanonicalPath(const std::string &path)
+    {
+        std::error_code error;
+        const std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+        return error ? path : canonical.generic_string();
+    }
+
+    // The image decides the size, a requested size is not part of the key
+    static bool HasSameSettings(const TextureCreateInfo &a, const TextureCreateInfo &b)
+    {
+        return a.flip == b.flip && a.format == b.format && a.filter == b.filter && a.clampMode == b.clampMode
+            && a.anisotropy == b.anisotropy;
+    }
+
+    Ref<Texture2D> TextureCache::FindOrLoad(const std::string &path, const TextureCreateInfo &createInfo)
+    {
+        ++m_Stats.requested;
+
+        std::vector<Entry> &bucket = m_Files[GetCanonicalPath(path)];
+        if (Ref<Texture2D> texture = Find(bucket, createInfo))
+        {
+            return texture;
+        }
+
+        TextureLoader *loader = Renderer::GetTextureLoader();
+        Ref<Texture2D> texture = loader ? loader->Load(path, createInfo) : CreateRef<Texture2D>(createInfo, path);
+        Insert(bucket, texture, createInfo);
+        return texture;
+    }
+
+    Ref<Texture2D> TextureCache::FindOrDecode(const void *encoded, size_t size, const TextureCreateInfo &createInfo, const std::string &sourcePath)
+    {
+        ++m_Stats.requested;
+
+        // Bytes of one file are the same every time, so the path is enough and saves hashing them
+        std::vector<Entry> &bucket = sourcePath.empty()
+            ? m_Embedded[HashData(encoded, size)]
+            : m_Files[GetCanonicalPath(sourcePath)];
+
+        if (Ref<Texture2D> texture = Find(bucket, createInfo))
+        {
+            return texture;
+        }
+
+        TextureLoader *loader = Renderer::GetTextureLoader();
+        if (!loader)
+        {
+            return nullptr;
+        }
+
+        Ref<Texture2D> texture = loader->Load(encoded, size, createInfo);
+        Insert(bucket, texture, createInfo);
+        return texture;
+    }
+
+    Ref<Texture2D> TextureCache::Find(std::vector<Entry> &bucket, const TextureCreateInfo &createInfo)
+    {
+        std::erase_if(bucket, [](const Entry &entry) { return entry.texture.expired(); });
+
+        for (const Entry &entry : bucket)
+        {
+            if (!HasSameSettings(entry.createInfo, createInfo))
+            {
+                continue;
+            }
+
+            if (Ref<Texture2D> texture = entry.texture.lock())
+            {
+                m_PendingSavings.push_back(texture);
+                SettleSavings();
+                return texture;
+            }
+        }
+        return nullptr;
+    }
+
+    void TextureCache::SettleSavings()
+    {
+        std::erase_if(m_PendingSavings, [this](const std::weak_ptr<Texture2D> &pending)
+        {
+            const Ref<Texture2D> texture = pending.lock();
+            if (texture && !texture->IsReady())
+            {
+                return false;
+            }
+
+            // Textures dropped before their upload never took any memory
+            m_Stats.bytesSaved += texture ? texture->GetMemorySize() : 0;
+            return true;
+        });
+    }
+
+    TextureCacheStats TextureCache::GetStats() const
+    {
+        TextureCacheStats stats = m_Stats;
+        for (const std::weak_ptr<Texture2D> &pending : m_PendingSavings)
+        {
+            const Ref<Texture2D> texture = pending.lock();
+            if (texture && texture->IsReady())
+            {
+                stats.bytesSaved += texture->GetMemorySize();
+            }
+        }
+        return stats;
+    }
+
+    void TextureCache::Insert(std::vector<Entry> &bucket, const Ref<Texture2D> &texture, const TextureCreateInfo &createInfo)
+    {
+        bucket.push_back({ texture, createInfo });
+        ++m_Stats.created;
+    }
+
+    void TextureCache::CollectExpired()
+    {
+        const auto prune = [](auto &buckets)
+        {
+            for (auto &[key, bucket] : buckets)
+            {
+                std::erase_if(bucket, [](const Entry &entry) { return entry.texture.expired(); });
+            }
+            std::erase_if(buckets, [](const auto &pair) { return pair.second.empty(); });
+        };
+        prune(m_Files);
+        prune(m_Embedded);
+        SettleSavings();
+    }
+
+    void TextureCache::Clear()
+    {
+        m_Files.clear();
+        m_Embedded.clear();
+        m_PendingSavings.clear();
+        m_Stats = {};
+    }
+
+    uint32_t TextureCache::GetLiveTextureCount() const
+    {
+        uint32_t count = 0;
+        const auto countLive = [&count](const auto &buckets)
+        {
+            for (const auto &[key, bucket] : buckets)
+            {
+                count += static_cast<uint32_t>(std::count_if(bucket.begin(), bucket.end(), [](const Entry &entry) { return !entry.texture.expired(); }));
+            }
+        };
+        countLive(m_Files);
+        countLive(m_Embedded);
+        return count;
+    }
+}
@@ -0,0 +1,70 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include "Core/Types.h"
+#include "Core/Hash.h"
+#include "Texture.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace flex
+{
+    struct TextureCacheStats
+    {
+        uint32_t requested = 0;  // Textures asked for by the loaders
+        uint32_t created = 0;    // Of those, uploaded as a new texture
+        uint64_t bytesSaved = 0; // VRAM the reused textures would have taken, counted once their upload finished
+
+        float GetHitRate() const { return requested ? static_cast<float>(requested - created) / static_cast<float>(requested) : 0.0f; }
+    };
+
+    // Process wide reuse of loaded textures, keyed by canonical file path or by a hash of embedded pixel data,
+    // plus the format and sampling settings. The size always comes from the image, so a file loaded through
+    // FindOrLoad and FindOrDecode shares one texture. Entries hold weak references, a texture is freed with
+    // its last Material and its entry is dropped lazily
+    class TextureCache
+    {
+    public:
+        // A miss loads the file through the Renderer's TextureLoader, the texture may not be ready yet
+        Ref<Texture2D> FindOrLoad(const std::string &path, const TextureCreateInfo &createInfo);
+
+        // Encoded image file in memory, keyed by sourcePath when it came from a file and by content otherwise.
+        // Returns nullptr without a TextureLoader to decode it
+        Ref<Texture2D> FindOrDecode(const void *encoded, size_t size, const TextureCreateInfo &createInfo, const std::string &sourcePath = {});
+
+        void CollectExpired();
+        void Clear();
+
+        // Textures still referenced outside the cache
+        uint32_t GetLiveTextureCount() const;
+        TextureCacheStats GetStats() const;
+
+    private:
+        // The same source with different sampling or format settings is a different texture
+        struct Entry
+        {
+            std::weak_ptr<Texture2D> texture;
+            TextureCreateInfo createInfo;
+        };
+
+        Ref<Texture2D> Find(std::vector<Entry> &bucket, const TextureCreateInfo &createInfo);
+        void Insert(std::vector<Entry> &bucket, const Ref<Texture2D> &texture, const TextureCreateInfo &createInfo);
+        // Adds the size of reused textures whose upload finished since they were hit
+        void SettleSavings();
+
+        std::unordered_map<std::string, std::vector<Entry>> m_Files;
+        std::unordered_map<Hash128, std::vector<Entry>, Hash128Hasher> m_Embedded;
+        TextureCacheStats m_Stats;
+        // Hits on textures still loading, their final size and level count aren't known yet
+        std::vector<std::weak_ptr<Texture2D>> m_PendingSavings;
+    };
+}
+
+#endif
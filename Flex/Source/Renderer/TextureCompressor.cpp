@@ -0,0 +1,850 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#include "TextureCompressor.h"
+#include "Core/FileSystem.h"
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace flex
+{
+    namespace
+    {
+        constexpr uint32_t kMagic = 0x43545846; // "FXTC"
+        constexpr uint32_t kVersion = 1;
+
+        struct FileHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t format;
+            uint32_t width;
+            uint32_t height;
+            uint32_t levelCount;
+        };
+
+        // 4x4 texels in row order, RGBA as floats for the endpoint fits
+        struct Block
+        {
+            float texels[16][4];
+        };
+
+        void ReadBlock(const uint8_t *rgba, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, Block &block)
+        {
+            for (uint32_t y = 0; y < 4; ++y)
+            {
+                const uint32_t sourceY = std::min(blockY * 4 + y, height - 1);
+                for (uint32_t x = 0; x < 4; ++x)
+                {
+                    const uint32_t sourceX = std::min(blockX * 4 + x, width - 1);
+                    const uint8_t *texel = rgba + (size_t(sourceY) * width + sourceX) * 4;
+                    for (uint32_t c = 0; c < 4; ++c)
+                    {
+                        block.texels[y * 4 + x][c] = texel[c];
+                    }
+                }
+            }
+        }
+
+        void WriteBlock(uint8_t *rgba, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, const uint8_t texels[16][4])
+        {
+            for (uint32_t y = 0; y < 4 && blockY * 4 + y < height; ++y)
+            {
+                for (uint32_t x = 0; x < 4 && blockX * 4 + x < width; ++x)
+                {
+                    std::memcpy(rgba + (size_t(blockY * 4 + y) * width + blockX * 4 + x) * 4, texels[y * 4 + x], 4);
+                }
+            }
+        }
+
+        float Clamp255(float value)
+        {
+            return std::clamp(value, 0.0f, 255.0f);
+        }
+
+        // Endpoints at the extreme projections onto the principal axis of the first channelCount channels
+        void FitPrincipalAxis(const Block &block, uint32_t channelCount, float e0[4], float e1[4])
+        {
+            float mean[4] = {};
+            for (const auto &texel : block.texels)
+            {
+                for (uint32_t c = 0; c < channelCount; ++c)
+                {
+                    mean[c] += texel[c] / 16.0f;
+                }
+            }
+
+            float covariance[4][4] = {};
+            for (const auto &texel : block.texels)
+            {
+                for (uint32_t a = 0; a < channelCount; ++a)
+                {
+                    for (uint32_t b = 0; b < channelCount; ++b)
+                    {
+                        covariance[a][b] += (texel[a] - mean[a]) * (texel[b] - mean[b]);
+                    }
+                }
+            }
+
+            // Power iteration, starting from the row of the channel with the most variance
+            uint32_t start = 0;
+            for (uint32_t c = 1; c < channelCount; ++c)
+            {
+                if (covariance[c][c] > covariance[start][start])
+                {
+                    start = c;
+                }
+            }
+
+            float axis[4] = {};
+            for (uint32_t c = 0; c < channelCount; ++c)
+            {
+                axis[c] = covariance[start][c];
+            }
+
+            for (int iteration = 0; iteration < 8; ++iteration)
+            {
+                float next[4] = {};
+                float largest = 0.0f;
+                for (uint32_t a = 0; a < channelCount; ++a)
+                {
+                    for (uint32_t b = 0; b < channelCount; ++b)
+                    {
+                        next[a] += covariance[a][b] * axis[b];
+                    }
+                    largest = std::max(largest, std::abs(next[a]));
+                }
+
+                if (largest <= FLT_EPSILON)
+                {
+                    break;
+                }
+                for (uint32_t c = 0; c < channelCount; ++c)
+                {
+                    axis[c] = next[c] / largest;
+                }
+            }
+
+            float lengthSquared = 0.0f;
+            for (uint32_t c = 0; c < channelCount; ++c)
+            {
+                lengthSquared += axis[c] * axis[c];
+            }
+
+            float minT = 0.0f;
+            float maxT = 0.0f;
+            if (lengthSquared > FLT_EPSILON)
+            {
+                const float inverseLength = 1.0f / std::sqrt(lengthSquared);
+                minT = FLT_MAX;
+                maxT = -FLT_MAX;
+                for (const auto &texel : block.texels)
+                {
+                    float t = 0.0f;
+                    for (uint32_t c = 0; c < channelCount; ++c)
+                    {
+                        t += (texel[c] - mean[c]) * axis[c] * inverseLength;
+                    }
+                    minT = std::min(minT, t);
+                    maxT = std::max(maxT, t);
+                }
+
+                for (uint32_t c = 0; c < channelCount; ++c)
+                {
+                    axis[c] *= inverseLength;
+                }
+            }
+
+            // A flat block collapses both endpoints onto the mean
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                e0[c] = c < channelCount ? Clamp255(mean[c] + axis[c] * minT) : 255.0f;
+                e1[c] = c < channelCount ? Clamp255(mean[c] + axis[c] * maxT) : 255.0f;
+            }
+        }
+
+        // Endpoints with the least squared error for fixed interpolation weights (0 selects e0, 1 selects e1)
+        bool SolveEndpoints(const Block &block, const float weights[16], uint32_t channelCount, float e0[4], float e1[4])
+        {
+            float a = 0.0f;
+            float b = 0.0f;
+            float c = 0.0f;
+            float x0[4] = {};
+            float x1[4] = {};
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                const float t = weights[i];
+                const float s = 1.0f - t;
+                a += s * s;
+                b += s * t;
+                c += t * t;
+                for (uint32_t ch = 0; ch < channelCount; ++ch)
+                {
+                    x0[ch] += s * block.texels[i][ch];
+                    x1[ch] += t * block.texels[i][ch];
+                }
+            }
+
+            const float determinant = a * c - b * b;
+            if (std::abs(determinant) < 1e-6f)
+            {
+                return false;
+            }
+
+            for (uint32_t ch = 0; ch < channelCount; ++ch)
+            {
+                e0[ch] = Clamp255((c * x0[ch] - b * x1[ch]) / determinant);
+                e1[ch] = Clamp255((a * x1[ch] - b * x0[ch]) / determinant);
+            }
+            return true;
+        }
+
+        // BC1 color, also the color half of BC3
+
+        uint16_t PackRGB565(const float color[4])
+        {
+            const uint32_t r = static_cast<uint32_t>(std::lround(color[0] * 31.0f / 255.0f));
+            const uint32_t g = static_cast<uint32_t>(std::lround(color[1] * 63.0f / 255.0f));
+            const uint32_t b = static_cast<uint32_t>(std::lround(color[2] * 31.0f / 255.0f));
+            return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+        }
+
+        void UnpackRGB565(uint16_t packed, uint8_t rgb[3])
+        {
+            const uint32_t r = (packed >> 11) & 31;
+            const uint32_t g = (packed >> 5) & 63;
+            const uint32_t b = packed & 31;
+            rgb[0] = static_cast<uint8_t>((r << 3) | (r >> 2));
+            rgb[1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+            rgb[2] = static_cast<uint8_t>((b << 3) | (b >> 2));
+        }
+
+        // Four color mode, which BC3 always uses and BC1 uses when c0 > c1
+        void BuildColorPalette(uint16_t c0, uint16_t c1, uint8_t palette[4][3])
+        {
+            UnpackRGB565(c0, palette[0]);
+            UnpackRGB565(c1, palette[1]);
+            for (uint32_t c = 0; c < 3; ++c)
+            {
+                palette[2][c] = static_cast<uint8_t>((2 * palette[0][c] + palette[1][c]) / 3);
+                palette[3][c] = static_cast<uint8_t>((palette[0][c] + 2 * palette[1][c]) / 3);
+            }
+        }
+
+        float MatchColorIndices(const Block &block, const uint8_t palette[4][3], uint8_t indices[16])
+        {
+            float totalError = 0.0f;
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                float bestError = FLT_MAX;
+                for (uint8_t p = 0; p < 4; ++p)
+                {
+                    float error = 0.0f;
+                    for (uint32_t c = 0; c < 3; ++c)
+                    {
+                        const float d = block.texels[i][c] - palette[p][c];
+                        error += d * d;
+                    }
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        indices[i] = p;
+                    }
+                }
+                totalError += bestError;
+            }
+            return totalError;
+        }
+
+        void EncodeColorBlock(const Block &block, uint8_t out[8])
+        {
+            // Interpolation weight of each index towards c1
+            constexpr float kWeights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+            float e0[4];
+            float e1[4];
+            FitPrincipalAxis(block, 3, e1, e0);
+
+            uint16_t bestC0 = 0;
+            uint16_t bestC1 = 0;
+            uint8_t bestIndices[16] = {};
+            float bestError = FLT_MAX;
+            for (int iteration = 0; iteration < 2; ++iteration)
+            {
+                const uint16_t c0 = PackRGB565(e0);
+                const uint16_t c1 = PackRGB565(e1);
+                uint8_t palette[4][3];
+                BuildColorPalette(c0, c1, palette);
+
+                uint8_t indices[16];
+                const float error = MatchColorIndices(block, palette, indices);
+                if (error < bestError)
+                {
+                    bestError = error;
+                    bestC0 = c0;
+                    bestC1 = c1;
+                    std::memcpy(bestIndices, indices, sizeof(indices));
+                }
+
+                float weights[16];
+                for (uint32_t i = 0; i < 16; ++i)
+                {
+                    weights[i] = kWeights[indices[i]];
+                }
+                if (!SolveEndpoints(block, weights, 3, e0, e1))
+                {
+                    break;
+                }
+            }
+
+            // c0 <= c1 selects the three color mode in BC1. Swapping maps index 0 <-> 1 and 2 <-> 3,
+            // equal endpoints only need index 0, which is c0 in either mode
+            if (bestC0 < bestC1)
+            {
+                std::swap(bestC0, bestC1);
+                for (uint8_t &index : bestIndices)
+                {
+                    index ^= 1;
+                }
+            }
+            else if (bestC0 == bestC1)
+            {
+                std::memset(bestIndices, 0, sizeof(bestIndices));
+            }
+
+            out[0] = static_cast<uint8_t>(bestC0 & 0xFF);
+            out[1] = static_cast<uint8_t>(bestC0 >> 8);
+            out[2] = static_cast<uint8_t>(bestC1 & 0xFF);
+            out[3] = static_cast<uint8_t>(bestC1 >> 8);
+
+            uint32_t bits = 0;
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                bits |= static_cast<uint32_t>(bestIndices[i]) << (2 * i);
+            }
+            std::memcpy(out + 4, &bits, sizeof(bits));
+        }
+
+        void DecodeColorBlock(const uint8_t in[8], bool allowThreeColor, uint8_t texels[16][4])
+        {
+            const uint16_t c0 = static_cast<uint16_t>(in[0] | (in[1] << 8));
+            const uint16_t c1 = static_cast<uint16_t>(in[2] | (in[3] << 8));
+            uint8_t palette[4][3];
+            BuildColorPalette(c0, c1, palette);
+
+            bool transparentBlack = false;
+            if (allowThreeColor && c0 <= c1)
+            {
+                for (uint32_t c = 0; c < 3; ++c)
+                {
+                    palette[2][c] = static_cast<uint8_t>((palette[0][c] + palette[1][c]) / 2);
+                    palette[3][c] = 0;
+                }
+                transparentBlack = true;
+            }
+
+            uint32_t bits = 0;
+            std::memcpy(&bits, in + 4, sizeof(bits));
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                const uint32_t index = (bits >> (2 * i)) & 3;
+                std::memcpy(texels[i], palette[index], 3);
+                texels[i][3] = transparentBlack && index == 3 ? 0 : 255;
+            }
+        }
+
+        // BC4, the alpha half of BC3 and each half of BC5
+
+        void EncodeChannelBlock(const Block &block, uint32_t channel, uint8_t out[8])
+        {
+            float minValue = 255.0f;
+            float maxValue = 0.0f;
+            for (const auto &texel : block.texels)
+            {
+                minValue = std::min(minValue, texel[channel]);
+                maxValue = std::max(maxValue, texel[channel]);
+            }
+
+            // a0 > a1 selects the 8 value mode, equal endpoints decode index 0 as a0 in both modes
+            const uint32_t a0 = static_cast<uint32_t>(std::lround(maxValue));
+            const uint32_t a1 = static_cast<uint32_t>(std::lround(minValue));
+            std::memset(out, 0, 8);
+            out[0] = static_cast<uint8_t>(a0);
+            out[1] = static_cast<uint8_t>(a1);
+            if (a0 == a1)
+            {
+                return;
+            }
+
+            float palette[8] = { static_cast<float>(a0), static_cast<float>(a1) };
+            for (uint32_t i = 1; i < 7; ++i)
+            {
+                palette[i + 1] = static_cast<float>(((7 - i) * a0 + i * a1) / 7);
+            }
+
+            uint64_t bits = 0;
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                uint64_t bestIndex = 0;
+                float bestError = FLT_MAX;
+                for (uint32_t p = 0; p < 8; ++p)
+                {
+                    const float error = std::abs(block.texels[i][channel] - palette[p]);
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        bestIndex = p;
+                    }
+                }
+                bits |= bestIndex << (3 * i);
+            }
+
+            for (uint32_t b = 0; b < 6; ++b)
+            {
+                out[2 + b] = static_cast<uint8_t>(bits >> (8 * b));
+            }
+        }
+
+        void DecodeChannelBlock(const uint8_t in[8], uint32_t channel, uint8_t texels[16][4])
+        {
+            const uint32_t a0 = in[0];
+            const uint32_t a1 = in[1];
+            uint32_t palette[8] = { a0, a1 };
+            if (a0 > a1)
+            {
+                for (uint32_t i = 1; i < 7; ++i)
+                {
+                    palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+                }
+            }
+            else
+            {
+                for (uint32_t i = 1; i < 5; ++i)
+                {
+                    palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+                }
+                palette[6] = 0;
+                palette[7] = 255;
+            }
+
+            uint64_t bits = 0;
+            for (uint32_t b = 0; b < 6; ++b)
+            {
+                bits |= static_cast<uint64_t>(in[2 + b]) << (8 * b);
+            }
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                texels[i][channel] = static_cast<uint8_t>(palette[(bits >> (3 * i)) & 7]);
+            }
+        }
+
+        // BC7 mode 6
+
+        constexpr uint32_t kBC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+        struct BitWriter
+        {
+            uint8_t *data;
+            uint32_t position = 0;
+
+            void Write(uint32_t value, uint32_t count)
+            {
+                for (uint32_t i = 0; i < count; ++i, ++position)
+                {
+                    if ((value >> i) & 1)
+                    {
+                        data[position >> 3] |= static_cast<uint8_t>(1 << (position & 7));
+                    }
+                }
+            }
+        };
+
+        struct BitReader
+        {
+            const uint8_t *data;
+            uint32_t position = 0;
+
+            uint32_t Read(uint32_t count)
+            {
+                uint32_t value = 0;
+                for (uint32_t i = 0; i < count; ++i, ++position)
+                {
+                    value |= static_cast<uint32_t>((data[position >> 3] >> (position & 7)) & 1) << i;
+                }
+                return value;
+            }
+        };
+
+        // 7 bit channels, the p-bit is the shared low bit of its endpoint
+        struct Mode6Endpoints
+        {
+            uint8_t color[2][4];
+            uint8_t pbit[2];
+        };
+
+        void QuantizeMode6(const float e0[4], const float e1[4], uint8_t p0, uint8_t p1, Mode6Endpoints &endpoints)
+        {
+            endpoints.pbit[0] = p0;
+            endpoints.pbit[1] = p1;
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                endpoints.color[0][c] = static_cast<uint8_t>(std::clamp<long>(std::lround((e0[c] - p0) / 2.0f), 0, 127));
+                endpoints.color[1][c] = static_cast<uint8_t>(std::clamp<long>(std::lround((e1[c] - p1) / 2.0f), 0, 127));
+            }
+        }
+
+        void BuildMode6Palette(const Mode6Endpoints &endpoints, uint8_t palette[16][4])
+        {
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                const uint32_t a = (endpoints.color[0][c] << 1) | endpoints.pbit[0];
+                const uint32_t b = (endpoints.color[1][c] << 1) | endpoints.pbit[1];
+                for (uint32_t i = 0; i < 16; ++i)
+                {
+                    palette[i][c] = static_cast<uint8_t>(((64 - kBC7Weights[i]) * a + kBC7Weights[i] * b + 32) >> 6);
+                }
+            }
+        }
+
+        float MatchMode6Indices(const Block &block, const Mode6Endpoints &endpoints, uint8_t indices[16])
+        {
+            uint8_t palette[16][4];
+            BuildMode6Palette(endpoints, palette);
+
+            float totalError = 0.0f;
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                float bestError = FLT_MAX;
+                for (uint8_t p = 0; p < 16; ++p)
+                {
+                    float error = 0.0f;
+                    for (uint32_t c = 0; c < 4; ++c)
+                    {
+                        const float d = block.texels[i][c] - palette[p][c];
+                        error += d * d;
+                    }
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        indices[i] = p;
+                    }
+                }
+                totalError += bestError;
+            }
+            return totalError;
+        }
+
+        void EncodeBC7Block(const Block &block, uint8_t out[16])
+        {
+            float e0[4];
+            float e1[4];
+            FitPrincipalAxis(block, 4, e0, e1);
+
+            Mode6Endpoints best = {};
+            uint8_t bestIndices[16] = {};
+            float bestError = FLT_MAX;
+            for (int iteration = 0; iteration < 2; ++iteration)
+            {
+                uint8_t indices[16];
+                for (uint8_t p = 0; p < 4; ++p)
+                {
+                    Mode6Endpoints endpoints;
+                    QuantizeMode6(e0, e1, p & 1, p >> 1, endpoints);
+
+                    uint8_t candidate[16];
+                    const float error = MatchMode6Indices(block, endpoints, candidate);
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        best = endpoints;
+                        std::memcpy(bestIndices, candidate, sizeof(candidate));
+                    }
+                }
+                std::memcpy(indices, bestIndices, sizeof(indices));
+
+                float weights[16];
+                for (uint32_t i = 0; i < 16; ++i)
+                {
+                    weights[i] = kBC7Weights[indices[i]] / 64.0f;
+                }
+                if (!SolveEndpoints(block, weights, 4, e0, e1))
+                {
+                    break;
+                }
+            }
+
+            // The anchor texel stores 3 index bits, so its index must be below 8. The weights are symmetric,
+            // swapping the endpoints turns index i into 15 - i
+            if (bestIndices[0] >= 8)
+            {
+                for (uint32_t c = 0; c < 4; ++c)
+                {
+                    std::swap(best.color[0][c], best.color[1][c]);
+                }
+                std::swap(best.pbit[0], best.pbit[1]);
+                for (uint8_t &index : bestIndices)
+                {
+                    index = static_cast<uint8_t>(15 - index);
+                }
+            }
+
+            std::memset(out, 0, 16);
+            BitWriter writer{ out };
+            writer.Write(1u << 6, 7);
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                writer.Write(best.color[0][c], 7);
+                writer.Write(best.color[1][c], 7);
+            }
+            writer.Write(best.pbit[0], 1);
+            writer.Write(best.pbit[1], 1);
+            writer.Write(bestIndices[0], 3);
+            for (uint32_t i = 1; i < 16; ++i)
+            {
+                writer.Write(bestIndices[i], 4);
+            }
+        }
+
+        void DecodeBC7Block(const uint8_t in[16], uint8_t texels[16][4])
+        {
+            BitReader reader{ in };
+            if (reader.Read(7) != (1u << 6))
+            {
+                // Not written by EncodeBC7Block
+                for (uint32_t i = 0; i < 16; ++i)
+                {
+                    texels[i][0] = 255;
+                    texels[i][1] = 0;
+                    texels[i][2] = 255;
+                    texels[i][3] = 255;
+                }
+                return;
+            }
+
+            Mode6Endpoints endpoints;
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                endpoints.color[0][c] = static_cast<uint8_t>(reader.Read(7));
+                endpoints.color[1][c] = static_cast<uint8_t>(reader.Read(7));
+            }
+            endpoints.pbit[0] = static_cast<uint8_t>(reader.Read(1));
+            endpoints.pbit[1] = static_cast<uint8_t>(reader.Read(1));
+
+            uint8_t palette[16][4];
+            BuildMode6Palette(endpoints, palette);
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                std::memcpy(texels[i], palette[reader.Read(i == 0 ? 3 : 4)], 4);
+            }
+        }
+
+        std::vector<uint8_t> Downsample(const std::vector<uint8_t> &rgba, uint32_t width, uint32_t height)
+        {
+            const uint32_t halfWidth = std::max(width / 2, 1u);
+            const uint32_t halfHeight = std::max(height / 2, 1u);
+            std::vector<uint8_t> result(size_t(halfWidth) * halfHeight * 4);
+            for (uint32_t y = 0; y < halfHeight; ++y)
+            {
+                const uint32_t y0 = std::min(y * 2, height - 1);
+                const uint32_t y1 = std::min(y * 2 + 1, height - 1);
+                for (uint32_t x = 0; x < halfWidth; ++x)
+                {
+                    const uint32_t x0 = std::min(x * 2, width - 1);
+                    const uint32_t x1 = std::min(x * 2 + 1, width - 1);
+                    for (uint32_t c = 0; c < 4; ++c)
+                    {
+                        const uint32_t sum = rgba[(size_t(y0) * width + x0) * 4 + c] + rgba[(size_t(y0) * width + x1) * 4 + c]
+                            + rgba[(size_t(y1) * width + x0) * 4 + c] + rgba[(size_t(y1) * width + x1) * 4 + c];
+                        result[(size_t(y) * halfWidth + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+                    }
+                }
+            }
+            return result;
+        }
+    }
+
+    std::vector<uint8_t> TextureCompressor::Compress(const uint8_t *rgba, uint32_t width, uint32_t height, Format format)
+    {
+        const uint32_t blocksX = (width + 3) / 4;
+        const uint32_t blocksY = (height + 3) / 4;
+        const uint32_t blockSize = GetFormatBlockSize(format);
+        std::vector<uint8_t> blocks(size_t(blocksX) * blocksY * blockSize);
+
+        ThreadPool::ParallelFor(blocksY, 8, [&](size_t begin, size_t end)
+        {
+            Block block;
+            for (size_t blockY = begin; blockY < end; ++blockY)
+            {
+                for (uint32_t blockX = 0; blockX < blocksX; ++blockX)
+                {
+                    ReadBlock(rgba, width, height, blockX, static_cast<uint32_t>(blockY), block);
+                    uint8_t *out = blocks.data() + (blockY * blocksX + blockX) * blockSize;
+                    switch (format)
+                    {
+                        case Format::BC1:
+                            EncodeColorBlock(block, out);
+                            break;
+                        case Format::BC3:
+                            EncodeChannelBlock(block, 3, out);
+                            EncodeColorBlock(block, out + 8);
+                            break;
+                        case Format::BC5:
+                            EncodeChannelBlock(block, 0, out);
+                            EncodeChannelBlock(block, 1, out + 8);
+                            break;
+                        case Format::BC7:
+                            EncodeBC7Block(block, out);
+                            break;
+                        default:
+                            break;
+                    }
+                }
+            }
+        });
+
+        return blocks;
+    }
+
+    std::vector<uint8_t> TextureCompressor::Decompress(const uint8_t *blocks, uint32_t width, uint32_t height, Format format)
+    {
+        const uint32_t blocksX = (width + 3) / 4;
+        const uint32_t blocksY = (height + 3) / 4;
+        const uint32_t blockSize = GetFormatBlockSize(format);
+        std::vector<uint8_t> rgba(size_t(width) * height * 4);
+
+        for (uint32_t blockY = 0; blockY < blocksY; ++blockY)
+        {
+            for (uint32_t blockX = 0; blockX < blocksX; ++blockX)
+            {
+                const uint8_t *in = blocks + (size_t(blockY) * blocksX + blockX) * blockSize;
+                uint8_t texels[16][4] = {};
+                switch (format)
+                {
+                    case Format::BC1:
+                        DecodeColorBlock(in, true, texels);
+                        break;
+                    case Format::BC3:
+                        DecodeColorBlock(in + 8, false, texels);
+                        DecodeChannelBlock(in, 3, texels);
+                        break;
+                    case Format::BC5:
+                        DecodeChannelBlock(in, 0, texels);
+                        DecodeChannelBlock(in + 8, 1, texels);
+                        for (auto &texel : texels)
+                        {
+                            texel[3] = 255;
+                        }
+                        break;
+                    case Format::BC7:
+                        DecodeBC7Block(in, texels);
+                        break;
+                    default:
+                        break;
+                }
+                WriteBlock(rgba.data(), width, height, blockX, blockY, texels);
+            }
+        }
+        return rgba;
+    }
+
+    CompressedImage TextureCompressor::CompressMipChain(const uint8_t *rgba, uint32_t width, uint32_t height, Format format, uint32_t mipLevels)
+    {
+        CompressedImage image;
+        image.format = format;
+        image.width = width;
+        image.height = height;
+
+        std::vector<uint8_t> level(rgba, rgba + size_t(width) * height * 4);
+        for (uint32_t i = 0; i < mipLevels; ++i)
+        {
+            image.levels.push_back(Compress(level.data(), width, height, format));
+            if (i + 1 < mipLevels)
+            {
+                level = Downsample(level, width, height);
+                width = std::max(width / 2, 1u);
+                height = std::max(height / 2, 1u);
+            }
+        }
+        return image;
+    }
+
+    float TextureCompressor::ComputePSNR(const uint8_t *reference, const uint8_t *decoded, size_t texelCount, uint32_t channelCount)
+    {
+        double squaredError = 0.0;
+        for (size_t i = 0; i < texelCount; ++i)
+        {
+            for (uint32_t c = 0; c < channelCount; ++c)
+            {
+                const double d = double(reference[i * 4 + c]) - double(decoded[i * 4 + c]);
+                squaredError += d * d;
+            }
+        }
+
+        if (squaredError == 0.0)
+        {
+            return std::numeric_limits<float>::infinity();
+        }
+        const double meanSquaredError = squaredError / (double(texelCount) * channelCount);
+        return static_cast<float>(10.0 * std::log10(255.0 * 255.0 / meanSquaredError));
+    }
+
+    bool TextureCompressor::WriteFile(const std::filesystem::path &path, const CompressedImage &image)
+    {
+        return WriteFileAtomic(path, [&image](std::ofstream &file)
+        {
+            const FileHeader header = { kMagic, kVersion, static_cast<uint32_t>(image.format), image.width, image.height, static_cast<uint32_t>(image.levels.size()) };
+            file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            for (const std::vector<uint8_t> &level : image.levels)
+            {
+                const uint32_t size = static_cast<uint32_t>(level.size());
+                file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+                file.write(reinterpret_cast<const char *>(level.data()), size);
+            }
+        });
+    }
+
+    bool TextureCompressor::ReadFile(const std::filesystem::path &path, CompressedImage &image)
+    {
+        std::ifstream file(path, std::ios::binary);
+        FileHeader header = {};
+        if (!file || !file.read(reinterpret_cast<char *>(&header), sizeof(header))
+            || header.magic != kMagic || header.version != kVersion || header.levelCount > 32
+            || !IsCompressedFormat(static_cast<Format>(header.format)))
+        {
+            return false;
+        }
+
+        image.format = static_cast<Format>(header.format);
+        image.width = header.width;
+        image.height = header.height;
+        image.levels.resize(header.levelCount);
+
+        uint32_t width = header.width;
+        uint32_t height = header.height;
+        for (std::vector<uint8_t> &level : image.levels)
+        {
+            // Sizes are implied by the format, anything else is a damaged file
+            const size_t expected = size_t((width + 3) / 4) * ((height + 3) / 4) * GetFormatBlockSize(image.format);
+            uint32_t size = 0;
+            if (!file.read(reinterpret_cast<char *>(&size), sizeof(size)) || size != expected)
+            {
+                return false;
+            }
+
+            level.resize(size);
+            if (!file.read(reinterpret_cast<char *>(level.data()), size))
+            {
+                return false;
+            }
+
+            width = std::max(width / 2, 1u);
+            height = std::max(height / 2, 1u);
+        }
+        return true;
+    }
+}
@@ -0,0 +1,50 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#ifndef TEXTURE_COMPRESSOR_H
+#define TEXTURE_COMPRESSOR_H
+
+#include "RendererCommon.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace flex
+{
+    // Block compressed mip chain, level 0 first, blocks of each level in row order
+    struct CompressedImage
+    {
+        Format format = Format::BC7;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<std::vector<uint8_t>> levels;
+    };
+
+    // CPU encoder for the block compressed formats, used at import with the result kept on disk.
+    // BC1 and BC3 color fit endpoints along the principal axis and refine them once by least squares,
+    // BC3 alpha and BC5 channels use the min / max 8 value mode, BC7 always writes mode 6
+    // (one subset, 7.7.7.7.1 endpoints, 4-bit indices). Blocks are encoded in parallel on the ThreadPool
+    class TextureCompressor
+    {
+    public:
+        // Part of the disk cache key, bump whenever the encoded output changes
+        static constexpr uint32_t kEncoderVersion = 1;
+
+        // RGBA8 texels, rows top first. Edge blocks of sizes that aren't a multiple of 4 repeat the last row / column
+        static std::vector<uint8_t> Compress(const uint8_t *rgba, uint32_t width, uint32_t height, Format format);
+        // Back to RGBA8 for validation, BC5 decodes to (r, g, 0, 255) and BC7 only reads mode 6 blocks
+        static std::vector<uint8_t> Decompress(const uint8_t *blocks, uint32_t width, uint32_t height, Format format);
+
+        // Box filtered chain of mipLevels levels, each encoded
+        static CompressedImage CompressMipChain(const uint8_t *rgba, uint32_t width, uint32_t height, Format format, uint32_t mipLevels);
+
+        // Over the first channelCount channels of RGBA8 texels
+        static float ComputePSNR(const uint8_t *reference, const uint8_t *decoded, size_t texelCount, uint32_t channelCount = 4);
+
+        static bool WriteFile(const std::filesystem::path &path, const CompressedImage &image);
+        static bool ReadFile(const std::filesystem::path &path, CompressedImage &image);
+    };
+}
+
+#endif
@@ -0,0 +1,329 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#include "TextureLoader.h"
+#include "StreamingBuffer.h"
+#include "Renderer.h"
+#include "TextureStreamer.h"
+#include "TextureTable.h"
+#include "Core/Hash.h"
+#include "Core/ThreadPool.h"
+
+#include <stb_image.h>
+
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <iostream>
+
+namespace flex
+{
+    static constexpr size_t kStagingAlignment = 16;
+
+    static bool IsFloatFormat(Format format)
+    {
+        return format == Format::RGB16F || format == Format::RGB32F || format == Format::RGBA16F || format == Format::RGBA32F;
+    }
+
+    static int GetChannelCount(Format format)
+    {
+        switch (format)
+        {
+            case Format::R8: return 1;
+            case Format::RGB8:
+            case Format::RGB16F:
+            case Format::RGB32F: return 3;
+            default: return 4;
+        }
+    }
+
+    TextureLoader::Job::~Job()
+    {
+        if (pixels)
+        {
+            stbi_image_free(pixels);
+        }
+    }
+
+    TextureLoader::TextureLoader(size_t stagingSize, uint32_t regionCount, const std::filesystem::path &cacheDirectory)
+        : m_Staging(CreateScope<StreamingBuffer>(stagingSize, regionCount))
+        , m_CacheDirectory(cacheDirectory)
+        , m_Decoded(CreateRef<DecodedQueue>())
+    {
+    }
+
+    TextureLoader::~TextureLoader() = default;
+
+    Ref<Texture2D> TextureLoader::Load(const std::string &path, const TextureCreateInfo &createInfo)
+    {
+        Ref<Job> job = CreateRef<Job>();
+        job->createInfo = createInfo;
+        job->path = path;
+        return Submit(job);
+    }
+
+    Ref<Texture2D> TextureLoader::Load(const void *encoded, size_t size, const TextureCreateInfo &createInfo)
+    {
+        Ref<Job> job = CreateRef<Job>();
+        job->createInfo = createInfo;
+        job->encoded.assign(static_cast<const uint8_t *>(encoded), static_cast<const uint8_t *>(encoded) + size);
+        return Submit(job);
+    }
+
+    Ref<Texture2D> TextureLoader::Submit(const Ref<Job> &job)
+    {
+        Ref<Texture2D> texture(new Texture2D(job->createInfo, Texture2D::Pending{}));
+        job->texture = texture;
+        job->cacheDirectory = m_CacheDirectory;
+        ++m_PendingCount;
+
+        const Ref<DecodedQueue> decoded = m_Decoded;
+        auto task = [job, decoded]()
+        {
+            Decode(*job);
+
+            std::lock_guard<std::mutex> lock(decoded->mutex);
+            decoded->jobs.push_back(job);
+        };
+
+        if (ThreadPool *pool = ThreadPool::Get())
+        {
+            pool->Enqueue(std::move(task));
+        }
+        else
+        {
+            task();
+        }
+        return texture;
+    }
+
+    void TextureLoader::Decode(Job &job)
+    {
+        if (IsCompressedFormat(job.createInfo.format))
+        {
+            DecodeCompressed(job);
+            return;
+        }
+
+        const bool hdr = IsFloatFormat(job.createInfo.format);
+        const int channels = GetChannelCount(job.createInfo.format);
+
+        // The global flip flag would race with other workers
+        stbi_set_flip_vertically_on_load_thread(job.createInfo.flip ? 1 : 0);
+
+        int sourceChannels = 0;
+        if (!job.path.empty())
+        {
+            job.pixels = hdr
+                ? static_cast<void *>(stbi_loadf(job.path.c_str(), &job.width, &job.height, &sourceChannels, channels))
+                : static_cast<void *>(stbi_load(job.path.c_str(), &job.width, &job.height, &sourceChannels, channels));
+        }
+        else
+        {
+            const int size = static_cast<int>(job.encoded.size());
+            job.pixels = hdr
+                ? static_cast<void *>(stbi_loadf_from_memory(job.encoded.data(), size, &job.width, &job.height, &sourceChannels, channels))
+                : static_cast<void *>(stbi_load_from_memory(job.encoded.data(), size, &job.width, &job.height, &sourceChannels, channels));
+            job.encoded = {};
+        }
+
+        if (!job.pixels)
+        {
+            std::cerr << "TextureLoader: failed to decode " << (job.path.empty() ? "embedded image" : job.path) << ": " << stbi_failure_reason() << '\n';
+            return;
+        }
+
+        job.channels = channels;
+        job.type = hdr ? GL_FLOAT : GL_UNSIGNED_BYTE;
+        job.size = size_t(job.width) * job.height * channels * (hdr ? sizeof(float) : 1);
+    }
+
+    void TextureLoader::DecodeCompressed(Job &job)
+    {
+        const std::string name = job.path.empty() ? "embedded image" : job.path;
+        if (!job.path.empty())
+        {
+            std::ifstream file(job.path, std::ios::binary | std::ios::ate);
+            if (!file)
+            {
+                std::cerr << "TextureLoader: failed to open " << name << '\n';
+                return;
+            }
+            job.encoded.resize(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            file.read(reinterpret_cast<char *>(job.encoded.data()), static_cast<std::streamsize>(job.encoded.size()));
+        }
+
+        // Keyed by content, the target format, the encoder version and every setting that changes the encoder output,
+        // so renamed files still hit and files from an older encoder are never picked up
+        const bool mipmaps = IsMipmapFilter(job.createInfo.filter);
+        const uint32_t settings[4] = { TextureCompressor::kEncoderVersion, static_cast<uint32_t>(job.createInfo.format),
+            job.createInfo.flip ? 1u : 0u, mipmaps ? 1u : 0u };
+        const Hash128 parts[2] = { HashData(job.encoded.data(), job.encoded.size()), HashData(settings, sizeof(settings)) };
+        const Hash128 hash = HashData(parts, sizeof(parts));
+
+        std::filesystem::path cachePath;
+        if (!job.cacheDirectory.empty())
+        {
+            cachePath = job.cacheDirectory / std::format("{:016x}{:016x}.bin", hash.high, hash.low);
+        }
+
+        if (cachePath.empty() || !TextureCompressor::ReadFile(cachePath, job.compressed) || job.compressed.format != job.createInfo.format)
+        {
+            stbi_set_flip_vertically_on_load_thread(job.createInfo.flip ? 1 : 0);
+
+            int width = 0;
+            int height = 0;
+            int sourceChannels = 0;
+            uint8_t *rgba = stbi_load_from_memory(job.encoded.data(), static_cast<int>(job.encoded.size()), &width, &height, &sourceChannels, 4);
+            job.encoded = {};
+            if (!rgba)
+            {
+                job.compressed = {};
+                std::cerr << "TextureLoader: failed to decode " << name << ": " << stbi_failure_reason() << '\n';
+                return;
+            }
+
+            const uint32_t mipLevels = mipmaps ? Texture2D::CalculateMipLevels(width, height) : 1;
+            job.compressed = TextureCompressor::CompressMipChain(rgba, width, height, job.createInfo.format, mipLevels);
+            stbi_image_free(rgba);
+
+            if (!cachePath.empty())
+            {
+                TextureCompressor::WriteFile(cachePath, job.compressed);
+            }
+        }
+        job.encoded = {};
+
+        job.width = static_cast<int>(job.compressed.width);
+        job.height = static_cast<int>(job.compressed.height);
+        job.channels = 4;
+        job.size = 0;
+        for (const std::vector<uint8_t> &level : job.compressed.levels)
+        {
+            job.size += level.size() + kStagingAlignment;
+        }
+    }
+
+    uint32_t TextureLoader::Update(float budgetMs)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Decoded->mutex);
+            m_Ready.insert(m_Ready.end(), m_Decoded->jobs.begin(), m_Decoded->jobs.end());
+            m_Decoded->jobs.clear();
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const size_t regionSize = m_Staging->GetRegionSize();
+        uint32_t uploaded = 0;
+        while (!m_Ready.empty())
+        {
+            const float elapsedMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (uploaded > 0 && elapsedMs >= budgetMs)
+            {
+                break;
+            }
+
+            // Left for the next region rather than growing the staging buffer
+            Job &job = *m_Ready.front();
+            const bool staged = job.IsDecoded() && job.size <= regionSize;
+            if (uploaded > 0 && staged && m_Staging->GetFrameBytes() + kStagingAlignment + job.size > regionSize)
+            {
+                break;
+            }
+
+            // Nothing to do for textures dropped while they were loading
+            if (Ref<Texture2D> texture = job.texture.lock())
+            {
+                Upload(job, texture);
+                ++uploaded;
+            }
+
+            m_Ready.pop_front();
+            --m_PendingCount;
+        }
+
+        if (m_Staging->GetFrameBytes() > 0)
+        {
+            m_Staging->EndFrame();
+        }
+        return uploaded;
+    }
+
+    void TextureLoader::Upload(Job &job, const Ref<Texture2D> &texture)
+    {
+        if (!job.IsDecoded())
+        {
+            const uint8_t magenta[4] = { 255, 0, 255, 255 };
+            texture->m_CreateInfo.width = 1;
+            texture->m_CreateInfo.height = 1;
+            texture->m_CreateInfo.format = Format::RGBA8;
+            texture->m_Channels = 4;
+            texture->CreateTexture();
+            texture->Upload(magenta, GL_UNSIGNED_BYTE);
+            return;
+        }
+
+        texture->m_Channels = static_cast<uint32_t>(job.channels);
+
+        // Mip chains start with their low levels, the streamer keeps the rest in memory until draws need them
+        TextureStreamer *streamer = Renderer::GetTextureStreamer();
+        if (streamer && TextureStreamer::CanStream(job.compressed, Renderer::GetTextureTable()->IsBindless()))
+        {
+            streamer->Register(texture, CreateRef<const CompressedImage>(std::move(job.compressed)));
+            return;
+        }
+
+        texture->m_CreateInfo.width = job.width;
+        texture->m_CreateInfo.height = job.height;
+        texture->CreateTexture();
+
+        if (!job.compressed.levels.empty())
+        {
+            // The whole chain goes through what is left of this frame's staging region, or none of it
+            const bool staged = m_Staging->GetFrameBytes() + job.size <= m_Staging->GetRegionSize();
+            const uint32_t levelCount = std::min(texture->m_MipLevels, static_cast<uint32_t>(job.compressed.levels.size()));
+            for (uint32_t level = 0; level < levelCount; ++level)
+            {
+                const std::vector<uint8_t> &data = job.compressed.levels[level];
+                if (staged)
+                {
+                    const StreamAllocation staging = m_Staging->Write(data.data(), data.size(), kStagingAlignment);
+                    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging.buffer);
+                    texture->UploadCompressed(level, reinterpret_cast<const void *>(staging.offset), data.size());
+                    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                }
+                else
+                {
+                    texture->UploadCompressed(level, data.data(), data.size());
+                }
+            }
+            return;
+        }
+
+        // Rows of 1 and 3 channel 8-bit images are tightly packed
+        const bool unaligned = (job.size / job.height) % 4 != 0;
+        if (unaligned)
+        {
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        }
+
+        if (job.size <= m_Staging->GetRegionSize())
+        {
+            // The copy out of the mapped range runs on the GPU timeline, the call returns right away
+            const StreamAllocation staging = m_Staging->Write(job.pixels, job.size, kStagingAlignment);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging.buffer);
+            texture->Upload(reinterpret_cast<const void *>(staging.offset), job.type);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+        else
+        {
+            // Larger than a staging region, the driver copies it from client memory
+            texture->Upload(job.pixels, job.type);
+        }
+
+        if (unaligned)
+        {
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        }
+    }
+}
@@ -0,0 +1,94 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#ifndef TEXTURE_LOADER_H
+#define TEXTURE_LOADER_H
+
+#include "Core/Types.h"
+#include "Texture.h"
+#include "TextureCompressor.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace flex
+{
+    class StreamingBuffer;
+
+    // Decodes image files on the ThreadPool and uploads them on the GL thread through persistently mapped
+    // pixel unpack buffers, a few per frame. Load returns the texture right away, it stays empty
+    // (Texture2D::IsReady is false) until its upload ran. Images that fail to decode turn magenta.
+    // Block compressed formats (BC1, BC3, BC5, BC7) are encoded on the worker with their mip chain
+    // and kept in cacheDirectory keyed by the file content, so only the first load pays for the encoder
+    class TextureLoader
+    {
+    public:
+        static constexpr float kDefaultBudgetMs = 2.0f;
+
+        // Pixels of one frame's uploads are staged in one of regionCount regions of stagingSize bytes.
+        // An empty cacheDirectory encodes block compressed textures on every load
+        explicit TextureLoader(size_t stagingSize, uint32_t regionCount = 2, const std::filesystem::path &cacheDirectory = {});
+        ~TextureLoader();
+
+        Ref<Texture2D> Load(const std::string &path, const TextureCreateInfo &createInfo);
+        // An encoded image file (PNG, JPEG, HDR, ...) already in memory, the bytes are copied
+        Ref<Texture2D> Load(const void *encoded, size_t size, const TextureCreateInfo &createInfo);
+
+        // GL thread, once per frame. Uploads decoded textures until budgetMs is spent, at least one per call.
+        // Returns the number of textures uploaded
+        uint32_t Update(float budgetMs = kDefaultBudgetMs);
+
+        // Textures waiting for their decode or upload
+        uint32_t GetPendingCount() const { return m_PendingCount; }
+
+        // Pixel unpack ring, also written by the TextureStreamer. Fenced by Update when the frame wrote to it
+        StreamingBuffer *GetStaging() const { return m_Staging.get(); }
+
+    private:
+        // Shared with the worker, which never touches GL or the texture
+        struct Job
+        {
+            ~Job();
+
+            bool IsDecoded() const { return pixels || !compressed.levels.empty(); }
+
+            std::weak_ptr<Texture2D> texture;
+            TextureCreateInfo createInfo;
+            std::string path;
+            std::vector<uint8_t> encoded;
+            std::filesystem::path cacheDirectory;
+            CompressedImage compressed; // Instead of pixels for block compressed formats
+
+            void *pixels = nullptr; // stb_image allocation
+            int width = 0;
+            int height = 0;
+            int channels = 0;
+            GLenum type = GL_UNSIGNED_BYTE;
+            size_t size = 0;
+        };
+
+        struct DecodedQueue
+        {
+            std::mutex mutex;
+            std::vector<Ref<Job>> jobs;
+        };
+
+        Ref<Texture2D> Submit(const Ref<Job> &job);
+        static void Decode(Job &job);
+        static void DecodeCompressed(Job &job);
+        void Upload(Job &job, const Ref<Texture2D> &texture);
+
+        Scope<StreamingBuffer> m_Staging;
+        std::filesystem::path m_CacheDirectory;
+        Ref<DecodedQueue> m_Decoded;
+        std::deque<Ref<Job>> m_Ready;
+        uint32_t m_PendingCount = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,279 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#include "TextureStreamer.h"
+#include "Texture.h"
+#include "Renderer.h"
+#include "TextureTable.h"
+#include "StreamingBuffer.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace flex
+{
+    static constexpr size_t kStagingAlignment = 16;
+
+    TextureStreamer::TextureStreamer(size_t budgetBytes, StreamingBuffer *staging)
+        : m_Staging(staging)
+        , m_Budget(budgetBytes)
+    {
+    }
+
+    void TextureStreamer::Register(const Ref<Texture2D> &texture, const Ref<const CompressedImage> &image)
+    {
+        Entry entry;
+        entry.texture = texture;
+        entry.image = image;
+        entry.lastUsedFrame = m_Frame;
+
+        // Without a full chain there is nothing to leave out, it stays resident as a whole
+        const bool fullChain = image->levels.size() == Texture2D::CalculateMipLevels(image->width, image->height);
+        entry.tailLevel = fullChain ? GetTailLevel(image->width, image->height) : 0;
+        entry.wantedLevel = entry.tailLevel;
+
+        ++m_Stats.textureCount;
+        m_Stats.fullBytes += GetChainSize(*image, 0);
+        SetResidentLevel(entry, *texture, entry.tailLevel);
+        m_Entries[texture.get()] = std::move(entry);
+    }
+
+    void TextureStreamer::Request(const Texture2D *texture, float uvPerViewport)
+    {
+        auto it = m_Entries.find(texture);
+        if (it == m_Entries.end() || it->second.texture.expired())
+        {
+            return;
+        }
+
+        Entry &entry = it->second;
+        const uint32_t size = std::max(entry.image->width, entry.image->height);
+        const uint32_t level = std::min(SelectMipLevel(size, uvPerViewport, m_ViewportHeight), entry.tailLevel);
+        if (entry.lastUsedFrame != m_Frame)
+        {
+            entry.lastUsedFrame = m_Frame;
+            entry.wantedLevel = level;
+        }
+        else
+        {
+            entry.wantedLevel = std::min(entry.wantedLevel, level);
+        }
+    }
+
+    void TextureStreamer::Update()
+    {
+        CollectExpired();
+
+        // Largest quality gap first. Textures not drawn this frame keep their levels until they are evicted
+        std::vector<Entry *> promotions;
+        for (auto &[key, entry] : m_Entries)
+        {
+            if (entry.lastUsedFrame == m_Frame && entry.wantedLevel < entry.residentLevel)
+            {
+                promotions.push_back(&entry);
+            }
+        }
+        std::sort(promotions.begin(), promotions.end(), [](const Entry *a, const Entry *b)
+        {
+            return a->residentLevel - a->wantedLevel > b->residentLevel - b->wantedLevel;
+        });
+
+        size_t uploaded = 0;
+        for (Entry *entry : promotions)
+        {
+            if (uploaded >= kMaxUploadBytes)
+            {
+                break;
+            }
+
+            const Ref<Texture2D> texture = entry->texture.lock();
+            const size_t current = GetChainSize(*entry->image, entry->residentLevel);
+
+            // Finest level that fits, making room from textures that weren't drawn this frame
+            for (uint32_t level = entry->wantedLevel; level < entry->residentLevel; ++level)
+            {
+                const size_t growth = GetChainSize(*entry->image, level) - current;
+                const size_t available = m_Budget > m_Stats.residentBytes ? m_Budget - m_Stats.residentBytes : 0;
+                if (growth <= available || Evict(growth - available, entry))
+                {
+                    SetResidentLevel(*entry, *texture, level);
+                    uploaded += growth;
+                    ++m_Stats.promotions;
+                    break;
+                }
+            }
+        }
+
+        // Over budget after it was lowered, textures drawn this frame give up their finest level last, largest first
+        if (m_Stats.residentBytes > m_Budget)
+        {
+            Evict(m_Stats.residentBytes - m_Budget, nullptr);
+        }
+        while (m_Stats.residentBytes > m_Budget)
+        {
+            Entry *largest = nullptr;
+            size_t largestSize = 0;
+            for (auto &[key, entry] : m_Entries)
+            {
+                const size_t size = GetChainSize(*entry.image, entry.residentLevel);
+                if (entry.residentLevel < entry.tailLevel && size > largestSize)
+                {
+                    largest = &entry;
+                    largestSize = size;
+                }
+            }
+
+            if (!largest)
+            {
+                break;
+            }
+            SetResidentLevel(*largest, *largest->texture.lock(), largest->residentLevel + 1);
+            ++m_Stats.evictions;
+        }
+
+        ++m_Frame;
+    }
+
+    uint32_t TextureStreamer::SelectMipLevel(uint32_t size, float uvPerViewport, uint32_t viewportHeight)
+    {
+        // No UV density known, keep the full resolution
+        if (uvPerViewport <= 0.0f || viewportHeight == 0)
+        {
+            return 0;
+        }
+
+        // Level n has one texel per pixel at 2^n texels per pixel of level 0
+        const float texelsPerPixel = static_cast<float>(size) * uvPerViewport / static_cast<float>(viewportHeight);
+        if (texelsPerPixel <= 1.0f)
+        {
+            return 0;
+        }
+        return static_cast<uint32_t>(std::floor(std::log2(texelsPerPixel)));
+    }
+
+    uint32_t TextureStreamer::GetTailLevel(uint32_t width, uint32_t height)
+    {
+        uint32_t level = 0;
+        while (std::max(width >> level, height >> level) > kTailSize)
+        {
+            ++level;
+        }
+        return level;
+    }
+
+    void TextureStreamer::SetResidentLevel(Entry &entry, Texture2D &texture, uint32_t level)
+    {
+        const CompressedImage &image = *entry.image;
+        const uint32_t oldHandle = texture.m_Handle;
+        const uint32_t oldLevel = entry.residentLevel;
+        if (oldHandle != 0)
+        {
+            m_Stats.residentBytes -= GetChainSize(image, oldLevel);
+        }
+
+        // Immutable storage can't drop or add levels, a smaller or larger texture replaces it.
+        // The texture table picks up the new handle the next time its materials acquire it
+        texture.m_CreateInfo.width = static_cast<int>(std::max(image.width >> level, 1u));
+        texture.m_CreateInfo.height = static_cast<int>(std::max(image.height >> level, 1u));
+        texture.CreateTexture();
+
+        const uint32_t levelCount = std::min(texture.m_MipLevels, static_cast<uint32_t>(image.levels.size()) - level);
+        for (uint32_t mip = 0; mip < levelCount; ++mip)
+        {
+            const uint32_t source = level + mip;
+            if (oldHandle != 0 && source >= oldLevel)
+            {
+                // Already on the GPU, copied without a round trip through the CPU
+                glCopyImageSubData(oldHandle, GL_TEXTURE_2D, static_cast<GLint>(source - oldLevel), 0, 0, 0,
+                    texture.m_Handle, GL_TEXTURE_2D, static_cast<GLint>(mip), 0, 0, 0,
+                    static_cast<GLsizei>(std::max(image.width >> source, 1u)), static_cast<GLsizei>(std::max(image.height >> source, 1u)), 1);
+            }
+            else
+            {
+                UploadLevel(texture, mip, image.levels[source]);
+            }
+        }
+
+        // Draws submitted this frame may still sample the old storage through its bindless handle
+        if (oldHandle != 0)
+        {
+            Renderer::GetTextureTable()->Retire(oldHandle);
+        }
+
+        entry.residentLevel = level;
+        m_Stats.residentBytes += GetChainSize(image, level);
+    }
+
+    void TextureStreamer::UploadLevel(Texture2D &texture, uint32_t mip, const std::vector<uint8_t> &data)
+    {
+        // Without a pixel unpack buffer the driver copies client memory before the call returns
+        if (m_Staging && m_Staging->GetFrameBytes() + kStagingAlignment + data.size() <= m_Staging->GetRegionSize())
+        {
+            const StreamAllocation staging = m_Staging->Write(data.data(), data.size(), kStagingAlignment);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging.buffer);
+            texture.UploadCompressed(mip, reinterpret_cast<const void *>(staging.offset), data.size());
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            return;
+        }
+
+        texture.UploadCompressed(mip, data.data(), data.size());
+    }
+
+    bool TextureStreamer::Evict(size_t bytes, const Entry *keep)
+    {
+        std::vector<Entry *> candidates;
+        for (auto &[key, entry] : m_Entries)
+        {
+            if (&entry != keep && entry.lastUsedFrame != m_Frame && entry.residentLevel < entry.tailLevel)
+            {
+                candidates.push_back(&entry);
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const Entry *a, const Entry *b) { return a->lastUsedFrame < b->lastUsedFrame; });
+
+        size_t freed = 0;
+        for (Entry *entry : candidates)
+        {
+            if (freed >= bytes)
+            {
+                break;
+            }
+
+            const size_t before = GetChainSize(*entry->image, entry->residentLevel);
+            SetResidentLevel(*entry, *entry->texture.lock(), entry->tailLevel);
+            freed += before - GetChainSize(*entry->image, entry->residentLevel);
+            ++m_Stats.evictions;
+        }
+        return freed >= bytes;
+    }
+
+    void TextureStreamer::CollectExpired()
+    {
+        for (auto it = m_Entries.begin(); it != m_Entries.end();)
+        {
+            const Entry &entry = it->second;
+            if (!entry.texture.expired())
+            {
+                ++it;
+                continue;
+            }
+
+            m_Stats.residentBytes -= GetChainSize(*entry.image, entry.residentLevel);
+            m_Stats.fullBytes -= GetChainSize(*entry.image, 0);
+            --m_Stats.textureCount;
+            it = m_Entries.erase(it);
+        }
+    }
+
+    size_t TextureStreamer::GetChainSize(const CompressedImage &image, uint32_t firstLevel)
+    {
+        size_t size = 0;
+        for (size_t level = firstLevel; level < image.levels.size(); ++level)
+        {
+            size += image.levels[level].size();
+        }
+        return size;
+    }
+}
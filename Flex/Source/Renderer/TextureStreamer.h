@@ -0,0 +1,101 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#ifndef TEXTURE_STREAMER_H
+#define TEXTURE_STREAMER_H
+
+#include "Core/Types.h"
+#include "TextureCompressor.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace flex
+{
+    class Texture2D;
+    class StreamingBuffer;
+
+    struct TextureStreamerStats
+    {
+        uint32_t textureCount = 0;
+        uint64_t residentBytes = 0;
+        uint64_t fullBytes = 0;  // With every texture at full resolution
+        uint32_t promotions = 0; // Since the last ResetStats
+        uint32_t evictions = 0;
+    };
+
+    // Mip residency of block compressed textures under a VRAM budget. A streamed texture's storage only holds
+    // its levels from residentLevel down, allocated as a smaller immutable texture, so the UVs stay the same.
+    // The CPU keeps the whole chain. Draws request the level their screen space texel density needs,
+    // Update reallocates the storage towards it and demotes the least recently used textures when over budget.
+    // Levels at or below kTailSize texels are always resident.
+    // Only used with bindless textures: without them the texture table copies every texture into an array bucket
+    // per size, and each reallocation would move it to another bucket and use up the few there are
+    class TextureStreamer
+    {
+    public:
+        static constexpr uint32_t kTailSize = 128;
+        static constexpr size_t kMaxUploadBytes = 16u << 20; // Per Update, past the first promotion
+
+        // Levels are uploaded through staging while its frame region has room, from client memory otherwise.
+        // The owner of staging fences it (TextureLoader::Update)
+        explicit TextureStreamer(size_t budgetBytes, StreamingBuffer *staging = nullptr);
+
+        // Whether a texture with image is handed to Register rather than uploaded as a whole
+        static bool CanStream(const CompressedImage &image, bool bindless) { return bindless && image.levels.size() > 1; }
+
+        // Takes over a texture with no storage yet, allocates and uploads the tail of image
+        void Register(const Ref<Texture2D> &texture, const Ref<const CompressedImage> &image);
+
+        // A draw samples texture this frame, covering uvPerViewport UV units over the viewport height.
+        // Textures that aren't streamed are ignored
+        void Request(const Texture2D *texture, float uvPerViewport);
+
+        // GL thread, once per frame after the draws
+        void Update();
+
+        void SetBudget(size_t budgetBytes) { m_Budget = budgetBytes; }
+        size_t GetBudget() const { return m_Budget; }
+        void SetViewportHeight(uint32_t height) { m_ViewportHeight = height; }
+
+        const TextureStreamerStats &GetStats() const { return m_Stats; }
+        void ResetStats() { m_Stats.promotions = 0; m_Stats.evictions = 0; }
+
+        // Finest level worth sampling for a texture of size texels drawn across uvPerViewport over viewportHeight pixels
+        static uint32_t SelectMipLevel(uint32_t size, float uvPerViewport, uint32_t viewportHeight);
+        // First level of a width x height chain that fits in kTailSize
+        static uint32_t GetTailLevel(uint32_t width, uint32_t height);
+
+    private:
+        struct Entry
+        {
+            std::weak_ptr<Texture2D> texture;
+            Ref<const CompressedImage> image;
+            uint32_t residentLevel = 0;
+            uint32_t tailLevel = 0;
+            uint32_t wantedLevel = 0; // Finest level requested this frame
+            uint64_t lastUsedFrame = 0;
+        };
+
+        // Reallocates the texture with levels [level, end) of its image, reusing the resident ones on the GPU
+        void SetResidentLevel(Entry &entry, Texture2D &texture, uint32_t level);
+        void UploadLevel(Texture2D &texture, uint32_t mip, const std::vector<uint8_t> &data);
+        // Demotes textures not drawn this frame, least recently used first, until bytes are freed.
+        // Returns false when that wasn't enough
+        bool Evict(size_t bytes, const Entry *keep);
+        void CollectExpired();
+
+        static size_t GetChainSize(const CompressedImage &image, uint32_t firstLevel);
+
+        std::unordered_map<const Texture2D *, Entry> m_Entries;
+        StreamingBuffer *m_Staging = nullptr;
+        size_t m_Budget = 0;
+        uint32_t m_ViewportHeight = 1080;
+        uint64_t m_Frame = 1;
+        TextureStreamerStats m_Stats;
+    };
+}
+
+#endif
@@ -0,0 +1,313 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#include "TextureTable.h"
+#include "Texture.h"
+#include "RenderState.h"
+
+#include <glad/glad.h>
+#include <SDL3/SDL_video.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace flex
+{
+    namespace
+    {
+        // The bundled glad loader does not include GL_ARB_bindless_texture
+        using PFNGetTextureHandle = GLuint64 (APIENTRY *)(GLuint texture);
+        using PFNMakeTextureHandleResident = void (APIENTRY *)(GLuint64 handle);
+        using PFNMakeTextureHandleNonResident = void (APIENTRY *)(GLuint64 handle);
+
+        PFNGetTextureHandle s_GetTextureHandle = nullptr;
+        PFNMakeTextureHandleResident s_MakeTextureHandleResident = nullptr;
+        PFNMakeTextureHandleNonResident s_MakeTextureHandleNonResident = nullptr;
+
+        bool LoadBindlessFunctions()
+        {
+            if (!HasGLExtension("GL_ARB_bindless_texture"))
+            {
+                return false;
+            }
+
+            s_GetTextureHandle = reinterpret_cast<PFNGetTextureHandle>(SDL_GL_GetProcAddress("glGetTextureHandleARB"));
+            s_MakeTextureHandleResident = reinterpret_cast<PFNMakeTextureHandleResident>(SDL_GL_GetProcAddress("glMakeTextureHandleResidentARB"));
+            s_MakeTextureHandleNonResident = reinterpret_cast<PFNMakeTextureHandleNonResident>(SDL_GL_GetProcAddress("glMakeTextureHandleNonResidentARB"));
+            return s_GetTextureHandle && s_MakeTextureHandleResident && s_MakeTextureHandleNonResident;
+        }
+
+        uint64_t PackArrayRef(uint32_t arrayIndex, uint32_t layer)
+        {
+            // Read as uvec2(array, layer) by the shader
+            return (static_cast<uint64_t>(layer) << 32) | arrayIndex;
+        }
+    }
+
+    TextureTable::TextureTable()
+    {
+        m_Bindless = LoadBindlessFunctions();
+        glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &m_MaxArrayLayers);
+
+        std::cout << "Material textures: " << (m_Bindless ? "bindless handles" : "texture arrays") << '\n';
+    }
+
+    TextureTable::~TextureTable()
+    {
+        // GL defers deleting textures pending draws still use, only their handles need the fence
+        ReleaseRetired(true);
+        for (auto &[texture, entry] : m_Entries)
+        {
+            Release(entry);
+        }
+
+        for (const TextureArray &array : m_Arrays)
+        {
+            RenderState::DeleteTexture(array.handle);
+        }
+    }
+
+    uint64_t TextureTable::Acquire(const Ref<Texture2D> &texture, const Ref<Texture2D> &fallback)
+    {
+        auto it = m_Entries.find(texture.get());
+        if (it != m_Entries.end())
+        {
+            Entry &entry = it->second;
+            if (entry.texture.lock() == texture && entry.glHandle == texture->GetHandle())
+            {
+                return entry.ref;
+            }
+
+            // Address reused by a new texture, or the texture was recreated
+            Release(entry);
+            return Register(texture, fallback, entry);
+        }
+
+        return Register(texture, fallback, m_Entries[texture.get()]);
+    }
+
+    void TextureTable::Bind()
+    {
+        for (uint32_t i = 0; i < m_Arrays.size(); ++i)
+        {
+            RenderState::BindTextureUnit(TEXTURE_BINDING_LOC_MATERIAL_ARRAYS + i, m_Arrays[i].handle);
+        }
+    }
+
+    uint64_t TextureTable::Register(const Ref<Texture2D> &texture, const Ref<Texture2D> &fallback, Entry &entry)
+    {
+        entry.texture = texture;
+        entry.glHandle = texture->GetHandle();
+
+        if (m_Bindless)
+        {
+            // Sampler state is frozen once a handle exists
+            entry.ref = s_GetTextureHandle(entry.glHandle);
+            s_MakeTextureHandleResident(entry.ref);
+            return entry.ref;
+        }
+
+        const uint32_t arrayIndex = FindOrCreateArray(*texture);
+        if (arrayIndex == UINT32_MAX)
+        {
+            // Sampled as the neutral fallback rather than whatever sits in another array's layer
+            entry.array = UINT32_MAX;
+            entry.ref = fallback && fallback != texture ? Acquire(fallback) : PackArrayRef(0, 0);
+            return entry.ref;
+        }
+
+        const uint32_t layer = AllocateLayer(arrayIndex);
+        const TextureArray &array = m_Arrays[arrayIndex];
+        for (uint32_t level = 0; level < array.mipLevels; ++level)
+        {
+            glCopyImageSubData(entry.glHandle, GL_TEXTURE_2D, static_cast<GLint>(level), 0, 0, 0,
+                array.handle, GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level), 0, 0, static_cast<GLint>(layer),
+                std::max(array.width >> level, 1), std::max(array.height >> level, 1), 1);
+        }
+
+        entry.array = arrayIndex;
+        entry.layer = layer;
+        entry.ref = PackArrayRef(arrayIndex, layer);
+        return entry.ref;
+    }
+
+    void TextureTable::Release(Entry &entry)
+    {
+        if (m_Bindless)
+        {
+            // Handles of deleted textures are gone with the texture
+            const Ref<Texture2D> texture = entry.texture.lock();
+            if (texture && texture->GetHandle() == entry.glHandle)
+            {
+                s_MakeTextureHandleNonResident(entry.ref);
+            }
+        }
+        else if (entry.array != UINT32_MAX)
+        {
+            m_Arrays[entry.array].freeLayers.push_back(entry.layer);
+            entry.array = UINT32_MAX;
+        }
+
+        entry.texture.reset();
+        entry.ref = 0;
+    }
+
+    void TextureTable::CollectExpired()
+    {
+        std::erase_if(m_Entries, [this](auto &pair)
+        {
+            if (!pair.second.texture.expired())
+            {
+                return false;
+            }
+
+            Release(pair.second);
+            return true;
+        });
+
+        ReleaseRetired(false);
+    }
+
+    void TextureTable::Retire(uint32_t texture)
+    {
+        // The entry keeps the old GL handle until its material acquires the texture again, and Release
+        // leaves handles of replaced storage alone, so the residency ends here
+        uint64_t residentHandle = 0;
+        if (m_Bindless)
+        {
+            for (const auto &[key, entry] : m_Entries)
+            {
+                if (entry.glHandle == texture && entry.ref != 0)
+                {
+                    residentHandle = entry.ref;
+                    break;
+                }
+            }
+        }
+
+        m_Retired.push_back({ texture, residentHandle, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) });
+    }
+
+    void TextureTable::ReleaseRetired(bool force)
+    {
+        std::erase_if(m_Retired, [force](const RetiredTexture &retired)
+        {
+            if (!force && glClientWaitSync(retired.fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+            {
+                return false;
+            }
+
+            glDeleteSync(retired.fence);
+            if (retired.residentHandle != 0)
+            {
+                s_MakeTextureHandleNonResident(retired.residentHandle);
+            }
+            RenderState::DeleteTexture(retired.texture);
+            return true;
+        });
+    }
+
+    uint32_t TextureTable::FindOrCreateArray(const Texture2D &texture)
+    {
+        const int width = static_cast<int>(texture.GetWidth());
+        const int height = static_cast<int>(texture.GetHeight());
+
+        for (uint32_t i = 0; i < m_Arrays.size(); ++i)
+        {
+            const TextureArray &array = m_Arrays[i];
+            if (array.width == width && array.height == height && array.format == texture.GetFormat() && array.mipLevels == texture.GetMipLevels())
+            {
+                return i;
+            }
+        }
+
+        if (m_Arrays.size() == MAX_MATERIAL_TEXTURE_ARRAYS)
+        {
+            if (!m_ArrayLimitLogged)
+            {
+                std::cerr << "TextureTable: more than " << MAX_MATERIAL_TEXTURE_ARRAYS << " texture sizes in use, "
+                    << "textures of further sizes (first " << width << "x" << height << ") are drawn with their fallback\n";
+                m_ArrayLimitLogged = true;
+            }
+            return UINT32_MAX;
+        }
+
+        TextureArray array;
+        array.width = width;
+        array.height = height;
+        array.format = texture.GetFormat();
+        array.mipLevels = texture.GetMipLevels();
+
+        glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &array.handle);
+        array.capacity = std::min(8, m_MaxArrayLayers);
+        glTextureStorage3D(array.handle, static_cast<GLsizei>(array.mipLevels), ToGLInternalFormat(array.format), width, height, static_cast<GLsizei>(array.capacity));
+
+        // Sampler state follows the first texture of this size
+        const uint32_t source = texture.GetHandle();
+        for (GLenum parameter : { GL_TEXTURE_MIN_FILTER, GL_TEXTURE_MAG_FILTER, GL_TEXTURE_WRAP_S, GL_TEXTURE_WRAP_T })
+        {
+            GLint value = 0;
+            glGetTextureParameteriv(source, parameter, &value);
+            glTextureParameteri(array.handle, parameter, value);
+        }
+        GLfloat anisotropy = 1.0f;
+        glGetTextureParameterfv(source, GL_TEXTURE_MAX_ANISOTROPY, &anisotropy);
+        glTextureParameterf(array.handle, GL_TEXTURE_MAX_ANISOTROPY, anisotropy);
+
+        m_Arrays.push_back(std::move(array));
+        return static_cast<uint32_t>(m_Arrays.size() - 1);
+    }
+
+    uint32_t TextureTable::AllocateLayer(uint32_t arrayIndex)
+    {
+        if (m_Arrays[arrayIndex].freeLayers.empty() && m_Arrays[arrayIndex].layerCount == m_Arrays[arrayIndex].capacity)
+        {
+            CollectExpired();
+        }
+
+        TextureArray &array = m_Arrays[arrayIndex];
+        if (!array.freeLayers.empty())
+        {
+            const uint32_t layer = array.freeLayers.back();
+            array.freeLayers.pop_back();
+            return layer;
+        }
+
+        if (array.layerCount == array.capacity)
+        {
+            GrowArray(array);
+        }
+
+        return array.layerCount++;
+    }
+
+    void TextureTable::GrowArray(TextureArray &array)
+    {
+        const uint32_t newCapacity = std::min<uint32_t>(array.capacity * 2, static_cast<uint32_t>(m_MaxArrayLayers));
+        assert(newCapacity > array.capacity && "Texture array layer limit reached!");
+
+        uint32_t handle = 0;
+        glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &handle);
+        glTextureStorage3D(handle, static_cast<GLsizei>(array.mipLevels), ToGLInternalFormat(array.format), array.width, array.height, static_cast<GLsizei>(newCapacity));
+
+        for (GLenum parameter : { GL_TEXTURE_MIN_FILTER, GL_TEXTURE_MAG_FILTER, GL_TEXTURE_WRAP_S, GL_TEXTURE_WRAP_T })
+        {
+            GLint value = 0;
+            glGetTextureParameteriv(array.handle, parameter, &value);
+            glTextureParameteri(handle, parameter, value);
+        }
+        GLfloat anisotropy = 1.0f;
+        glGetTextureParameterfv(array.handle, GL_TEXTURE_MAX_ANISOTROPY, &anisotropy);
+        glTextureParameterf(handle, GL_TEXTURE_MAX_ANISOTROPY, anisotropy);
+
+        for (uint32_t level = 0; level < array.mipLevels; ++level)
+        {
+            glCopyImageSubData(array.handle, GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level), 0, 0, 0,
+                handle, GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level), 0, 0, 0,
+                std::max(array.width >> level, 1), std::max(array.height >> level, 1), static_cast<GLsizei>(array.layerCount));
+        }
+
+        RenderState::DeleteTexture(array.handle);
+        array.handle = handle;
+        array.capacity = newCapacity;
+    }
+}
@@ -0,0 +1,95 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#ifndef TEXTURE_TABLE_H
+#define TEXTURE_TABLE_H
+
+#include "Core/Types.h"
+#include "RendererCommon.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace flex
+{
+    class Texture2D;
+
+    // Turns material textures into 64 bit references shaders can sample without per draw binds.
+    // With GL_ARB_bindless_texture the reference is a resident texture handle. Otherwise each texture is
+    // copied into a layer of a GL_TEXTURE_2D_ARRAY shared by textures of the same size, format and mip count, and the
+    // reference packs (array index, layer). pbr.frag decodes both in SampleMaterialTexture.
+    class TextureTable
+    {
+    public:
+        TextureTable();
+        ~TextureTable();
+
+        // Registers the texture on first use, later calls return the cached reference.
+        // Array layers are a copy, so texture data changed after this point is not picked up.
+        // fallback stands in when every texture array slot is taken by other sizes
+        uint64_t Acquire(const Ref<Texture2D> &texture, const Ref<Texture2D> &fallback = nullptr);
+
+        // Frees the layers and entries of textures that were destroyed since they were registered,
+        // and deletes retired textures the GPU is done with. Once per frame
+        void CollectExpired();
+
+        // Deletes a GL texture replaced by new storage (TextureStreamer) once the draws submitted so far completed.
+        // Material records may still hold its bindless handle, which stays resident until then
+        void Retire(uint32_t texture);
+
+        // Binds the texture arrays to TEXTURE_BINDING_LOC_MATERIAL_ARRAYS, nothing to do when bindless
+        void Bind();
+
+        bool IsBindless() const { return m_Bindless; }
+        uint32_t GetTextureCount() const { return static_cast<uint32_t>(m_Entries.size()); }
+        uint32_t GetArrayCount() const { return static_cast<uint32_t>(m_Arrays.size()); }
+
+    private:
+        struct Entry
+        {
+            std::weak_ptr<Texture2D> texture;
+            uint32_t glHandle = 0; // Changes when the texture is resized
+            uint64_t ref = 0;
+            uint32_t array = UINT32_MAX;
+            uint32_t layer = 0;
+        };
+
+        struct TextureArray
+        {
+            uint32_t handle = 0;
+            int width = 0;
+            int height = 0;
+            Format format = Format::RGBA8;
+            uint32_t mipLevels = 1;
+            uint32_t capacity = 0;
+            uint32_t layerCount = 0;
+            std::vector<uint32_t> freeLayers;
+        };
+
+        struct RetiredTexture
+        {
+            uint32_t texture;
+            uint64_t residentHandle; // 0 when it was never registered
+            GLsync fence;
+        };
+
+        uint64_t Register(const Ref<Texture2D> &texture, const Ref<Texture2D> &fallback, Entry &entry);
+        void Release(Entry &entry);
+        // force skips the fence check, for shutdown
+        void ReleaseRetired(bool force);
+
+        uint32_t FindOrCreateArray(const Texture2D &texture);
+        uint32_t AllocateLayer(uint32_t arrayIndex);
+        void GrowArray(TextureArray &array);
+
+        std::unordered_map<const Texture2D *, Entry> m_Entries;
+        std::vector<TextureArray> m_Arrays;
+        std::vector<RetiredTexture> m_Retired;
+
+        bool m_Bindless = false;
+        bool m_ArrayLimitLogged = false;
+        int m_MaxArrayLayers = 256;
+    };
+}
+
+#endif
@@ -1,44 +1,56 @@
 // Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
 
 #include "UniformBuffer.h"
+#include "Renderer.h"
+#include "StreamingBuffer.h"
+#include "RenderState.h"
+
 #include <glad/glad.h>
 
 #include <cassert>
+#include <cstring>
 
 namespace flex
 {
-    
     UniformBuffer::UniformBuffer(size_t size, uint32_t index)
         : m_BindIndex(index)
     {
-        glCreateBuffers(1, &m_Handle);
-        glBindBuffer(GL_UNIFORM_BUFFER, m_Handle);
-        glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
-        glBindBufferBase(GL_UNIFORM_BUFFER, m_BindIndex, m_Handle);
-    
-        assert(m_Handle != 0 && "Failed to create Uniform buffer!");
-
-        assert(glGetError() == GL_NO_ERROR);
+        // std140 blocks are padded to a vec4, bound ranges must cover the padded size
+        m_Data.resize((size + 15) & ~size_t(15), 0);
+
+        assert(Renderer::GetStreamingBuffer() && "Uniform buffers need Renderer::Init first!");
     }
-    
-    UniformBuffer::~UniformBuffer()
+
+    void UniformBuffer::SetData(const void *data, size_t size, size_t offset)
     {
-        glDeleteBuffers(1, &m_Handle);
+        assert(offset + size <= m_Data.size());
+        std::memcpy(m_Data.data() + offset, data, size);
+        Stream();
     }
-    
-    void UniformBuffer::SetData(void *data, size_t size, size_t offset)
+
+    void UniformBuffer::Bind()
     {
-        glBindBuffer(GL_UNIFORM_BUFFER, m_Handle);
-        glBindBufferBase(GL_UNIFORM_BUFFER, m_BindIndex, m_Handle);
-        glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+        StreamingBuffer *stream = Renderer::GetStreamingBuffer();
+        if (m_Frame != stream->GetFrameIndex())
+        {
+            Stream();
+            return;
+        }
+
+        RenderState::BindBufferRange(GL_UNIFORM_BUFFER, m_BindIndex, m_Buffer, m_Offset, m_Data.size());
     }
-    
-    void UniformBuffer::Bind()
+
+    void UniformBuffer::Stream()
     {
-        glBindBuffer(GL_UNIFORM_BUFFER, m_Handle);
-        glBindBufferBase(GL_UNIFORM_BUFFER, m_BindIndex, m_Handle);
+        StreamingBuffer *stream = Renderer::GetStreamingBuffer();
+        const StreamAllocation allocation = stream->Write(m_Data.data(), m_Data.size(), stream->GetUniformAlignment());
+        stream->BindRange(GL_UNIFORM_BUFFER, m_BindIndex, allocation, m_Data.size());
+
+        m_Buffer = allocation.buffer;
+        m_Offset = allocation.offset;
+        m_Frame = stream->GetFrameIndex();
     }
-    
+
     std::shared_ptr<UniformBuffer> UniformBuffer::Create(size_t size, uint32_t index)
     {
         return std::make_shared<UniformBuffer>(size, index);
@@ -5,25 +5,33 @@
 
 #include <memory>
 #include <stdint.h>
+#include <vector>
 
 namespace flex
 {
+    // Uniform block backed by Renderer's streaming buffer. SetData writes a fresh copy of the block
+    // and binds it with glBindBufferRange, so uploads never stall on a block the GPU is still reading.
     class UniformBuffer
     {
     public:
         UniformBuffer(size_t size, uint32_t index);
-        ~UniformBuffer();
 
-        void SetData(void *data, size_t size, size_t offset = 0);
+        void SetData(const void *data, size_t size, size_t offset = 0);
 
+        // Rebinds the last upload, streams the block again if it was written in an earlier frame
         void Bind();
 
         static std::shared_ptr<UniformBuffer> Create(size_t size, uint32_t index = 0);
 
     private:
-        uint32_t m_Handle;
+        void Stream();
+
+        std::vector<uint8_t> m_Data; // CPU copy so partial updates and later frames can re-stream the block
         uint32_t m_BindIndex;
+        uint32_t m_Buffer = 0;
+        size_t m_Offset = 0;
+        uint64_t m_Frame = UINT64_MAX;
     };
 }
 
-#endif
\ No newline at end of file
+#endif
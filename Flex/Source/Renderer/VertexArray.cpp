@@ -3,6 +3,7 @@
 #include "VertexArray.h"
 #include "IndexBuffer.h"
 #include "VertexBuffer.h"
+#include "RenderState.h"
 
 #include <glad/glad.h>
 
@@ -11,7 +12,7 @@ namespace flex
     VertexArray::VertexArray()
     {
         glCreateVertexArrays(1, &m_Handle);
-        glBindVertexArray(m_Handle);
+        RenderState::BindVertexArray(m_Handle);
 
         assert(m_Handle != 0 && "Failed to create Vertex array!");
     }
@@ -31,11 +32,11 @@ namespace flex
         m_VertexBuffer = nullptr;
         m_IndexBuffer = nullptr;
 
-        glDeleteVertexArrays(1, &m_Handle);
+        RenderState::DeleteVertexArray(m_Handle);
     }
 
     void VertexArray::Bind()
     {
-        glBindVertexArray(m_Handle);
+        RenderState::BindVertexArray(m_Handle);
     }
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 // Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
 
 #include "VertexBuffer.h"
+#include "RenderState.h"
 
 #include <glad/glad.h>
 
@@ -26,7 +27,7 @@ namespace flex
 
     VertexBuffer::~VertexBuffer()
     {
-        glDeleteBuffers(1, &m_Handle);
+        RenderState::DeleteBuffer(m_Handle);
     }
 
     void VertexBuffer::SetAttributes(std::initializer_list<VertexAttribute> attributes, uint32_t stride)
@@ -62,6 +63,17 @@ namespace flex
                     totalElementBytes += elementCount * sizeof(float);
                     break;
                 }
+                case VertexAttribType::VECTOR_SHORT_2:
+                case VertexAttribType::VECTOR_BYTE_4:
+                case VertexAttribType::VECTOR_UBYTE_4:
+                case VertexAttribType::VECTOR_HALF_2:
+                {
+                    glVertexAttribPointer(index, elementCount, glElementType, it->normalized, stride,
+                        (const void *)(intptr_t)(totalElementBytes));
+
+                    totalElementBytes += elementCount * GetVertexElementSize(it->type);
+                    break;
+                }
                 case VertexAttribType::MATRIX_FLOAT_3X3:
                 case VertexAttribType::MATRIX_FLOAT_4X4:
                 {
@@ -26,6 +26,12 @@ namespace flex
 
         MATRIX_FLOAT_3X3,
         MATRIX_FLOAT_4X4,
+
+        // Packed types, read as floats. Set VertexAttribute::normalized for snorm / unorm
+        VECTOR_SHORT_2,
+        VECTOR_BYTE_4,
+        VECTOR_UBYTE_4,
+        VECTOR_HALF_2,
     };
 
     static uint8_t GetVertexElementCount(VertexAttribType type)
@@ -44,6 +50,11 @@ namespace flex
 
             case VertexAttribType::MATRIX_FLOAT_3X3: return 3;
             case VertexAttribType::MATRIX_FLOAT_4X4: return 4;
+
+            case VertexAttribType::VECTOR_SHORT_2: return 2;
+            case VertexAttribType::VECTOR_BYTE_4: return 4;
+            case VertexAttribType::VECTOR_UBYTE_4: return 4;
+            case VertexAttribType::VECTOR_HALF_2: return 2;
         }
 
         assert(false && "Invalid type");
@@ -65,12 +76,30 @@ namespace flex
             case VertexAttribType::VECTOR_FLOAT_4:
             case VertexAttribType::MATRIX_FLOAT_3X3:
             case VertexAttribType::MATRIX_FLOAT_4X4: return GL_FLOAT;
+
+            case VertexAttribType::VECTOR_SHORT_2: return GL_SHORT;
+            case VertexAttribType::VECTOR_BYTE_4: return GL_BYTE;
+            case VertexAttribType::VECTOR_UBYTE_4: return GL_UNSIGNED_BYTE;
+            case VertexAttribType::VECTOR_HALF_2: return GL_HALF_FLOAT;
         }
 
         assert(false && "Invalid type");
         return 0;
     }
 
+    // Size of one component in bytes
+    static uint8_t GetVertexElementSize(VertexAttribType type)
+    {
+        switch (GetGLVertexElementType(type))
+        {
+            case GL_BYTE:
+            case GL_UNSIGNED_BYTE: return 1;
+            case GL_SHORT:
+            case GL_HALF_FLOAT: return 2;
+            default: return 4;
+        }
+    }
+
     struct VertexAttribute
     {
         VertexAttribType type;
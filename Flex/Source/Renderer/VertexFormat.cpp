@@ -0,0 +1,70 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#include "VertexFormat.h"
+#include "Mesh.h"
+
+#include <glm/gtc/packing.hpp>
+
+#include <cmath>
+
+namespace flex
+{
+    static glm::vec2 SignNotZero(const glm::vec2 &v)
+    {
+        return { v.x >= 0.0f ? 1.0f : -1.0f, v.y >= 0.0f ? 1.0f : -1.0f };
+    }
+
+    glm::vec2 EncodeOctahedral(const glm::vec3 &n)
+    {
+        const float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+        if (l1 <= 0.0f)
+        {
+            return glm::vec2(0.0f, 0.0f);
+        }
+
+        glm::vec2 e = glm::vec2(n.x, n.y) / l1;
+        if (n.z < 0.0f)
+        {
+            e = (1.0f - glm::abs(glm::vec2(e.y, e.x))) * SignNotZero(e);
+        }
+        return e;
+    }
+
+    glm::vec3 DecodeOctahedral(const glm::vec2 &e)
+    {
+        glm::vec3 n(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+        if (n.z < 0.0f)
+        {
+            const glm::vec2 folded = (1.0f - glm::abs(glm::vec2(n.y, n.x))) * SignNotZero(glm::vec2(n.x, n.y));
+            n.x = folded.x;
+            n.y = folded.y;
+        }
+        return glm::normalize(n);
+    }
+
+    PackedVertex PackVertex(const Vertex &vertex)
+    {
+        PackedVertex packed;
+
+        const glm::vec2 normal = EncodeOctahedral(vertex.normal);
+        packed.normal[0] = static_cast<int16_t>(glm::packSnorm1x16(normal.x));
+        packed.normal[1] = static_cast<int16_t>(glm::packSnorm1x16(normal.y));
+
+        // Left handed when the stored bitangent points away from cross(normal, tangent)
+        const glm::vec2 tangent = EncodeOctahedral(vertex.tangent);
+        const float sign = glm::dot(glm::cross(vertex.normal, vertex.tangent), vertex.bitangent) < 0.0f ? -1.0f : 1.0f;
+        packed.tangent[0] = static_cast<int8_t>(glm::packSnorm1x8(tangent.x));
+        packed.tangent[1] = static_cast<int8_t>(glm::packSnorm1x8(tangent.y));
+        packed.tangent[2] = static_cast<int8_t>(glm::packSnorm1x8(sign));
+        packed.tangent[3] = 0;
+
+        packed.uv[0] = glm::packHalf1x16(vertex.uv.x);
+        packed.uv[1] = glm::packHalf1x16(vertex.uv.y);
+        return packed;
+    }
+
+    uint32_t PackColor(const glm::vec3 &color)
+    {
+        return glm::packUnorm4x8(glm::vec4(color, 1.0f));
+    }
+}
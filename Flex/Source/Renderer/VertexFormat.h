@@ -0,0 +1,40 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+
+namespace flex
+{
+    struct Vertex;
+
+    // GPU side layout of a static mesh vertex, stored in streams by the GeometryPool.
+    // Positions stay full precision in their own stream so depth only passes fetch 12 bytes per vertex,
+    // normal, tangent and UV are packed into 12 bytes and decoded in pbr.vert / pbr_instanced.vert.
+    // Vertex colors are an optional third stream (PackColor), only created once a mesh has non white colors
+    struct PackedVertex
+    {
+        int16_t normal[2];  // Octahedral, snorm16
+        int8_t tangent[4];  // Octahedral xy, bitangent sign in z, snorm8
+        uint16_t uv[2];     // Half float
+    };
+    static_assert(sizeof(PackedVertex) == 12);
+
+    // Opaque white, what the shaders read for meshes without vertex colors
+    constexpr uint32_t kPackedWhite = 0xFFFFFFFFu;
+
+    // Unit vector to the [-1, 1] square, the lower hemisphere is folded over the diagonals
+    glm::vec2 EncodeOctahedral(const glm::vec3 &n);
+    glm::vec3 DecodeOctahedral(const glm::vec2 &e);
+
+    // The bitangent is rebuilt as cross(normal, tangent) * sign
+    PackedVertex PackVertex(const Vertex &vertex);
+
+    // RGBA8 unorm, alpha is always 1
+    uint32_t PackColor(const glm::vec3 &color);
+}
+
+#endif
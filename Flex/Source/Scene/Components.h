@@ -20,6 +20,31 @@ namespace flex
 {
     class Scene;
 
+    struct TransformComponent
+    {
+        glm::vec3 position = { 0.0f, 0.0f, 0.0f };
+        glm::vec3 rotation = { 0.0f, 0.0f, 0.0f }; // Euler angles in degrees
+        glm::vec3 scale = { 1.0f, 1.0f, 1.0f };
+
+        // Set whenever position/rotation/scale or the parent changes,
+        // cleared by Scene::UpdateTransforms once the world matrix is rebuilt
+        bool dirty = true;
+        
+        TransformComponent() = default;
+    };
+
+    // Cached matrices resolved once per frame by Scene::UpdateTransforms.
+    // Added automatically alongside TransformComponent, render paths read from here
+    struct WorldTransformComponent
+    {
+        glm::mat4 local = glm::mat4(1.0f);
+        glm::mat4 world = glm::mat4(1.0f);
+        uint32_t updateFrame = 0; // Scene transform frame of the last world rebuild
+        entt::entity parent = entt::null; // Nearest transformed ancestor at the last hierarchy rebuild
+
+        WorldTransformComponent() = default;
+    };
+
     struct TagComponent
     {
         std::string name;
@@ -43,6 +68,7 @@ namespace flex
             {
                 auto& tag = scene->GetComponent<TagComponent>(e);
                 tag.parent = uuid;
+                MarkTransformDirty(e);
             }
 
             children.insert(childID);
@@ -58,20 +84,22 @@ namespace flex
                 {
                     auto& tag = scene->GetComponent<TagComponent>(e);
                     tag.parent = UUID(0);
+                    MarkTransformDirty(e);
                 }
 
                 children.erase(it);
             }
         }
-    };
 
-    struct TransformComponent
-    {
-        glm::vec3 position = { 0.0f, 0.0f, 0.0f };
-        glm::vec3 rotation = { 0.0f, 0.0f, 0.0f }; // Euler angles in degrees
-        glm::vec3 scale = { 1.0f, 1.0f, 1.0f };
-        
-        TransformComponent() = default;
+    private:
+        void MarkTransformDirty(entt::entity e)
+        {
+            scene->MarkHierarchyDirty();
+            if (scene->HasComponent<TransformComponent>(e))
+            {
+                scene->GetComponent<TransformComponent>(e).dirty = true;
+            }
+        }
     };
 
 	struct RigidbodyComponent
@@ -124,6 +152,16 @@ namespace flex
         
         MeshComponent() = default;
     };
+
+    // Links a renderable to its leaf in one of the Scene's DynamicAABBTrees, maintained by the Scene
+    struct SpatialProxyComponent
+    {
+        AABB worldBounds;
+        BoundingSphere worldSphere;
+        const Mesh* mesh = nullptr;
+        int32_t proxyId = -1;
+        bool dynamic = false; // Lives in the dynamic tree (non static rigidbody)
+    };
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,362 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#include "DynamicAABBTree.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace flex
+{
+    // Absolute margin added around every leaf
+    static constexpr float kAABBMargin = 0.1f;
+    // Leaves are pushed further along their motion to absorb the next few frames of movement
+    static constexpr float kDisplacementMultiplier = 2.0f;
+
+    DynamicAABBTree::DynamicAABBTree()
+    {
+        m_Nodes.reserve(64);
+    }
+
+    void DynamicAABBTree::Clear()
+    {
+        m_Nodes.clear();
+        m_Root = NullNode;
+        m_FreeList = NullNode;
+        m_ProxyCount = 0;
+    }
+
+    int32_t DynamicAABBTree::AllocateNode()
+    {
+        int32_t nodeId;
+        if (m_FreeList != NullNode)
+        {
+            nodeId = m_FreeList;
+            m_FreeList = m_Nodes[nodeId].parent;
+        }
+        else
+        {
+            nodeId = static_cast<int32_t>(m_Nodes.size());
+            m_Nodes.emplace_back();
+        }
+
+        m_Nodes[nodeId] = Node();
+        m_Nodes[nodeId].height = 0;
+        return nodeId;
+    }
+
+    void DynamicAABBTree::FreeNode(int32_t nodeId)
+    {
+        m_Nodes[nodeId].parent = m_FreeList;
+        m_Nodes[nodeId].height = -1;
+        m_FreeList = nodeId;
+    }
+
+    int32_t DynamicAABBTree::CreateProxy(const AABB& aabb, uint32_t userData)
+    {
+        const int32_t proxyId = AllocateNode();
+        const glm::vec3 margin(kAABBMargin);
+        m_Nodes[proxyId].aabb = AABB(aabb.min - margin, aabb.max + margin);
+        m_Nodes[proxyId].userData = userData;
+
+        InsertLeaf(proxyId);
+        ++m_ProxyCount;
+        return proxyId;
+    }
+
+    void DynamicAABBTree::DestroyProxy(int32_t proxyId)
+    {
+        assert(proxyId >= 0 && proxyId < static_cast<int32_t>(m_Nodes.size()));
+        assert(m_Nodes[proxyId].IsLeaf());
+
+        RemoveLeaf(proxyId);
+        FreeNode(proxyId);
+        --m_ProxyCount;
+    }
+
+    bool DynamicAABBTree::MoveProxy(int32_t proxyId, const AABB& aabb, const glm::vec3& displacement)
+    {
+        assert(proxyId >= 0 && proxyId < static_cast<int32_t>(m_Nodes.size()));
+        assert(m_Nodes[proxyId].IsLeaf());
+
+        const glm::vec3 margin(kAABBMargin);
+        AABB fatAABB(aabb.min - margin, aabb.max + margin);
+
+        const glm::vec3 predicted = displacement * kDisplacementMultiplier;
+        fatAABB.min += glm::min(predicted, glm::vec3(0.0f));
+        fatAABB.max += glm::max(predicted, glm::vec3(0.0f));
+
+        const AABB& treeAABB = m_Nodes[proxyId].aabb;
+        if (treeAABB.Contains(aabb))
+        {
+            // Keep the leaf unless it became far too large for the object
+            const glm::vec3 largeMargin(4.0f * kAABBMargin);
+            const AABB hugeAABB(fatAABB.min - largeMargin, fatAABB.max + largeMargin);
+            if (hugeAABB.Contains(treeAABB))
+            {
+                return false;
+            }
+        }
+
+        RemoveLeaf(proxyId);
+        m_Nodes[proxyId].aabb = fatAABB;
+        InsertLeaf(proxyId);
+        return true;
+    }
+
+    void DynamicAABBTree::InsertLeaf(int32_t leaf)
+    {
+        if (m_Root == NullNode)
+        {
+            m_Root = leaf;
+            m_Nodes[leaf].parent = NullNode;
+            return;
+        }
+
+        // Find the best sibling using the surface area heuristic
+        const AABB leafAABB = m_Nodes[leaf].aabb;
+        int32_t index = m_Root;
+        while (!m_Nodes[index].IsLeaf())
+        {
+            const Node& node = m_Nodes[index];
+            const int32_t child1 = node.child1;
+            const int32_t child2 = node.child2;
+
+            const float area = node.aabb.GetSurfaceArea();
+            const float combinedArea = AABB::Union(node.aabb, leafAABB).GetSurfaceArea();
+
+            // Cost of creating a new parent for this node and the new leaf
+            const float cost = 2.0f * combinedArea;
+            // Minimum cost of pushing the leaf further down the tree
+            const float inheritanceCost = 2.0f * (combinedArea - area);
+
+            const auto descendCost = [&](int32_t child)
+            {
+                const AABB combined = AABB::Union(leafAABB, m_Nodes[child].aabb);
+                if (m_Nodes[child].IsLeaf())
+                {
+                    return combined.GetSurfaceArea() + inheritanceCost;
+                }
+                return combined.GetSurfaceArea() - m_Nodes[child].aabb.GetSurfaceArea() + inheritanceCost;
+            };
+
+            const float cost1 = descendCost(child1);
+            const float cost2 = descendCost(child2);
+            if (cost < cost1 && cost < cost2)
+            {
+                break;
+            }
+
+            index = cost1 < cost2 ? child1 : child2;
+        }
+
+        const int32_t sibling = index;
+
+        // AllocateNode may grow m_Nodes, so no references are held across it
+        const int32_t oldParent = m_Nodes[sibling].parent;
+        const int32_t newParent = AllocateNode();
+        m_Nodes[newParent].parent = oldParent;
+        m_Nodes[newParent].aabb = AABB::Union(leafAABB, m_Nodes[sibling].aabb);
+        m_Nodes[newParent].height = m_Nodes[sibling].height + 1;
+        m_Nodes[newParent].child1 = sibling;
+        m_Nodes[newParent].child2 = leaf;
+        m_Nodes[sibling].parent = newParent;
+        m_Nodes[leaf].parent = newParent;
+
+        if (oldParent != NullNode)
+        {
+            if (m_Nodes[oldParent].child1 == sibling)
+            {
+                m_Nodes[oldParent].child1 = newParent;
+            }
+            else
+            {
+                m_Nodes[oldParent].child2 = newParent;
+            }
+        }
+        else
+        {
+            m_Root = newParent;
+        }
+
+        // Walk back up refitting and rebalancing
+        index = m_Nodes[leaf].parent;
+        while (index != NullNode)
+        {
+            index = Balance(index);
+
+            Node& node = m_Nodes[index];
+            node.height = 1 + std::max(m_Nodes[node.child1].height, m_Nodes[node.child2].height);
+            node.aabb = AABB::Union(m_Nodes[node.child1].aabb, m_Nodes[node.child2].aabb);
+
+            index = node.parent;
+        }
+    }
+
+    void DynamicAABBTree::RemoveLeaf(int32_t leaf)
+    {
+        if (leaf == m_Root)
+        {
+            m_Root = NullNode;
+            return;
+        }
+
+        const int32_t parent = m_Nodes[leaf].parent;
+        const int32_t grandParent = m_Nodes[parent].parent;
+        const int32_t sibling = m_Nodes[parent].child1 == leaf ? m_Nodes[parent].child2 : m_Nodes[parent].child1;
+
+        if (grandParent == NullNode)
+        {
+            m_Root = sibling;
+            m_Nodes[sibling].parent = NullNode;
+            FreeNode(parent);
+            return;
+        }
+
+        // Replace the parent with the sibling
+        if (m_Nodes[grandParent].child1 == parent)
+        {
+            m_Nodes[grandParent].child1 = sibling;
+        }
+        else
+        {
+            m_Nodes[grandParent].child2 = sibling;
+        }
+        m_Nodes[sibling].parent = grandParent;
+        FreeNode(parent);
+
+        int32_t index = grandParent;
+        while (index != NullNode)
+        {
+            index = Balance(index);
+
+            Node& node = m_Nodes[index];
+            node.aabb = AABB::Union(m_Nodes[node.child1].aabb, m_Nodes[node.child2].aabb);
+            node.height = 1 + std::max(m_Nodes[node.child1].height, m_Nodes[node.child2].height);
+
+            index = node.parent;
+        }
+    }
+
+    // Performs a left or right rotation if node A is imbalanced, returns the new subtree root
+    int32_t DynamicAABBTree::Balance(int32_t iA)
+    {
+        Node* A = &m_Nodes[iA];
+        if (A->IsLeaf() || A->height < 2)
+        {
+            return iA;
+        }
+
+        const int32_t iB = A->child1;
+        const int32_t iC = A->child2;
+        Node* B = &m_Nodes[iB];
+        Node* C = &m_Nodes[iC];
+
+        const int32_t balance = C->height - B->height;
+
+        // Rotate C up
+        if (balance > 1)
+        {
+            const int32_t iF = C->child1;
+            const int32_t iG = C->child2;
+            Node* F = &m_Nodes[iF];
+            Node* G = &m_Nodes[iG];
+
+            C->child1 = iA;
+            C->parent = A->parent;
+            A->parent = iC;
+
+            if (C->parent != NullNode)
+            {
+                if (m_Nodes[C->parent].child1 == iA)
+                {
+                    m_Nodes[C->parent].child1 = iC;
+                }
+                else
+                {
+                    m_Nodes[C->parent].child2 = iC;
+                }
+            }
+            else
+            {
+                m_Root = iC;
+            }
+
+            if (F->height > G->height)
+            {
+                C->child2 = iF;
+                A->child2 = iG;
+                G->parent = iA;
+                A->aabb = AABB::Union(B->aabb, G->aabb);
+                C->aabb = AABB::Union(A->aabb, F->aabb);
+                A->height = 1 + std::max(B->height, G->height);
+                C->height = 1 + std::max(A->height, F->height);
+            }
+            else
+            {
+                C->child2 = iG;
+                A->child2 = iF;
+                F->parent = iA;
+                A->aabb = AABB::Union(B->aabb, F->aabb);
+                C->aabb = AABB::Union(A->aabb, G->aabb);
+                A->height = 1 + std::max(B->height, F->height);
+                C->height = 1 + std::max(A->height, G->height);
+            }
+
+            return iC;
+        }
+
+        // Rotate B up
+        if (balance < -1)
+        {
+            const int32_t iD = B->child1;
+            const int32_t iE = B->child2;
+            Node* D = &m_Nodes[iD];
+            Node* E = &m_Nodes[iE];
+
+            B->child1 = iA;
+            B->parent = A->parent;
+            A->parent = iB;
+
+            if (B->parent != NullNode)
+            {
+                if (m_Nodes[B->parent].child1 == iA)
+                {
+                    m_Nodes[B->parent].child1 = iB;
+                }
+                else
+                {
+                    m_Nodes[B->parent].child2 = iB;
+                }
+            }
+            else
+            {
+                m_Root = iB;
+            }
+
+            if (D->height > E->height)
+            {
+                B->child2 = iD;
+                A->child1 = iE;
+                E->parent = iA;
+                A->aabb = AABB::Union(C->aabb, E->aabb);
+                B->aabb = AABB::Union(A->aabb, D->aabb);
+                A->height = 1 + std::max(C->height, E->height);
+                B->height = 1 + std::max(A->height, D->height);
+            }
+            else
+            {
+                B->child2 = iE;
+                A->child1 = iD;
+                D->parent = iA;
+                A->aabb = AABB::Union(C->aabb, D->aabb);
+                B->aabb = AABB::Union(A->aabb, E->aabb);
+                A->height = 1 + std::max(C->height, D->height);
+                B->height = 1 + std::max(A->height, E->height);
+            }
+
+            return iB;
+        }
+
+        return iA;
+    }
+}
@@ -0,0 +1,175 @@
+// Copyright (c) 2025 Flex Engine | Evangelion Manuhutu
+
+#ifndef DYNAMIC_AABB_TREE_H
+#define DYNAMIC_AABB_TREE_H
+
+#include "Math/Bounds.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace flex
+{
+    // Incrementally updated bounding volume hierarchy (Box2D style).
+    // Leaves store a fattened AABB so small movements don't need a reinsert
+    class DynamicAABBTree
+    {
+    public:
+        static constexpr int32_t NullNode = -1;
+
+        DynamicAABBTree();
+
+        // Returns the proxy id, userData is handed back by the queries
+        int32_t CreateProxy(const AABB& aabb, uint32_t userData);
+        void DestroyProxy(int32_t proxyId);
+
+        // Returns true when the proxy had to be reinserted
+        bool MoveProxy(int32_t proxyId, const AABB& aabb, const glm::vec3& displacement);
+
+        void Clear();
+
+        uint32_t GetUserData(int32_t proxyId) const { return m_Nodes[proxyId].userData; }
+        const AABB& GetFatAABB(int32_t proxyId) const { return m_Nodes[proxyId].aabb; }
+        uint32_t GetProxyCount() const { return m_ProxyCount; }
+        int32_t GetHeight() const { return m_Root == NullNode ? 0 : m_Nodes[m_Root].height; }
+
+        // Callbacks take the proxy userData and return false to stop the query
+        template<typename Callback>
+        void QueryAABB(const AABB& aabb, Callback&& callback) const
+        {
+            Traverse([&](const AABB& nodeAABB) { return nodeAABB.Overlaps(aabb); }, callback);
+        }
+
+        template<typename Callback>
+        void QuerySphere(const BoundingSphere& sphere, Callback&& callback) const
+        {
+            Traverse([&](const AABB& nodeAABB) { return math::IntersectSphereAABB(sphere, nodeAABB); }, callback);
+        }
+
+        template<typename Callback>
+        void QueryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Callback&& callback) const
+        {
+            const glm::vec3 invDirection = 1.0f / direction;
+            Traverse([&](const AABB& nodeAABB)
+            {
+                float distance;
+                return math::IntersectRayAABB(origin, invDirection, maxDistance, nodeAABB, distance);
+            }, callback);
+        }
+
+        // Subtrees fully inside the frustum are reported without further plane tests
+        template<typename Callback>
+        void QueryFrustum(const Frustum& frustum, Callback&& callback) const
+        {
+            if (m_Root == NullNode)
+            {
+                return;
+            }
+
+            std::vector<StackEntry>& stack = m_Stack;
+            stack.clear();
+            stack.push_back({ m_Root, false });
+            while (!stack.empty())
+            {
+                const StackEntry entry = stack.back();
+                stack.pop_back();
+
+                const Node& node = m_Nodes[entry.node];
+                bool inside = entry.inside;
+                if (!inside)
+                {
+                    const Containment containment = frustum.Classify(node.aabb);
+                    if (containment == Containment::Outside)
+                    {
+                        continue;
+                    }
+                    inside = containment == Containment::Inside;
+                }
+
+                if (node.IsLeaf())
+                {
+                    if (!callback(node.userData))
+                    {
+                        return;
+                    }
+                    continue;
+                }
+
+                stack.push_back({ node.child1, inside });
+                stack.push_back({ node.child2, inside });
+            }
+        }
+
+    private:
+        struct Node
+        {
+            AABB aabb;
+            int32_t parent = NullNode; // Next free node while on the free list
+            int32_t child1 = NullNode;
+            int32_t child2 = NullNode;
+            int32_t height = -1; // Leaf = 0, free node = -1
+            uint32_t userData = 0;
+
+            bool IsLeaf() const { return child1 == NullNode; }
+        };
+
+        struct StackEntry
+        {
+            int32_t node;
+            bool inside;
+        };
+
+        template<typename Overlap, typename Callback>
+        void Traverse(Overlap&& overlap, Callback&& callback) const
+        {
+            if (m_Root == NullNode)
+            {
+                return;
+            }
+
+            std::vector<StackEntry>& stack = m_Stack;
+            stack.clear();
+            stack.push_back({ m_Root, false });
+            while (!stack.empty())
+            {
+                const Node& node = m_Nodes[stack.back().node];
+                stack.pop_back();
+
+                if (!overlap(node.aabb))
+                {
+                    continue;
+                }
+
+                if (node.IsLeaf())
+                {
+                    if (!callback(node.userData))
+                    {
+                        return;
+                    }
+                    continue;
+                }
+
+                stack.push_back({ node.child1, false });
+                stack.push_back({ node.child2, false });
+            }
+        }
+
+        int32_t AllocateNode();
+        void FreeNode(int32_t nodeId);
+        void InsertLeaf(int32_t leaf);
+        void RemoveLeaf(int32_t leaf);
+        int32_t Balance(int32_t nodeId);
+
+        std::vector<Node> m_Nodes;
+        int32_t m_Root = NullNode;
+        int32_t m_FreeList = NullNode;
+        uint32_t m_ProxyCount = 0;
+
+        // Traversal stack reused between queries, queries are not reentrant
+        mutable std::vector<StackEntry> m_Stack;
+    };
+}
+
+#endif
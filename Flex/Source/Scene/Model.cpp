@@ -3,6 +3,7 @@
 #include "Model.h"
 
 #include "Renderer/Material.h"
+#include "Renderer/MaterialTable.h"
 
 namespace flex
 {
@@ -10,7 +11,6 @@ namespace flex
         : m_Transform(glm::mat4(1.0f))
         , m_Scene(MeshLoader::LoadSceneGraphFromGLTF(filename))
     {
-        m_MaterialUbo = UniformBuffer::Create(sizeof(Material::Params), UNIFORM_BINDING_LOC_MATERIAL);
     }
 
     Model::~Model()
@@ -36,23 +36,10 @@ namespace flex
             {
                 if (meshInstance->material)
                 {
-                    // Apply material parameters
-                    m_MaterialUbo->SetData(&meshInstance->material->params, sizeof(Material::Params));
-
-                    meshInstance->material->occlusionTexture->Bind(4);
-					shader->SetUniform("u_OcclusionTexture", 4);
-        
-                    meshInstance->material->normalTexture->Bind(3);
-                    shader->SetUniform("u_NormalTexture", 3);
-        
-                    meshInstance->material->metallicRoughnessTexture->Bind(2);
-                    shader->SetUniform("u_MetallicRoughnessTexture", 2);
-        
-                    meshInstance->material->emissiveTexture->Bind(1);
-                    shader->SetUniform("u_EmissiveTexture", 1);
-        
-                    meshInstance->material->baseColorTexture->Bind(0);
-                    shader->SetUniform("u_BaseColorTexture", 0);
+                    // Material params and textures are read from the material table
+                    meshInstance->material->UpdateData();
+                    Renderer::GetMaterialTable()->Flush();
+                    shader->SetUniform("u_MaterialIndex", static_cast<int>(meshInstance->material->GetSlot()));
                 }
         
                 // Bind environment last to guarantee it stays on unit 5
@@ -61,9 +48,8 @@ namespace flex
                 
                 // TODO: Calculate with mesh transform
                 shader->SetUniform("u_Transform", m_Transform * meshInstance->localTransform);
-        
-                meshInstance->mesh->vertexArray->Bind();
-                Renderer::DrawIndexed(meshInstance->mesh->vertexArray);
+
+                Renderer::DrawMesh(*meshInstance->mesh);
             }
         }
     }
@@ -75,8 +61,7 @@ namespace flex
             for (const Ref<MeshInstance> &meshInstance : node.meshInstances)
             {
                 shader->SetUniform("u_Model", m_Transform * meshInstance->localTransform);
-                meshInstance->mesh->vertexArray->Bind();
-                Renderer::DrawIndexed(meshInstance->mesh->vertexArray);
+                Renderer::DrawMesh(*meshInstance->mesh);
             }
         }
     }
@@ -6,7 +6,6 @@
 #include "Renderer/Mesh.h"
 #include "Renderer/Shader.h"
 #include "Renderer/Texture.h"
-#include "Renderer/UniformBuffer.h"
 
 #include <string>
 #include <memory>
@@ -35,7 +34,6 @@ namespace flex
 
     private:
         MeshScene m_Scene;
-        Ref<UniformBuffer> m_MaterialUbo;
         glm::mat4 m_Transform{};
     };
 }
@@ -8,8 +8,15 @@
 #include "Renderer/Mesh.h"
 #include "Renderer/Renderer.h"
 #include "Renderer/Renderer2D.h"
+#include "Renderer/ShaderVariants.h"
+#include "Renderer/TextureStreamer.h"
 #include "Math/Math.hpp"
+#include "Math/Bounds.hpp"
+#include "Core/ThreadPool.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <filesystem>
 #include <unordered_map>
 #include <type_traits>
@@ -37,6 +44,13 @@ namespace flex
 				copy.shape = nullptr;
 				return copy;
 			}
+			else if constexpr (std::is_same_v<Component, TransformComponent>)
+			{
+				// The destination has no cached world matrix yet
+				Component copy = component;
+				copy.dirty = true;
+				return copy;
+			}
 			else
 			{
 				return component;
@@ -108,11 +122,25 @@ namespace flex
 		}
 
 		using AllComponents = ComponentGroup<TransformComponent, MeshComponent, RigidbodyComponent, BoxColliderComponent>;
+
+		// Sphere test first since it is cheaper, the box test rejects what the sphere lets through
+		bool IsProxyVisible(const Frustum& frustum, const SpatialProxyComponent& proxy)
+		{
+			return frustum.Intersects(proxy.worldSphere) && frustum.Intersects(proxy.worldBounds);
+		}
 	}
 
 	Scene::Scene()
 	{
 		registry = new entt::registry();
+		registry->on_construct<TransformComponent>().connect<&Scene::OnTransformConstruct>(this);
+		registry->on_destroy<TransformComponent>().connect<&Scene::OnTransformDestroy>(this);
+		registry->on_construct<TagComponent>().connect<&Scene::OnTagChanged>(this);
+		registry->on_destroy<TagComponent>().connect<&Scene::OnTagChanged>(this);
+		registry->on_destroy<MeshComponent>().connect<&Scene::OnSpatialOwnerDestroy>(this);
+		registry->on_destroy<WorldTransformComponent>().connect<&Scene::OnSpatialOwnerDestroy>(this);
+		registry->on_destroy<SpatialProxyComponent>().connect<&Scene::OnSpatialProxyDestroy>(this);
+
 		joltPhysicsScene = JoltPhysicsScene::Create(this);
 	}
 
@@ -136,6 +164,14 @@ namespace flex
 
     void Scene::Update(float deltaTime)
     {
+		// Shadow casters accumulate over every cascade rendered this frame
+		m_Stats.shadowCastersDrawn = 0;
+		m_Stats.shadowCastersCulled = 0;
+		m_Stats.drawCalls = 0;
+		m_Stats.drawInstances = 0;
+		m_Stats.stateChanges = 0;
+		m_Stats.submitMs = 0.0f;
+
 		if (m_IsPlaying)
 		{
 			joltPhysicsScene->Simulate(deltaTime);
@@ -143,71 +179,420 @@ namespace flex
 		else // Editor Update
 		{
 		}
+
+		UpdateTransforms();
     }
 
-	void Scene::Render(const Ref<Shader>& shader, const Ref<Texture2D>& environmentTexture)
+	void Scene::UpdateTransforms(bool multithreaded)
 	{
-		if (!shader)
-			return;
+		if (m_HierarchyDirty)
+		{
+			RebuildTransformLevels();
+		}
+
+		++m_TransformFrame;
 
-		auto view = registry->view<TransformComponent, MeshComponent>();
-		view.each([&](TransformComponent& transform, MeshComponent& meshComponent)
+		auto& transforms = registry->storage<TransformComponent>();
+		auto& worldTransforms = registry->storage<WorldTransformComponent>();
+		std::atomic<uint32_t> updatedCount = 0;
+
+		const auto updateRange = [&](const std::vector<TransformNode>& level, size_t begin, size_t end)
+		{
+			uint32_t updated = 0;
+			for (size_t i = begin; i < end; ++i)
 			{
-				if (!meshComponent.meshInstance || !meshComponent.meshInstance->mesh)
-					return;
+				const TransformNode& node = level[i];
+				TransformComponent& transform = transforms.get(node.entity);
+				WorldTransformComponent& worldTransform = worldTransforms.get(node.entity);
+
+				// Parents live in an earlier level and are already final for this frame
+				const WorldTransformComponent* parentWorld = node.parent != entt::null ? &worldTransforms.get(node.parent) : nullptr;
+				const bool parentChanged = parentWorld && parentWorld->updateFrame == m_TransformFrame;
+				if (!transform.dirty && !parentChanged)
+				{
+					continue;
+				}
 
-				const glm::mat4 worldTransform = math::ComposeTransform(transform);
+				if (transform.dirty)
+				{
+					worldTransform.local = math::ComposeTransform(transform);
+					transform.dirty = false;
+				}
 
-				const Ref<Material>& material = meshComponent.meshInstance->material;
-				if (material)
+				worldTransform.world = parentWorld ? parentWorld->world * worldTransform.local : worldTransform.local;
+				worldTransform.updateFrame = m_TransformFrame;
+				++updated;
+			}
+
+			updatedCount += updated;
+		};
+
+		for (const std::vector<TransformNode>& level : m_TransformLevels)
+		{
+			if (multithreaded && level.size() > kTransformChunkSize)
+			{
+				ThreadPool::ParallelFor(level.size(), kTransformChunkSize, [&](size_t begin, size_t end)
 				{
-					material->UpdateData();
+					updateRange(level, begin, end);
+				});
+			}
+			else
+			{
+				updateRange(level, 0, level.size());
+			}
+		}
 
-					material->occlusionTexture->Bind(4);
-					shader->SetUniform("u_OcclusionTexture", 4);
+		m_Stats.transformsUpdated = updatedCount.load();
 
-					material->normalTexture->Bind(3);
-					shader->SetUniform("u_NormalTexture", 3);
+		UpdateSpatialTrees();
+	}
+
+	void Scene::RebuildTransformLevels()
+	{
+		m_TransformLevels.clear();
+		m_HierarchyDirty = false;
 
-					material->metallicRoughnessTexture->Bind(2);
-					shader->SetUniform("u_MetallicRoughnessTexture", 2);
+		struct PendingNode
+		{
+			entt::entity entity;
+			entt::entity transformParent;
+			size_t level;
+		};
 
-					material->emissiveTexture->Bind(1);
-					shader->SetUniform("u_EmissiveTexture", 1);
+		// Breadth first from the roots. Entities without a transform are walked through
+		// but only contribute their nearest transformed ancestor to their children
+		std::vector<PendingNode> frontier;
+		auto tagView = registry->view<TagComponent>();
+		for (entt::entity entity : tagView)
+		{
+			const TagComponent& tag = tagView.get<TagComponent>(entity);
+			if (tag.parent == UUID(0) || GetEntityByUUID(tag.parent) == entt::null)
+			{
+				frontier.push_back({ entity, entt::null, 0 });
+			}
+		}
+
+		std::vector<PendingNode> next;
+		while (!frontier.empty())
+		{
+			next.clear();
+			for (const PendingNode& pending : frontier)
+			{
+				entt::entity childParent = pending.transformParent;
+				size_t childLevel = pending.level;
 
-					material->baseColorTexture->Bind(0);
-					shader->SetUniform("u_BaseColorTexture", 0);
+				if (registry->all_of<TransformComponent>(pending.entity))
+				{
+					if (m_TransformLevels.size() <= pending.level)
+					{
+						m_TransformLevels.resize(pending.level + 1);
+					}
+					m_TransformLevels[pending.level].push_back({ pending.entity, pending.transformParent });
+
+					// Re-parented, or the old parent is gone, the baked world matrix is stale even if nothing moved
+					WorldTransformComponent& worldTransform = registry->get<WorldTransformComponent>(pending.entity);
+					if (worldTransform.parent != pending.transformParent)
+					{
+						worldTransform.parent = pending.transformParent;
+						registry->get<TransformComponent>(pending.entity).dirty = true;
+					}
+
+					childParent = pending.entity;
+					childLevel = pending.level + 1;
 				}
 
-				if (environmentTexture)
+				for (const UUID& childID : registry->get<TagComponent>(pending.entity).children)
 				{
-					environmentTexture->Bind(5);
-					shader->SetUniform("u_EnvironmentTexture", 5);
+					const entt::entity child = GetEntityByUUID(childID);
+					if (child != entt::null && registry->valid(child))
+					{
+						next.push_back({ child, childParent, childLevel });
+					}
 				}
+			}
 
-				shader->SetUniform("u_Transform", worldTransform);
+			std::swap(frontier, next);
+		}
+	}
 
-				meshComponent.meshInstance->mesh->vertexArray->Bind();
-				Renderer::DrawIndexed(meshComponent.meshInstance->mesh->vertexArray);
-			});
+	void Scene::MarkHierarchyDirty()
+	{
+		m_HierarchyDirty = true;
 	}
 
-	void Scene::RenderDepth(const Ref<Shader>& shader)
+	void Scene::OnTransformConstruct(entt::registry& reg, entt::entity entity)
 	{
-		if (!shader)
+		reg.emplace_or_replace<WorldTransformComponent>(entity);
+		m_HierarchyDirty = true;
+	}
+
+	void Scene::OnTransformDestroy(entt::registry& reg, entt::entity entity)
+	{
+		reg.remove<WorldTransformComponent>(entity);
+		m_HierarchyDirty = true;
+	}
+
+	void Scene::OnTagChanged(entt::registry& reg, entt::entity entity)
+	{
+		m_HierarchyDirty = true;
+	}
+
+	uint32_t Scene::GatherMeshesInFrustum(const Frustum& frustum, std::vector<entt::entity>& outEntities)
+	{
+		QueryFrustum(frustum, outEntities);
+		const uint32_t proxyCount = m_StaticTree.GetProxyCount() + m_DynamicTree.GetProxyCount();
+		return proxyCount - static_cast<uint32_t>(outEntities.size());
+	}
+
+	void Scene::QueryFrustum(const Frustum& frustum, std::vector<entt::entity>& outEntities) const
+	{
+		outEntities.clear();
+		const auto visit = [&](uint32_t userData)
+		{
+			const entt::entity entity = static_cast<entt::entity>(userData);
+			if (detail::IsProxyVisible(frustum, registry->get<SpatialProxyComponent>(entity)))
+			{
+				outEntities.push_back(entity);
+			}
+			return true;
+		};
+
+		m_StaticTree.QueryFrustum(frustum, visit);
+		m_DynamicTree.QueryFrustum(frustum, visit);
+	}
+
+	void Scene::QueryAABB(const AABB& aabb, std::vector<entt::entity>& outEntities) const
+	{
+		outEntities.clear();
+		const auto visit = [&](uint32_t userData)
+		{
+			const entt::entity entity = static_cast<entt::entity>(userData);
+			if (registry->get<SpatialProxyComponent>(entity).worldBounds.Overlaps(aabb))
+			{
+				outEntities.push_back(entity);
+			}
+			return true;
+		};
+
+		m_StaticTree.QueryAABB(aabb, visit);
+		m_DynamicTree.QueryAABB(aabb, visit);
+	}
+
+	void Scene::QuerySphere(const BoundingSphere& sphere, std::vector<entt::entity>& outEntities) const
+	{
+		outEntities.clear();
+		const auto visit = [&](uint32_t userData)
+		{
+			const entt::entity entity = static_cast<entt::entity>(userData);
+			if (math::IntersectSphereAABB(sphere, registry->get<SpatialProxyComponent>(entity).worldBounds))
+			{
+				outEntities.push_back(entity);
+			}
+			return true;
+		};
+
+		m_StaticTree.QuerySphere(sphere, visit);
+		m_DynamicTree.QuerySphere(sphere, visit);
+	}
+
+	void Scene::QueryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, std::vector<entt::entity>& outEntities) const
+	{
+		outEntities.clear();
+
+		std::vector<std::pair<float, entt::entity>> hits;
+		const glm::vec3 invDirection = 1.0f / direction;
+		const auto visit = [&](uint32_t userData)
+		{
+			const entt::entity entity = static_cast<entt::entity>(userData);
+			float distance = 0.0f;
+			if (math::IntersectRayAABB(origin, invDirection, maxDistance, registry->get<SpatialProxyComponent>(entity).worldBounds, distance))
+			{
+				hits.emplace_back(distance, entity);
+			}
+			return true;
+		};
+
+		m_StaticTree.QueryRay(origin, direction, maxDistance, visit);
+		m_DynamicTree.QueryRay(origin, direction, maxDistance, visit);
+
+		std::sort(hits.begin(), hits.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+		outEntities.reserve(hits.size());
+		for (const auto& [distance, entity] : hits)
+		{
+			outEntities.push_back(entity);
+		}
+	}
+
+	void Scene::UpdateSpatialTrees()
+	{
+		m_Stats.spatialProxiesReinserted = 0;
+
+		auto view = registry->view<WorldTransformComponent, MeshComponent>();
+		for (entt::entity entity : view)
+		{
+			const WorldTransformComponent& transform = view.get<WorldTransformComponent>(entity);
+			const MeshComponent& meshComponent = view.get<MeshComponent>(entity);
+			const Mesh* mesh = meshComponent.meshInstance ? meshComponent.meshInstance->mesh.get() : nullptr;
+
+			SpatialProxyComponent* proxy = registry->try_get<SpatialProxyComponent>(entity);
+			if (!mesh || !mesh->bounds.IsValid())
+			{
+				if (proxy)
+				{
+					registry->remove<SpatialProxyComponent>(entity);
+				}
+				continue;
+			}
+
+			const RigidbodyComponent* rigidbody = registry->try_get<RigidbodyComponent>(entity);
+			const bool dynamic = rigidbody && !rigidbody->isStatic;
+			const bool moved = transform.updateFrame == m_TransformFrame;
+			if (proxy && !moved && proxy->mesh == mesh && proxy->dynamic == dynamic)
+			{
+				continue;
+			}
+
+			const AABB worldBounds = math::TransformAABB(mesh->bounds, transform.world);
+			const BoundingSphere worldSphere = math::TransformSphere(mesh->boundingSphere, transform.world);
+			const uint32_t userData = static_cast<uint32_t>(entity);
+
+			if (!proxy)
+			{
+				proxy = &registry->emplace<SpatialProxyComponent>(entity);
+				proxy->dynamic = dynamic;
+				proxy->proxyId = (dynamic ? m_DynamicTree : m_StaticTree).CreateProxy(worldBounds, userData);
+			}
+			else if (proxy->dynamic != dynamic)
+			{
+				(proxy->dynamic ? m_DynamicTree : m_StaticTree).DestroyProxy(proxy->proxyId);
+				proxy->dynamic = dynamic;
+				proxy->proxyId = (dynamic ? m_DynamicTree : m_StaticTree).CreateProxy(worldBounds, userData);
+			}
+			else
+			{
+				const glm::vec3 displacement = worldBounds.GetCenter() - proxy->worldBounds.GetCenter();
+				if ((dynamic ? m_DynamicTree : m_StaticTree).MoveProxy(proxy->proxyId, worldBounds, displacement))
+				{
+					++m_Stats.spatialProxiesReinserted;
+				}
+			}
+
+			proxy->mesh = mesh;
+			proxy->worldBounds = worldBounds;
+			proxy->worldSphere = worldSphere;
+		}
+	}
+
+	void Scene::OnSpatialOwnerDestroy(entt::registry& reg, entt::entity entity)
+	{
+		reg.remove<SpatialProxyComponent>(entity);
+	}
+
+	void Scene::OnSpatialProxyDestroy(entt::registry& reg, entt::entity entity)
+	{
+		const SpatialProxyComponent& proxy = reg.get<SpatialProxyComponent>(entity);
+		if (proxy.proxyId != DynamicAABBTree::NullNode)
+		{
+			(proxy.dynamic ? m_DynamicTree : m_StaticTree).DestroyProxy(proxy.proxyId);
+		}
+	}
+
+	uint32_t Scene::GatherVisibleMeshes(const glm::mat4& viewProjection, std::vector<entt::entity>& outEntities)
+	{
+		return GatherMeshesInFrustum(Frustum::FromMatrix(viewProjection), outEntities);
+	}
+
+	uint32_t Scene::GatherShadowCasters(const glm::mat4& lightViewProjection, std::vector<entt::entity>& outEntities)
+	{
+		// Casters between the light and the cascade still throw shadows into it,
+		// so the volume is left open towards the light
+		Frustum frustum = Frustum::FromMatrix(lightViewProjection);
+		frustum.DisablePlane(Frustum::Near);
+		return GatherMeshesInFrustum(frustum, outEntities);
+	}
+
+	void Scene::Render(const Ref<ShaderVariants>& shaders, uint32_t frameFeatures, const Ref<Texture2D>& environmentTexture, const glm::mat4& viewProjection)
+	{
+		if (!shaders)
 			return;
 
-		auto view = registry->view<TransformComponent, MeshComponent>();
-		view.each([&](TransformComponent& transform, MeshComponent& meshComponent)
+		const auto submitStart = std::chrono::high_resolution_clock::now();
+
+		m_Stats.culledMeshes = GatherVisibleMeshes(viewProjection, m_VisibleEntities);
+		m_Stats.visibleMeshes = static_cast<uint32_t>(m_VisibleEntities.size());
+
+		// Clip space y per unit of view space y, the projection rows are scaled rows of the rigid view
+		TextureStreamer* streamer = Renderer::GetTextureStreamer();
+		const float projectionScale = glm::length(glm::vec3(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1]));
+
+		m_RenderQueue.Clear();
+		for (entt::entity entity : m_VisibleEntities)
+		{
+			const WorldTransformComponent& transform = registry->get<WorldTransformComponent>(entity);
+			const MeshComponent& meshComponent = registry->get<MeshComponent>(entity);
+			const SpatialProxyComponent& proxy = registry->get<SpatialProxyComponent>(entity);
+			const Mesh* mesh = meshComponent.meshInstance->mesh.get();
+
+			Material* material = meshComponent.meshInstance->material.get();
+			const RenderPass pass = material && material->type == MaterialType::Transparent ? RenderPass::Transparent : RenderPass::Opaque;
+
+			// Clip space w is the view depth for perspective projections
+			const float viewDepth = (viewProjection * glm::vec4(proxy.worldSphere.center, 1.0f)).w;
+			m_RenderQueue.Submit(pass, *shaders, frameFeatures, material, mesh, transform.world, viewDepth);
+
+			if (streamer && material && mesh->boundingSphere.radius > 0.0f && proxy.worldSphere.radius > 0.0f)
 			{
-				if (!meshComponent.meshInstance || !meshComponent.meshInstance->mesh)
-					return;
+				// UV units across the viewport height at the closest point of the mesh, the world to local
+				// scale comes from the sphere radii
+				const float uvPerWorldUnit = mesh->uvDensity * mesh->boundingSphere.radius / proxy.worldSphere.radius;
+				const float closestDepth = std::max(viewDepth - proxy.worldSphere.radius, 0.1f);
+				const float uvPerViewport = uvPerWorldUnit * 2.0f * closestDepth / projectionScale;
+				for (const Ref<Texture2D>* texture : { &material->baseColorTexture, &material->emissiveTexture, &material->metallicRoughnessTexture, &material->normalTexture, &material->occlusionTexture })
+				{
+					streamer->Request(texture->get(), uvPerViewport);
+				}
+			}
+		}
+		m_RenderQueue.Sort();
 
-				const glm::mat4 worldTransform = math::ComposeTransform(transform);
-				shader->SetUniform("u_Model", worldTransform);
-				meshComponent.meshInstance->mesh->vertexArray->Bind();
-				Renderer::DrawIndexed(meshComponent.meshInstance->mesh->vertexArray);
-			});
+		// Sampler binding 5 in pbr.frag
+		if (environmentTexture)
+		{
+			environmentTexture->Bind(5);
+		}
+
+		const RenderQueueStats queueStats = m_RenderQueue.Execute();
+		m_Stats.drawCalls += queueStats.drawCalls;
+		m_Stats.drawInstances += queueStats.instances;
+		m_Stats.stateChanges += queueStats.GetStateChanges();
+		m_Stats.submitMs += std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - submitStart).count();
+	}
+
+	void Scene::RenderDepth(const Ref<Shader>& shader, const glm::mat4& lightViewProjection)
+	{
+		if (!shader)
+			return;
+
+		const auto submitStart = std::chrono::high_resolution_clock::now();
+
+		m_Stats.shadowCastersCulled += GatherShadowCasters(lightViewProjection, m_VisibleEntities);
+		m_Stats.shadowCastersDrawn += static_cast<uint32_t>(m_VisibleEntities.size());
+
+		// Depth only with no material, so each cascade is a single multi draw indirect call
+		m_RenderQueue.Clear();
+		for (entt::entity entity : m_VisibleEntities)
+		{
+			const WorldTransformComponent& transform = registry->get<WorldTransformComponent>(entity);
+			const MeshComponent& meshComponent = registry->get<MeshComponent>(entity);
+			m_RenderQueue.Submit(RenderPass::Opaque, shader.get(), nullptr, meshComponent.meshInstance->mesh.get(), transform.world, 0.0f);
+		}
+		m_RenderQueue.Sort();
+
+		const RenderQueueStats queueStats = m_RenderQueue.Execute();
+		m_Stats.drawCalls += queueStats.drawCalls;
+		m_Stats.drawInstances += queueStats.instances;
+		m_Stats.stateChanges += queueStats.GetStateChanges();
+		m_Stats.submitMs += std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - submitStart).count();
 	}
 
 	void Scene::DebugDrawColliders() const
@@ -217,7 +602,7 @@ namespace flex
 			return;
 		}
 
-		auto view = registry->view<TransformComponent, BoxColliderComponent>();
+		auto view = registry->view<WorldTransformComponent, BoxColliderComponent>();
 		constexpr glm::vec3 kLocalCorners[8] = {
 			{ -0.5f, -0.5f, -0.5f },
 			{  0.5f, -0.5f, -0.5f },
@@ -237,14 +622,11 @@ namespace flex
 
 		const glm::vec4 kDebugColor = { 0.9f, 0.0f, 0.9f, 1.0f };
 
-		view.each([&](const TransformComponent& transform, const BoxColliderComponent& box)
+		view.each([&](const WorldTransformComponent& transform, const BoxColliderComponent& box)
 		{
-			const glm::quat rotation = glm::quat(glm::radians(transform.rotation));
-			const glm::vec3 worldOffset = rotation * (box.offset * transform.scale);
-			const glm::vec3 worldScale = transform.scale * box.scale * 2.0f;
-			const glm::mat4 colliderTransform = glm::translate(glm::mat4(1.0f), transform.position + worldOffset)
-				* glm::toMat4(rotation)
-				* glm::scale(glm::mat4(1.0f), worldScale);
+			const glm::mat4 colliderTransform = transform.world
+				* glm::translate(glm::mat4(1.0f), box.offset)
+				* glm::scale(glm::mat4(1.0f), box.scale * 2.0f);
 
 			glm::vec3 worldCorners[8];
 			for (size_t i = 0; i < 8; ++i)
@@ -414,9 +796,26 @@ namespace flex
 		assert(registry && "Registry is null!");
 		if (registry->valid(entity))
 		{
-			TagComponent& tag = GetComponent<TagComponent>(entity);
+			const TagComponent& tag = GetComponent<TagComponent>(entity);
+			const UUID uuid = tag.uuid;
+
+			// Children become roots, their world matrices still hold this entity's transform
+			for (const UUID& childID : tag.children)
+			{
+				const entt::entity child = GetEntityByUUID(childID);
+				if (child != entt::null && registry->valid(child))
+				{
+					GetComponent<TagComponent>(child).parent = UUID(0);
+					if (TransformComponent* transform = registry->try_get<TransformComponent>(child))
+					{
+						transform->dirty = true;
+					}
+				}
+			}
+			m_HierarchyDirty = true;
+
 			registry->destroy(entity);
-			entities.erase(tag.uuid);
+			entities.erase(uuid);
 		}
 	}
 	entt::entity Scene::GetEntityByUUID(const UUID& uuid)
@@ -7,6 +7,8 @@
 #include "Core/UUID.h"
 
 #include "Physics/JoltPhysics.h"
+#include "DynamicAABBTree.h"
+#include "Renderer/RenderQueue.h"
 
 #include <glm/glm.hpp>
 #include <string>
@@ -18,6 +20,21 @@ namespace flex
     class JoltPhysicsScene;
     class Texture2D;
     class Shader;
+    class ShaderVariants;
+
+    struct SceneStats
+    {
+        uint32_t transformsUpdated = 0;
+        uint32_t visibleMeshes = 0;
+        uint32_t culledMeshes = 0;
+        uint32_t shadowCastersDrawn = 0;  // Summed over all cascades
+        uint32_t shadowCastersCulled = 0;
+        uint32_t spatialProxiesReinserted = 0; // Leaves that left their fat AABB this frame
+        uint32_t drawCalls = 0;    // Main and shadow passes
+        uint32_t drawInstances = 0; // Meshes drawn by those calls
+        uint32_t stateChanges = 0; // Shader and vertex array binds issued by the render queue
+        float submitMs = 0.0f;     // CPU time spent gathering, sorting and issuing draws, main and shadow passes
+    };
 
     class Scene
     {
@@ -29,10 +46,36 @@ namespace flex
         void Stop();
         void Update(float deltaTime);
 
-        void Render(const Ref<Shader>& shader, const Ref<Texture2D>& environmentTexture);
-        void RenderDepth(const Ref<Shader>& shader);
+        // Rebuilds cached world matrices of dirty transforms and their descendants.
+        // Runs level by level (parents before children), splitting wide levels across the ThreadPool
+        void UpdateTransforms(bool multithreaded = true);
+
+        // Forces the transform levels to be rebuilt, call after editing TagComponent parent/children directly
+        void MarkHierarchyDirty();
+
+        // Meshes outside the frustum of viewProjection are skipped before any binding,
+        // the rest are sorted through the render queue to minimise state changes
+        // Each draw uses the variant keyed by its material's PBRFeature map bits plus frameFeatures
+        void Render(const Ref<ShaderVariants>& shaders, uint32_t frameFeatures, const Ref<Texture2D>& environmentTexture, const glm::mat4& viewProjection);
+        // Draws only the casters inside the cascade's light volume (open towards the light)
+        void RenderDepth(const Ref<Shader>& shader, const glm::mat4& lightViewProjection);
         void DebugDrawColliders() const;
 
+        // Fill outEntities with mesh entities passing the cull test, returns the number culled
+        uint32_t GatherVisibleMeshes(const glm::mat4& viewProjection, std::vector<entt::entity>& outEntities);
+        uint32_t GatherShadowCasters(const glm::mat4& lightViewProjection, std::vector<entt::entity>& outEntities);
+
+        // Spatial queries over renderables, tested against their tight world bounds.
+        // Static and dynamic objects are kept in separate trees like the NON_MOVING/MOVING broadphase layers
+        void QueryFrustum(const Frustum& frustum, std::vector<entt::entity>& outEntities) const;
+        void QueryAABB(const AABB& aabb, std::vector<entt::entity>& outEntities) const;
+        void QuerySphere(const BoundingSphere& sphere, std::vector<entt::entity>& outEntities) const;
+        // Results are sorted nearest first
+        void QueryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, std::vector<entt::entity>& outEntities) const;
+
+        const DynamicAABBTree& GetStaticTree() const { return m_StaticTree; }
+        const DynamicAABBTree& GetDynamicTree() const { return m_DynamicTree; }
+
         bool IsPlaying() const { return m_IsPlaying; }
 
         std::vector<entt::entity> LoadModel(const std::string& filepath, const glm::mat4& rootTransform = glm::mat4(1.0f));
@@ -84,6 +127,8 @@ namespace flex
 
         entt::entity GetEntityByUUID(const UUID& uuid);
 
+        const SceneStats& GetStats() const { return m_Stats; }
+
         entt::registry* registry = nullptr;
         std::unordered_map<UUID, entt::entity> entities;
 
@@ -91,7 +136,39 @@ namespace flex
         Ref<JoltPhysicsScene> joltPhysicsScene;
 
     private:
+        void OnTransformConstruct(entt::registry& reg, entt::entity entity);
+        void OnTransformDestroy(entt::registry& reg, entt::entity entity);
+
+        void OnTagChanged(entt::registry& reg, entt::entity entity);
+        uint32_t GatherMeshesInFrustum(const Frustum& frustum, std::vector<entt::entity>& outEntities);
+
+        void UpdateSpatialTrees();
+        void OnSpatialOwnerDestroy(entt::registry& reg, entt::entity entity);
+        void OnSpatialProxyDestroy(entt::registry& reg, entt::entity entity);
+        void RebuildTransformLevels();
+
+        struct TransformNode
+        {
+            entt::entity entity;
+            entt::entity parent; // Nearest ancestor with a transform, entt::null for roots
+        };
+
+        static constexpr size_t kTransformChunkSize = 1024;
+
+        // Transformed entities grouped by hierarchy depth
+        std::vector<std::vector<TransformNode>> m_TransformLevels;
+        bool m_HierarchyDirty = true;
+        uint32_t m_TransformFrame = 0;
+
+        DynamicAABBTree m_StaticTree;
+        DynamicAABBTree m_DynamicTree;
+
+        // Scratch lists reused by the render passes
+        std::vector<entt::entity> m_VisibleEntities;
+        RenderQueue m_RenderQueue;
+
         bool m_IsPlaying = false;
+        SceneStats m_Stats;
     };
 }
 
@@ -293,6 +293,7 @@ namespace flex
 					material->params.metallicFactor = materialJson.value("MetallicFactor", material->params.metallicFactor);
 					material->params.roughnessFactor = materialJson.value("RoughnessFactor", material->params.roughnessFactor);
 					material->params.occlusionStrength = materialJson.value("OcclusionStrength", material->params.occlusionStrength);
+					material->MarkDirty();
 				}
 			}
 		}
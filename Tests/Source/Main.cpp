@@ -1,10 +1,32 @@
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <array>
+#include <numeric>
+#include <tuple>
+
 #include "Scene/Scene.h"
 #include "Core/Types.h"
 #include "Scene/Components.h"
 #include "Physics/JoltPhysics.h"
 #include "Math/Math.hpp"
+#include "Math/Bounds.hpp"
+#include "Scene/DynamicAABBTree.h"
+#include "Core/ThreadPool.h"
+#include "Renderer/RenderQueue.h"
+#include "Renderer/Shader.h"
+#include "Renderer/ProgramCache.h"
+#include "Renderer/Mesh.h"
+#include "Renderer/MeshCache.h"
+#include "Renderer/VertexFormat.h"
+#include "Renderer/MeshOptimizer.h"
+#include "Renderer/Texture.h"
+#include "Renderer/TextureCompressor.h"
+#include "Renderer/TextureStreamer.h"
 
 namespace
 {
@@ -135,6 +157,29 @@ TEST(MathTest, DecomposeTransformRestoresOriginalComponents)
     ExpectVec3Near(decomposed.rotation, original.rotation);
 }
 
+TEST(MathTest, FrustumRejectsBoundsBehindCamera)
+{
+    const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const flex::Frustum frustum = flex::Frustum::FromMatrix(projection * view);
+
+    const flex::AABB unitBox({ -0.5f, -0.5f, -0.5f }, { 0.5f, 0.5f, 0.5f });
+
+    EXPECT_TRUE(frustum.Intersects(flex::math::TransformAABB(unitBox, glm::translate(glm::mat4(1.0f), { 0.0f, 0.0f, -10.0f }))));
+    EXPECT_FALSE(frustum.Intersects(flex::math::TransformAABB(unitBox, glm::translate(glm::mat4(1.0f), { 0.0f, 0.0f, 10.0f }))));
+    EXPECT_FALSE(frustum.Intersects(flex::math::TransformAABB(unitBox, glm::translate(glm::mat4(1.0f), { 0.0f, 0.0f, -200.0f }))));
+    EXPECT_FALSE(frustum.Intersects(flex::math::TransformAABB(unitBox, glm::translate(glm::mat4(1.0f), { 50.0f, 0.0f, -10.0f }))));
+
+    // A scaled box reaching into the frustum from the side is kept
+    const glm::mat4 wide = glm::translate(glm::mat4(1.0f), { 30.0f, 0.0f, -10.0f }) * glm::scale(glm::mat4(1.0f), { 50.0f, 1.0f, 1.0f });
+    EXPECT_TRUE(frustum.Intersects(flex::math::TransformAABB(unitBox, wide)));
+
+    flex::BoundingSphere sphere;
+    sphere.radius = 1.0f;
+    EXPECT_TRUE(frustum.Intersects(flex::math::TransformSphere(sphere, glm::translate(glm::mat4(1.0f), { 0.0f, 0.0f, -5.0f }))));
+    EXPECT_FALSE(frustum.Intersects(flex::math::TransformSphere(sphere, glm::translate(glm::mat4(1.0f), { 0.0f, 0.0f, 5.0f }))));
+}
+
 TEST_F(JoltPhysicsTest, DynamicBodyFallsUnderGravity)
 {
     flex::Scene scene;
@@ -259,3 +304,1031 @@ TEST_F(SceneTest, DuplicateEntityCopiesComponentsAndMaintainsUUID)
     ExpectVec3Near(duplicateTransform.rotation, originalTransform.rotation);
     ExpectVec3Near(duplicateTransform.scale, originalTransform.scale);
 }
+
+TEST_F(SceneTest, UpdateTransformsPropagatesParentToChildren)
+{
+    flex::Scene scene;
+    entt::entity parent = scene.CreateEntity("Parent");
+    entt::entity child = scene.CreateEntity("Child");
+
+    auto& parentTransform = scene.AddComponent<flex::TransformComponent>(parent);
+    parentTransform.position = { 10.0f, 0.0f, 0.0f };
+    parentTransform.rotation = { 0.0f, 90.0f, 0.0f };
+
+    auto& childTransform = scene.AddComponent<flex::TransformComponent>(child);
+    childTransform.position = { 0.0f, 0.0f, 2.0f };
+
+    auto& parentTag = scene.GetComponent<flex::TagComponent>(parent);
+    parentTag.AddChild(scene.GetComponent<flex::TagComponent>(child).uuid);
+
+    ASSERT_TRUE(scene.HasComponent<flex::WorldTransformComponent>(child));
+
+    scene.UpdateTransforms();
+    EXPECT_EQ(scene.GetStats().transformsUpdated, 2u);
+
+    const glm::mat4 expected = flex::math::ComposeTransform(parentTransform) * flex::math::ComposeTransform(childTransform);
+    ExpectMat4Near(scene.GetComponent<flex::WorldTransformComponent>(child).world, expected);
+
+    // Moving only the parent must refresh the clean child as well
+    parentTransform.position.y = 5.0f;
+    parentTransform.dirty = true;
+    scene.UpdateTransforms();
+    EXPECT_EQ(scene.GetStats().transformsUpdated, 2u);
+
+    const glm::mat4 moved = flex::math::ComposeTransform(parentTransform) * flex::math::ComposeTransform(childTransform);
+    ExpectMat4Near(scene.GetComponent<flex::WorldTransformComponent>(child).world, moved);
+
+    scene.UpdateTransforms();
+    EXPECT_EQ(scene.GetStats().transformsUpdated, 0u);
+}
+
+TEST_F(SceneTest, DestroyingParentResetsChildWorldTransform)
+{
+    flex::Scene scene;
+    entt::entity parent = scene.CreateEntity("Parent");
+    entt::entity child = scene.CreateEntity("Child");
+
+    auto& parentTransform = scene.AddComponent<flex::TransformComponent>(parent);
+    parentTransform.position = { 10.0f, 0.0f, 0.0f };
+    auto& childTransform = scene.AddComponent<flex::TransformComponent>(child);
+    childTransform.position = { 0.0f, 0.0f, 2.0f };
+
+    scene.GetComponent<flex::TagComponent>(parent).AddChild(scene.GetComponent<flex::TagComponent>(child).uuid);
+    scene.UpdateTransforms();
+
+    // The child is clean, only its parent went away
+    scene.DestroyEntity(parent);
+    scene.UpdateTransforms();
+    ExpectMat4Near(scene.GetComponent<flex::WorldTransformComponent>(child).world, flex::math::ComposeTransform(childTransform));
+}
+
+TEST_F(SceneTest, CachedWorldTransformsBenchmark100kStatic)
+{
+    using Clock = std::chrono::high_resolution_clock;
+    constexpr int kEntityCount = 100000;
+    constexpr int kFrames = 10;
+
+    flex::Scene scene;
+    for (int i = 0; i < kEntityCount; ++i)
+    {
+        entt::entity entity = scene.CreateEntity("Static");
+        auto& transform = scene.AddComponent<flex::TransformComponent>(entity);
+        transform.position = { static_cast<float>(i % 100), static_cast<float>(i / 100), 0.0f };
+        transform.rotation = { 15.0f, 30.0f, 45.0f };
+    }
+
+    // Previous behaviour: Render + 4 shadow cascades each recomposed every matrix
+    auto start = Clock::now();
+    glm::mat4 sink(0.0f);
+    for (int frame = 0; frame < kFrames; ++frame)
+    {
+        auto view = scene.registry->view<flex::TransformComponent>();
+        for (int pass = 0; pass < 1 + 4; ++pass)
+        {
+            view.each([&](const flex::TransformComponent& transform)
+            {
+                sink += flex::math::ComposeTransform(transform);
+            });
+        }
+    }
+    const double recomposeMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / kFrames;
+    EXPECT_NE(sink[3][3], 0.0f);
+
+    start = Clock::now();
+    scene.UpdateTransforms();
+    const double firstFrameMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    EXPECT_EQ(scene.GetStats().transformsUpdated, static_cast<uint32_t>(kEntityCount));
+
+    start = Clock::now();
+    for (int frame = 0; frame < kFrames; ++frame)
+    {
+        scene.UpdateTransforms();
+        EXPECT_EQ(scene.GetStats().transformsUpdated, 0u);
+    }
+    const double cachedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / kFrames;
+
+    std::cout << "[ BENCH    ] " << kEntityCount << " static entities: recompose " << recomposeMs
+              << " ms/frame, first resolve " << firstFrameMs << " ms, cached " << cachedMs << " ms/frame\n";
+
+    EXPECT_LT(cachedMs, recomposeMs);
+}
+
+TEST_F(SceneTest, ParallelTransformUpdateBenchmarkDeep50k)
+{
+    using Clock = std::chrono::high_resolution_clock;
+    constexpr int kNodeCount = 50000;
+    constexpr int kDepth = 32;
+    constexpr int kNodesPerLevel = kNodeCount / kDepth;
+
+    flex::ThreadPool::Init();
+
+    flex::Scene scene;
+    std::vector<entt::entity> previousLevel;
+    std::vector<entt::entity> currentLevel;
+    std::vector<entt::entity> roots;
+    std::vector<entt::entity> all;
+    all.reserve(kNodeCount);
+
+    for (int depth = 0; depth < kDepth; ++depth)
+    {
+        currentLevel.clear();
+        for (int i = 0; i < kNodesPerLevel; ++i)
+        {
+            entt::entity entity = scene.CreateEntity("Node");
+            auto& transform = scene.AddComponent<flex::TransformComponent>(entity);
+            transform.position = { 0.5f, 0.25f * static_cast<float>(i % 7), 0.1f };
+            transform.rotation = { 1.0f, static_cast<float>(i % 360), 2.0f };
+            transform.scale = { 1.001f, 1.0f, 0.999f };
+
+            if (!previousLevel.empty())
+            {
+                // Spread children over the previous level so every depth stays wide
+                entt::entity parent = previousLevel[(i * 7919) % previousLevel.size()];
+                scene.GetComponent<flex::TagComponent>(parent).AddChild(scene.GetComponent<flex::TagComponent>(entity).uuid);
+            }
+            else
+            {
+                roots.push_back(entity);
+            }
+
+            currentLevel.push_back(entity);
+            all.push_back(entity);
+        }
+        std::swap(previousLevel, currentLevel);
+    }
+
+    // Warm up: builds the level lists and resolves everything once
+    scene.UpdateTransforms(false);
+    ASSERT_EQ(scene.GetStats().transformsUpdated, static_cast<uint32_t>(all.size()));
+
+    const auto touchRoots = [&]()
+    {
+        for (entt::entity root : roots)
+        {
+            scene.GetComponent<flex::TransformComponent>(root).dirty = true;
+        }
+    };
+
+    constexpr int kFrames = 10;
+    auto start = Clock::now();
+    for (int frame = 0; frame < kFrames; ++frame)
+    {
+        touchRoots();
+        scene.UpdateTransforms(false);
+    }
+    const double serialMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / kFrames;
+
+    std::vector<glm::mat4> serialWorld;
+    serialWorld.reserve(all.size());
+    for (entt::entity entity : all)
+    {
+        serialWorld.push_back(scene.GetComponent<flex::WorldTransformComponent>(entity).world);
+    }
+
+    start = Clock::now();
+    for (int frame = 0; frame < kFrames; ++frame)
+    {
+        touchRoots();
+        scene.UpdateTransforms(true);
+        EXPECT_EQ(scene.GetStats().transformsUpdated, static_cast<uint32_t>(all.size()));
+    }
+    const double parallelMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / kFrames;
+
+    for (size_t i = 0; i < all.size(); i += 97)
+    {
+        ExpectMat4Near(scene.GetComponent<flex::WorldTransformComponent>(all[i]).world, serialWorld[i]);
+    }
+
+    std::cout << "[ BENCH    ] " << all.size() << " nodes, depth " << kDepth << ", "
+              << flex::ThreadPool::Get()->GetWorkerCount() << " workers: serial " << serialMs
+              << " ms, parallel " << parallelMs << " ms, speedup " << serialMs / parallelMs << "x\n";
+
+    flex::ThreadPool::Shutdown();
+}
+
+namespace
+{
+    // Reference: a box is culled when all 8 corners are outside the same clip plane.
+    // The near plane (towards the light) is ignored, matching shadow caster culling
+    bool BruteForceCasterVisible(const flex::AABB& localBounds, const glm::mat4& world, const glm::mat4& lightViewProj)
+    {
+        int outside[5] = {};
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            const glm::vec3 local = {
+                (corner & 1) ? localBounds.max.x : localBounds.min.x,
+                (corner & 2) ? localBounds.max.y : localBounds.min.y,
+                (corner & 4) ? localBounds.max.z : localBounds.min.z
+            };
+            const glm::vec4 clip = lightViewProj * world * glm::vec4(local, 1.0f);
+            outside[0] += clip.x < -clip.w;
+            outside[1] += clip.x > clip.w;
+            outside[2] += clip.y < -clip.w;
+            outside[3] += clip.y > clip.w;
+            outside[4] += clip.z > clip.w;
+        }
+        return std::none_of(std::begin(outside), std::end(outside), [](int count) { return count == 8; });
+    }
+}
+
+TEST_F(SceneTest, ShadowCasterCullingMatchesBruteForce)
+{
+    flex::Scene scene;
+
+    flex::Ref<flex::Mesh> mesh = flex::CreateRef<flex::Mesh>();
+    mesh->bounds = flex::AABB({ -0.5f, -0.5f, -0.5f }, { 0.5f, 0.5f, 0.5f });
+    mesh->boundingSphere.radius = glm::length(mesh->bounds.GetExtents());
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+    std::uniform_real_distribution<float> scale(0.2f, 6.0f);
+
+    constexpr int kEntityCount = 2000;
+    for (int i = 0; i < kEntityCount; ++i)
+    {
+        entt::entity entity = scene.CreateEntity("Caster");
+        auto& transform = scene.AddComponent<flex::TransformComponent>(entity);
+        transform.position = { position(rng), position(rng), position(rng) };
+        transform.scale = { scale(rng), scale(rng), scale(rng) };
+
+        auto& meshComponent = scene.AddComponent<flex::MeshComponent>(entity);
+        meshComponent.meshInstance = flex::CreateRef<flex::MeshInstance>();
+        meshComponent.meshInstance->mesh = mesh;
+    }
+    scene.UpdateTransforms();
+
+    // A small near cascade looking down a tilted sun direction
+    const glm::vec3 lightDir = glm::normalize(glm::vec3(-0.4f, -1.0f, -0.3f));
+    const glm::mat4 lightView = glm::lookAt(-lightDir * 30.0f, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const glm::mat4 lightViewProj = glm::ortho(-10.0f, 10.0f, -10.0f, 10.0f, 0.0f, 50.0f) * lightView;
+
+    std::vector<entt::entity> casters;
+    const uint32_t culled = scene.GatherShadowCasters(lightViewProj, casters);
+    EXPECT_EQ(culled + casters.size(), static_cast<size_t>(kEntityCount));
+    EXPECT_GT(culled, 0u);
+
+    std::vector<entt::entity> expected;
+    auto view = scene.registry->view<flex::WorldTransformComponent, flex::MeshComponent>();
+    view.each([&](entt::entity entity, const flex::WorldTransformComponent& transform, const flex::MeshComponent&)
+    {
+        if (BruteForceCasterVisible(mesh->bounds, transform.world, lightViewProj))
+        {
+            expected.push_back(entity);
+        }
+    });
+
+    // Unrotated boxes make the world AABB exact, so both sides must agree entity for entity
+    std::sort(casters.begin(), casters.end());
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(casters, expected);
+
+    // Boxes between the light and the cascade are kept even though they are behind its near plane
+    entt::entity towardsLight = scene.CreateEntity("Towards Light");
+    scene.AddComponent<flex::TransformComponent>(towardsLight).position = -lightDir * 45.0f;
+    auto& towardsMesh = scene.AddComponent<flex::MeshComponent>(towardsLight);
+    towardsMesh.meshInstance = flex::CreateRef<flex::MeshInstance>();
+    towardsMesh.meshInstance->mesh = mesh;
+    scene.UpdateTransforms();
+
+    scene.GatherShadowCasters(lightViewProj, casters);
+    EXPECT_NE(std::find(casters.begin(), casters.end(), towardsLight), casters.end());
+}
+
+TEST_F(SceneTest, SpatialTreesTrackRenderablesAndAnswerQueries)
+{
+    flex::Scene scene;
+
+    flex::Ref<flex::Mesh> mesh = flex::CreateRef<flex::Mesh>();
+    mesh->bounds = flex::AABB({ -0.5f, -0.5f, -0.5f }, { 0.5f, 0.5f, 0.5f });
+    mesh->boundingSphere.radius = glm::length(mesh->bounds.GetExtents());
+
+    const auto createBox = [&](const glm::vec3& position, bool dynamic)
+    {
+        entt::entity entity = scene.CreateEntity("Box");
+        scene.AddComponent<flex::TransformComponent>(entity).position = position;
+        scene.AddComponent<flex::MeshComponent>(entity).meshInstance = flex::CreateRef<flex::MeshInstance>();
+        scene.GetComponent<flex::MeshComponent>(entity).meshInstance->mesh = mesh;
+        if (dynamic)
+        {
+            scene.AddComponent<flex::RigidbodyComponent>(entity).isStatic = false;
+        }
+        return entity;
+    };
+
+    entt::entity nearBox = createBox({ 0.0f, 0.0f, -5.0f }, false);
+    entt::entity farBox = createBox({ 0.0f, 0.0f, -20.0f }, true);
+    entt::entity aside = createBox({ 30.0f, 0.0f, -5.0f }, false);
+    scene.UpdateTransforms();
+
+    EXPECT_EQ(scene.GetStaticTree().GetProxyCount(), 2u);
+    EXPECT_EQ(scene.GetDynamicTree().GetProxyCount(), 1u);
+
+    std::vector<entt::entity> hits;
+    scene.QueryRay({ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, -1.0f }, 100.0f, hits);
+    ASSERT_EQ(hits.size(), 2u);
+    EXPECT_EQ(hits[0], nearBox);
+    EXPECT_EQ(hits[1], farBox);
+
+    flex::BoundingSphere sphere;
+    sphere.center = { 30.0f, 0.0f, -5.0f };
+    sphere.radius = 2.0f;
+    scene.QuerySphere(sphere, hits);
+    ASSERT_EQ(hits.size(), 1u);
+    EXPECT_EQ(hits[0], aside);
+
+    // Moving the dynamic box refits its leaf, destroying an entity removes it
+    auto& farBoxTransform = scene.GetComponent<flex::TransformComponent>(farBox);
+    farBoxTransform.position = { 30.0f, 0.0f, -4.0f };
+    farBoxTransform.dirty = true;
+    scene.UpdateTransforms();
+    EXPECT_EQ(scene.GetStats().spatialProxiesReinserted, 1u);
+
+    scene.QueryAABB(flex::AABB({ 28.0f, -1.0f, -7.0f }, { 32.0f, 1.0f, -3.0f }), hits);
+    EXPECT_EQ(hits.size(), 2u);
+
+    scene.DestroyEntity(aside);
+    EXPECT_EQ(scene.GetStaticTree().GetProxyCount(), 1u);
+    scene.QueryAABB(flex::AABB({ 28.0f, -1.0f, -7.0f }, { 32.0f, 1.0f, -3.0f }), hits);
+    ASSERT_EQ(hits.size(), 1u);
+    EXPECT_EQ(hits[0], farBox);
+}
+
+TEST(DynamicAABBTreeTest, QueryAndRefitBenchmark)
+{
+    using Clock = std::chrono::high_resolution_clock;
+    const auto elapsedMs = [](Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    };
+
+    for (const uint32_t count : { 10000u, 100000u, 1000000u })
+    {
+        // Keep density constant so query selectivity is comparable between sizes
+        const float halfSide = 2.0f * std::cbrt(static_cast<float>(count));
+        std::mt19937 rng(count);
+        std::uniform_real_distribution<float> position(-halfSide, halfSide);
+        std::uniform_real_distribution<float> extent(0.2f, 1.0f);
+        std::uniform_real_distribution<float> step(-0.3f, 0.3f);
+
+        std::vector<flex::AABB> boxes(count);
+        for (flex::AABB& box : boxes)
+        {
+            const glm::vec3 center = { position(rng), position(rng), position(rng) };
+            const glm::vec3 halfExtents = { extent(rng), extent(rng), extent(rng) };
+            box = flex::AABB(center - halfExtents, center + halfExtents);
+        }
+
+        flex::DynamicAABBTree tree;
+        std::vector<int32_t> proxies(count);
+
+        auto start = Clock::now();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            proxies[i] = tree.CreateProxy(boxes[i], i);
+        }
+        const double buildMs = elapsedMs(start);
+        ASSERT_EQ(tree.GetProxyCount(), count);
+
+        // Camera in the middle of the volume looking down -Z
+        const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, halfSide);
+        const glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        const flex::Frustum frustum = flex::Frustum::FromMatrix(projection * view);
+
+        uint32_t treeHits = 0;
+        start = Clock::now();
+        tree.QueryFrustum(frustum, [&](uint32_t) { ++treeHits; return true; });
+        const double frustumMs = elapsedMs(start);
+
+        uint32_t linearHits = 0;
+        start = Clock::now();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            linearHits += frustum.Classify(tree.GetFatAABB(proxies[i])) != flex::Containment::Outside;
+        }
+        const double linearMs = elapsedMs(start);
+        EXPECT_EQ(treeHits, linearHits);
+
+        const flex::AABB region({ -8.0f, -8.0f, -8.0f }, { 8.0f, 8.0f, 8.0f });
+        uint32_t regionHits = 0;
+        start = Clock::now();
+        tree.QueryAABB(region, [&](uint32_t) { ++regionHits; return true; });
+        const double aabbMs = elapsedMs(start);
+
+        uint32_t regionExpected = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            regionExpected += tree.GetFatAABB(proxies[i]).Overlaps(region);
+        }
+        EXPECT_EQ(regionHits, regionExpected);
+
+        // Refit: a tenth of the objects move a little each frame
+        uint32_t reinserted = 0;
+        start = Clock::now();
+        for (uint32_t i = 0; i < count; i += 10)
+        {
+            const glm::vec3 displacement = { step(rng), step(rng), step(rng) };
+            boxes[i].min += displacement;
+            boxes[i].max += displacement;
+            reinserted += tree.MoveProxy(proxies[i], boxes[i], displacement);
+        }
+        const double refitMs = elapsedMs(start);
+
+        for (uint32_t i = 0; i < count; i += 10)
+        {
+            EXPECT_TRUE(tree.GetFatAABB(proxies[i]).Contains(boxes[i]));
+        }
+
+        std::cout << "[ BENCH    ] " << count << " proxies (height " << tree.GetHeight() << "): build " << buildMs
+                  << " ms, frustum " << frustumMs << " ms vs linear " << linearMs << " ms (" << treeHits << " hits), aabb "
+                  << aabbMs << " ms, refit " << count / 10 << " moved " << refitMs << " ms (" << reinserted << " reinserted)\n";
+    }
+}
+
+TEST(RenderQueueTest, SortKeysOrderPassesStateAndDepth)
+{
+    using flex::RenderPass;
+    using flex::RenderQueue;
+
+    // Opaque before transparent regardless of state or depth
+    EXPECT_LT(RenderQueue::MakeSortKey(RenderPass::Opaque, 4095, 9999, 9999, 1000.0f),
+              RenderQueue::MakeSortKey(RenderPass::Transparent, 0, 0, 0, 0.0f));
+
+    // Opaque: state first, then front to back inside a state group
+    EXPECT_LT(RenderQueue::MakeSortKey(RenderPass::Opaque, 1, 2, 3, 5.0f),
+              RenderQueue::MakeSortKey(RenderPass::Opaque, 1, 2, 3, 50.0f));
+    EXPECT_LT(RenderQueue::MakeSortKey(RenderPass::Opaque, 1, 2, 3, 500.0f),
+              RenderQueue::MakeSortKey(RenderPass::Opaque, 1, 2, 4, 1.0f));
+
+    // 16-bit and 32-bit meshes of one shader group apart so each multi draw has one index type
+    EXPECT_LT(RenderQueue::MakeSortKey(RenderPass::Opaque, 1, 7, 3, 5.0f, flex::IndexType::UINT16),
+              RenderQueue::MakeSortKey(RenderPass::Opaque, 1, 2, 3, 5.0f, flex::IndexType::UINT32));
+
+    // Transparent: back to front even across materials
+    EXPECT_LT(RenderQueue::MakeSortKey(RenderPass::Transparent, 1, 7, 3, 50.0f),
+              RenderQueue::MakeSortKey(RenderPass::Transparent, 1, 2, 3, 5.0f));
+
+    // Negative depth (straddling the camera) sorts as nearest
+    EXPECT_EQ(RenderQueue::MakeSortKey(RenderPass::Opaque, 1, 2, 3, -4.0f),
+              RenderQueue::MakeSortKey(RenderPass::Opaque, 1, 2, 3, 0.0f));
+}
+
+TEST(RenderQueueTest, RadixSortMatchesStdSort)
+{
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<uint32_t> smallId(0, 15);
+    std::uniform_real_distribution<float> depth(0.0f, 500.0f);
+
+    std::vector<flex::RenderQueue::SortEntry> entries;
+    for (uint32_t i = 0; i < 10000; ++i)
+    {
+        const flex::RenderPass pass = (i % 5 == 0) ? flex::RenderPass::Transparent : flex::RenderPass::Opaque;
+        entries.push_back({ flex::RenderQueue::MakeSortKey(pass, smallId(rng), smallId(rng), smallId(rng), depth(rng)), i });
+    }
+
+    std::vector<flex::RenderQueue::SortEntry> expected = entries;
+    std::stable_sort(expected.begin(), expected.end(), [](const auto& a, const auto& b) { return a.key < b.key; });
+
+    std::vector<flex::RenderQueue::SortEntry> scratch;
+    flex::RenderQueue::RadixSort(entries, scratch);
+
+    ASSERT_EQ(entries.size(), expected.size());
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        EXPECT_EQ(entries[i].key, expected[i].key);
+        EXPECT_EQ(entries[i].index, expected[i].index); // LSD radix sort is stable
+    }
+}
+
+TEST(RenderQueueTest, ItemsSharingMeshAndMaterialAreBatched)
+{
+    // Headless meshes are enough, Sort never touches GL
+    flex::Mesh rock;
+    flex::Mesh tree;
+    std::vector<glm::mat4> transforms(300, glm::mat4(1.0f));
+
+    flex::RenderQueue queue;
+    for (size_t i = 0; i < transforms.size(); ++i)
+    {
+        const flex::Mesh* mesh = (i % 3 == 0) ? &tree : &rock;
+        queue.Submit(flex::RenderPass::Opaque, nullptr, nullptr, mesh, transforms[i], static_cast<float>(i));
+    }
+    queue.Sort();
+
+    const auto& batches = queue.GetBatches();
+    ASSERT_EQ(batches.size(), 2u);
+    EXPECT_EQ(batches[0].first, 0u);
+    EXPECT_EQ(batches[0].count + batches[1].count, 300u);
+    EXPECT_EQ(batches[1].first, batches[0].count);
+
+    for (const auto& batch : batches)
+    {
+        for (uint32_t i = batch.first; i < batch.first + batch.count; ++i)
+        {
+            EXPECT_EQ(queue.GetItem(i).mesh, queue.GetItem(batch.first).mesh);
+        }
+    }
+}
+
+TEST(RenderQueueTest, IdsPastKeyWidthsDontAlias)
+{
+    // Process wide ids keep growing, these two share their low 16 bits
+    flex::Mesh rock;
+    flex::Mesh tree;
+    rock.id = 7;
+    tree.id = 7 + (1u << 16);
+    std::vector<glm::mat4> transforms(100, glm::mat4(1.0f));
+
+    flex::RenderQueue queue;
+    for (size_t i = 0; i < transforms.size(); ++i)
+    {
+        const flex::Mesh* mesh = (i % 2 == 0) ? &tree : &rock;
+        queue.Submit(flex::RenderPass::Opaque, nullptr, nullptr, mesh, transforms[i], static_cast<float>(i));
+    }
+    queue.Sort();
+
+    // Aliased keys would interleave the meshes by depth and split every batch
+    ASSERT_EQ(queue.GetBatches().size(), 2u);
+    EXPECT_EQ(queue.GetBatches()[0].count, 50u);
+}
+
+TEST(RenderQueueTest, LargeScenesSortIntoOneRunFrontToBack)
+{
+    using Clock = std::chrono::high_resolution_clock;
+    constexpr int kFrames = 20;
+
+    // Shader and meshes are headless, only Execute talks to GL
+    flex::Shader shader;
+    std::vector<flex::Mesh> meshes(64);
+
+    for (const uint32_t count : { 10000u, 100000u })
+    {
+        std::mt19937 rng(count);
+        std::uniform_real_distribution<float> depth(0.1f, 500.0f);
+
+        std::vector<glm::mat4> transforms(count, glm::mat4(1.0f));
+        std::vector<float> depths(count);
+        for (float& d : depths)
+        {
+            d = depth(rng);
+        }
+
+        flex::RenderQueue queue;
+        const auto submitFrame = [&]()
+        {
+            queue.Clear();
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                queue.Submit(flex::RenderPass::Opaque, &shader, nullptr, &meshes[i % meshes.size()], transforms[i], depths[i]);
+            }
+            queue.Sort();
+        };
+
+        submitFrame(); // Warm up the queue's vectors
+        const auto start = Clock::now();
+        for (int frame = 0; frame < kFrames; ++frame)
+        {
+            submitFrame();
+        }
+        const double submitMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / kFrames;
+
+        // Nothing but the shader splits a multi draw
+        ASSERT_EQ(queue.GetBatches().size(), meshes.size());
+        ASSERT_EQ(queue.GetRuns().size(), 1u);
+
+        // One mesh per batch, front to back within it up to the key's depth precision (11 mantissa bits)
+        for (const auto& batch : queue.GetBatches())
+        {
+            const flex::DrawItem& first = queue.GetItem(batch.first);
+            float previousDepth = 0.0f;
+            for (uint32_t i = batch.first; i < batch.first + batch.count; ++i)
+            {
+                const flex::DrawItem& item = queue.GetItem(i);
+                EXPECT_EQ(item.mesh, first.mesh);
+
+                const float itemDepth = depths[item.transform - transforms.data()];
+                EXPECT_GE(itemDepth, previousDepth * (1.0f - 1e-3f));
+                previousDepth = itemDepth;
+            }
+        }
+
+        std::cout << "[ BENCH    ] " << count << " draws: submit + sort " << submitMs << " ms, "
+                  << queue.GetBatches().size() << " commands in " << queue.GetRuns().size() << " multi draws\n";
+    }
+}
+
+TEST(ShaderTest, UniformNamesHashAtCompileTime)
+{
+    // The literal is hashed by the compiler, reflection hashes the same bytes at link time
+    constexpr flex::UniformName name = "u_Exposure";
+    static_assert(name.hash == flex::HashUniformName("u_Exposure"));
+
+    const std::string runtimeName = std::string("u_") + "Exposure";
+    EXPECT_EQ(name.hash, flex::HashUniformName(runtimeName));
+    EXPECT_NE(flex::HashUniformName("u_Samples"), flex::HashUniformName("u_Samples[0]"));
+
+    // A headless shader has nothing reflected, lookups miss without touching GL
+    flex::Shader shader;
+    EXPECT_FALSE(shader.GetUniform<float>("u_Exposure").IsValid());
+    EXPECT_EQ(shader.GetUniformBlockBinding("Camera"), -1);
+}
+
+namespace
+{
+    // Just enough of a driver to link without a context, every program reports a successful link
+    GLuint APIENTRY FakeCreateShader(GLenum) { return 1; }
+    void APIENTRY FakeShaderSource(GLuint, GLsizei, const GLchar* const*, const GLint*) {}
+    void APIENTRY FakeCompileShader(GLuint) {}
+    GLuint APIENTRY FakeCreateProgram() { return 1; }
+    void APIENTRY FakeAttachShader(GLuint, GLuint) {}
+    void APIENTRY FakeLinkProgram(GLuint) {}
+    void APIENTRY FakeDetachShader(GLuint, GLuint) {}
+    void APIENTRY FakeDeleteShader(GLuint) {}
+    void APIENTRY FakeGetProgramiv(GLuint, GLenum pname, GLint* value) { *value = pname == GL_LINK_STATUS ? GL_TRUE : 0; }
+    void APIENTRY FakeGetProgramInterfaceiv(GLuint, GLenum, GLenum, GLint* value) { *value = 0; }
+    GLenum APIENTRY FakeGetError() { return GL_NO_ERROR; }
+}
+
+TEST(ShaderTest, PollFinishesWithoutParallelCompile)
+{
+    glad_glCreateShader = FakeCreateShader;
+    glad_glShaderSource = FakeShaderSource;
+    glad_glCompileShader = FakeCompileShader;
+    glad_glCreateProgram = FakeCreateProgram;
+    glad_glAttachShader = FakeAttachShader;
+    glad_glLinkProgram = FakeLinkProgram;
+    glad_glDetachShader = FakeDetachShader;
+    glad_glDeleteShader = FakeDeleteShader;
+    glad_glGetProgramiv = FakeGetProgramiv;
+    glad_glGetProgramInterfaceiv = FakeGetProgramInterfaceiv;
+    glad_glGetError = FakeGetError;
+
+    // EnableParallelCompile never ran, so nothing else would collect the program before its first use
+    flex::Shader shader;
+    shader.CreateFromSource({ { "#version 460 core\nvoid main() {}", GL_VERTEX_SHADER } }).CompileAsync();
+    EXPECT_TRUE(shader.Poll());
+    EXPECT_TRUE(shader.IsReady());
+
+    glad_glCreateShader = nullptr;
+    glad_glShaderSource = nullptr;
+    glad_glCompileShader = nullptr;
+    glad_glCreateProgram = nullptr;
+    glad_glAttachShader = nullptr;
+    glad_glLinkProgram = nullptr;
+    glad_glDetachShader = nullptr;
+    glad_glDeleteShader = nullptr;
+    glad_glGetProgramiv = nullptr;
+    glad_glGetProgramInterfaceiv = nullptr;
+    glad_glGetError = nullptr;
+}
+
+TEST(ProgramCacheTest, KeyCoversStageSourceAndOrder)
+{
+    constexpr uint64_t driverKey = 1234;
+    const auto makeKey = [&](std::initializer_list<std::pair<uint32_t, std::string_view>> stages)
+    {
+        uint64_t key = driverKey;
+        for (const auto& [stage, source] : stages)
+        {
+            key = flex::ProgramCache::AppendKey(key, stage, source);
+        }
+        return key;
+    };
+
+    const uint64_t key = makeKey({ { GL_VERTEX_SHADER, "void main() {}" }, { GL_FRAGMENT_SHADER, "out vec4 c;" } });
+    EXPECT_EQ(key, makeKey({ { GL_VERTEX_SHADER, "void main() {}" }, { GL_FRAGMENT_SHADER, "out vec4 c;" } }));
+
+    // A define, a swapped stage or text moved across the stage boundary all miss
+    EXPECT_NE(key, makeKey({ { GL_VERTEX_SHADER, "#define A\nvoid main() {}" }, { GL_FRAGMENT_SHADER, "out vec4 c;" } }));
+    EXPECT_NE(key, makeKey({ { GL_FRAGMENT_SHADER, "void main() {}" }, { GL_VERTEX_SHADER, "out vec4 c;" } }));
+    EXPECT_NE(key, makeKey({ { GL_VERTEX_SHADER, "void main() {}out" }, { GL_FRAGMENT_SHADER, " vec4 c;" } }));
+}
+
+TEST(GeometryPoolTest, RangeAllocatorReusesAndMergesFreedRanges)
+{
+    flex::RangeAllocator ranges(100);
+
+    uint32_t a = 0, b = 0, c = 0;
+    ASSERT_TRUE(ranges.Allocate(30, a));
+    ASSERT_TRUE(ranges.Allocate(30, b));
+    ASSERT_TRUE(ranges.Allocate(30, c));
+    EXPECT_EQ(a, 0u);
+    EXPECT_EQ(b, 30u);
+    EXPECT_EQ(c, 60u);
+    EXPECT_EQ(ranges.GetUsed(), 90u);
+
+    uint32_t d = 0;
+    EXPECT_FALSE(ranges.Allocate(20, d));
+
+    // Freeing the middle then its neighbours collapses back into one range
+    ranges.Free(b, 30);
+    ASSERT_TRUE(ranges.Allocate(10, d));
+    EXPECT_EQ(d, 30u);
+    ranges.Free(d, 10);
+    ranges.Free(a, 30);
+    ranges.Free(c, 30);
+    EXPECT_EQ(ranges.GetUsed(), 0u);
+    EXPECT_EQ(ranges.GetFreeRangeCount(), 1u);
+
+    // Growing extends the trailing free range instead of adding a new one
+    ranges.Grow(200);
+    EXPECT_EQ(ranges.GetFreeRangeCount(), 1u);
+    ASSERT_TRUE(ranges.Allocate(200, d));
+    EXPECT_EQ(d, 0u);
+}
+
+TEST(MeshCacheTest, DeduplicatesByContentAndReleasesUnusedMeshes)
+{
+    auto makeGrid = [](uint32_t size, float height)
+    {
+        std::vector<flex::Vertex> vertices;
+        for (uint32_t i = 0; i < size * size; ++i)
+        {
+            vertices.push_back({ glm::vec3(float(i % size), height, float(i / size)), glm::vec3(0.0f, 1.0f, 0.0f) });
+        }
+        return vertices;
+    };
+    const std::vector<uint32_t> indices = { 0, 1, 2, 2, 1, 3 };
+
+    // Headless meshes, no pool behind them
+    flex::MeshCache cache;
+    flex::Ref<flex::Mesh> a = cache.FindOrCreate(makeGrid(4, 0.0f), indices);
+    flex::Ref<flex::Mesh> b = cache.FindOrCreate(makeGrid(4, 0.0f), indices);
+    flex::Ref<flex::Mesh> c = cache.FindOrCreate(makeGrid(4, 1.0f), indices); // Same counts, different data
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_EQ(cache.GetStats().requested, 3u);
+    EXPECT_EQ(cache.GetStats().created, 2u);
+    EXPECT_GT(cache.GetStats().bytesSaved, 0u);
+
+    // Entries don't keep meshes alive
+    const uint32_t releasedId = c->id;
+    c.reset();
+    EXPECT_EQ(cache.GetLiveMeshCount(), 1u);
+    c = cache.FindOrCreate(makeGrid(4, 1.0f), indices);
+    EXPECT_NE(c->id, releasedId);
+
+    // Large buffers are hashed in chunks, a change in any chunk must show
+    const std::vector<flex::Vertex> large = makeGrid(200, 0.0f);
+    std::vector<flex::Vertex> changed = large;
+    changed.back().uv.x = 0.5f;
+    EXPECT_EQ(flex::MeshCache::HashGeometry(large, indices), flex::MeshCache::HashGeometry(makeGrid(200, 0.0f), indices));
+    EXPECT_NE(flex::MeshCache::HashGeometry(large, indices), flex::MeshCache::HashGeometry(changed, indices));
+}
+
+TEST(MeshCacheTest, KeyCollisionsKeepSeparateMeshes)
+{
+    std::vector<flex::Vertex> flat(4, { glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f) });
+    std::vector<flex::Vertex> raised = flat;
+    raised[2].position.y = 1.0f;
+    const std::vector<uint32_t> indices = { 0, 1, 2, 2, 1, 3 };
+
+    // Same key and counts for different data, as a real hash collision would give
+    const flex::Hash128 key = flex::MeshCache::HashGeometry(flat, indices);
+    flex::MeshCache cache;
+    flex::Ref<flex::Mesh> a = cache.FindOrCreate(key, flat, indices);
+    flex::Ref<flex::Mesh> b = cache.FindOrCreate(key, raised, indices);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(cache.GetStats().created, 2u);
+
+    // Both stay reachable from the shared bucket
+    EXPECT_EQ(cache.FindOrCreate(key, flat, indices), a);
+    EXPECT_EQ(cache.FindOrCreate(key, raised, indices), b);
+    EXPECT_EQ(cache.GetLiveMeshCount(), 2u);
+}
+
+TEST(VertexFormatTest, PackedVertexRoundTripsNormalsTangentsAndUVs)
+{
+    std::mt19937 rng(11);
+    std::normal_distribution<float> gaussian(0.0f, 1.0f);
+
+    float maxNormalError = 0.0f;
+    for (int i = 0; i < 10000; ++i)
+    {
+        flex::Vertex vertex{};
+        vertex.normal = glm::normalize(glm::vec3(gaussian(rng), gaussian(rng), gaussian(rng)));
+        vertex.tangent = glm::normalize(glm::cross(vertex.normal, glm::vec3(0.3f, 0.8f, 0.5f)));
+        vertex.bitangent = glm::cross(vertex.normal, vertex.tangent) * ((i & 1) ? -1.0f : 1.0f);
+        vertex.uv = glm::vec2(0.25f, 3.5f);
+        vertex.color = glm::vec3(1.0f);
+
+        // Same decode as pbr.vert: snorm / half fetch, then octahedral
+        const flex::PackedVertex packed = flex::PackVertex(vertex);
+        const glm::vec3 normal = flex::DecodeOctahedral({ std::max(packed.normal[0] / 32767.0f, -1.0f), std::max(packed.normal[1] / 32767.0f, -1.0f) });
+        const glm::vec3 tangent = flex::DecodeOctahedral({ std::max(packed.tangent[0] / 127.0f, -1.0f), std::max(packed.tangent[1] / 127.0f, -1.0f) });
+        const glm::vec3 bitangent = glm::cross(normal, tangent) * (packed.tangent[2] < 0 ? -1.0f : 1.0f);
+
+        maxNormalError = std::max(maxNormalError, glm::length(normal - vertex.normal));
+        EXPECT_GT(glm::dot(tangent, vertex.tangent), 0.99f);
+        EXPECT_GT(glm::dot(bitangent, vertex.bitangent), 0.98f);
+        EXPECT_EQ(packed.uv[0], 0x3400); // 0.25 and 3.5 are exact in half precision
+        EXPECT_EQ(packed.uv[1], 0x4300);
+        EXPECT_EQ(flex::PackColor(vertex.color), flex::kPackedWhite);
+    }
+    EXPECT_LT(maxNormalError, 1e-3f);
+
+    // Colored meshes move the pool onto its color stream, byte order r, g, b, a
+    const uint32_t red = flex::PackColor(glm::vec3(1.0f, 0.0f, 0.0f));
+    EXPECT_EQ(red, 0xFF0000FFu);
+    EXPECT_NE(red, flex::kPackedWhite);
+}
+
+TEST(MeshOptimizerTest, ShuffledGridGetsCacheFriendlyOrder)
+{
+    // 64x64 quads with triangles and vertices in random order, like a careless exporter
+    constexpr uint32_t size = 65;
+    std::vector<flex::Vertex> vertices(size * size);
+    for (uint32_t i = 0; i < vertices.size(); ++i)
+    {
+        vertices[i].position = glm::vec3(float(i % size), 0.0f, float(i / size));
+    }
+
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (uint32_t y = 0; y + 1 < size; ++y)
+    {
+        for (uint32_t x = 0; x + 1 < size; ++x)
+        {
+            const uint32_t v = y * size + x;
+            triangles.push_back({ v, v + size, v + 1 });
+            triangles.push_back({ v + 1, v + size, v + size + 1 });
+        }
+    }
+
+    std::mt19937 rng(3);
+    std::shuffle(triangles.begin(), triangles.end(), rng);
+    std::vector<uint32_t> shuffle(vertices.size());
+    std::iota(shuffle.begin(), shuffle.end(), 0u);
+    std::shuffle(shuffle.begin(), shuffle.end(), rng);
+
+    std::vector<flex::Vertex> shuffledVertices(vertices.size());
+    for (uint32_t i = 0; i < vertices.size(); ++i)
+    {
+        shuffledVertices[shuffle[i]] = vertices[i];
+    }
+
+    std::vector<uint32_t> indices;
+    for (const auto& triangle : triangles)
+    {
+        for (uint32_t v : triangle)
+        {
+            indices.push_back(shuffle[v]);
+        }
+    }
+
+    auto triangleSet = [](const std::vector<flex::Vertex>& verts, const std::vector<uint32_t>& ids)
+    {
+        // Positions rotated so the smallest comes first, winding kept
+        std::vector<std::array<float, 6>> result;
+        for (size_t t = 0; t < ids.size(); t += 3)
+        {
+            std::array<glm::vec3, 3> p = { verts[ids[t]].position, verts[ids[t + 1]].position, verts[ids[t + 2]].position };
+            auto less = [](const glm::vec3& a, const glm::vec3& b) { return std::tie(a.x, a.z) < std::tie(b.x, b.z); };
+            std::rotate(p.begin(), std::min_element(p.begin(), p.end(), less), p.end());
+            result.push_back({ p[0].x, p[0].z, p[1].x, p[1].z, p[2].x, p[2].z });
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    };
+    const auto expectedTriangles = triangleSet(shuffledVertices, indices);
+
+    const flex::MeshOptimizeStats stats = flex::MeshOptimizer::Optimize(shuffledVertices, indices);
+    std::cout << "[ MESHOPT  ] ACMR " << stats.acmrBefore << " -> " << stats.acmrAfter << ", ATVR " << stats.atvrBefore << " -> " << stats.atvrAfter << "\n";
+
+    EXPECT_GT(stats.acmrBefore, 2.5f);
+    EXPECT_LT(stats.acmrAfter, 0.8f);
+    EXPECT_LT(stats.atvrAfter, 1.6f);
+    EXPECT_EQ(stats.acmrAfter, flex::MeshOptimizer::ComputeACMR(indices, static_cast<uint32_t>(shuffledVertices.size())));
+
+    // Same triangles with the same winding, vertices numbered in first use order
+    EXPECT_EQ(triangleSet(shuffledVertices, indices), expectedTriangles);
+    uint32_t nextNew = 0;
+    for (uint32_t index : indices)
+    {
+        ASSERT_LE(index, nextNew);
+        nextNew = std::max(nextNew, index + 1);
+    }
+    EXPECT_EQ(nextNew, shuffledVertices.size());
+}
+
+TEST(TextureTest, MipChainEndsAtOneByOne)
+{
+    using flex::Texture2D;
+
+    EXPECT_EQ(Texture2D::CalculateMipLevels(1, 1), 1u);
+    EXPECT_EQ(Texture2D::CalculateMipLevels(2, 2), 2u);
+    EXPECT_EQ(Texture2D::CalculateMipLevels(1024, 1024), 11u);
+
+    // The longer side decides, odd sizes round down per level (1000, 500, ..., 3, 1)
+    EXPECT_EQ(Texture2D::CalculateMipLevels(1024, 1), 11u);
+    EXPECT_EQ(Texture2D::CalculateMipLevels(600, 1000), 10u);
+}
+
+TEST(TextureTest, MemorySizeCountsEveryMipLevel)
+{
+    using flex::Format;
+    using flex::Texture2D;
+
+    EXPECT_EQ(Texture2D::CalculateMemorySize(4, 4, Format::RGBA8, 1), 64u);
+    EXPECT_EQ(Texture2D::CalculateMemorySize(4, 4, Format::RGBA8, 3), 64u + 16u + 4u);
+
+    // Non square chains clamp the short side at one texel
+    EXPECT_EQ(Texture2D::CalculateMemorySize(4, 1, Format::R8, 3), 4u + 2u + 1u);
+    EXPECT_EQ(Texture2D::CalculateMemorySize(2, 2, Format::RGBA32F, 2), 64u + 16u);
+}
+
+TEST(TextureCompressorTest, BlockFormatsKeepQualityAboveThreshold)
+{
+    using flex::Format;
+    using flex::TextureCompressor;
+
+    // Gradients with noise, the size leaves partial edge blocks
+    constexpr uint32_t width = 70;
+    constexpr uint32_t height = 66;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> noise(-6, 6);
+    std::vector<uint8_t> image(width * height * 4);
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            uint8_t *texel = &image[(y * width + x) * 4];
+            texel[0] = static_cast<uint8_t>(std::clamp(int(x * 255 / width) + noise(rng), 0, 255));
+            texel[1] = static_cast<uint8_t>(std::clamp(int(y * 255 / height) + noise(rng), 0, 255));
+            texel[2] = static_cast<uint8_t>(std::clamp(int((x + y) * 255 / (width + height)) + noise(rng), 0, 255));
+            texel[3] = static_cast<uint8_t>(std::clamp(255 - int(x * 200 / width) + noise(rng), 0, 255));
+        }
+    }
+
+    // BC1 ignores alpha, BC5 only stores red and green
+    const std::tuple<Format, uint32_t, size_t, float> cases[] = {
+        { Format::BC1, 3, 8, 34.0f },
+        { Format::BC3, 4, 16, 35.0f },
+        { Format::BC5, 2, 16, 45.0f },
+        { Format::BC7, 4, 16, 35.0f },
+    };
+    for (const auto &[format, channels, blockSize, minimumPSNR] : cases)
+    {
+        const std::vector<uint8_t> blocks = TextureCompressor::Compress(image.data(), width, height, format);
+        ASSERT_EQ(blocks.size(), 18u * 17u * blockSize);
+
+        const std::vector<uint8_t> decoded = TextureCompressor::Decompress(blocks.data(), width, height, format);
+        const float psnr = TextureCompressor::ComputePSNR(image.data(), decoded.data(), width * height, channels);
+        std::cout << "Format " << static_cast<int>(format) << ": " << psnr << " dB\n";
+        EXPECT_GT(psnr, minimumPSNR);
+    }
+
+    // Every level of the chain is the block count of its size
+    const flex::CompressedImage chain = TextureCompressor::CompressMipChain(image.data(), width, height, Format::BC7, flex::Texture2D::CalculateMipLevels(width, height));
+    size_t chainSize = 0;
+    for (const std::vector<uint8_t> &level : chain.levels)
+    {
+        chainSize += level.size();
+    }
+    EXPECT_EQ(chain.levels.size(), 7u);
+    EXPECT_EQ(chainSize, flex::Texture2D::CalculateMemorySize(width, height, Format::BC7, 7));
+}
+
+TEST(TextureStreamerTest, MipLevelFollowsScreenSpaceTexelDensity)
+{
+    using flex::TextureStreamer;
+
+    // A 2x2 quad mapped to the full 0..1 UV range, 0.5 UV units per local unit
+    const std::vector<flex::Vertex> vertices = {
+        { glm::vec3(-1.0f, -1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f), glm::vec2(0.0f, 0.0f) },
+        { glm::vec3( 1.0f, -1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f), glm::vec2(1.0f, 0.0f) },
+        { glm::vec3( 1.0f,  1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f), glm::vec2(1.0f, 1.0f) },
+        { glm::vec3(-1.0f,  1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f), glm::vec2(0.0f, 1.0f) },
+    };
+    const flex::Mesh quad(vertices, { 0, 1, 2, 2, 3, 0 });
+    EXPECT_NEAR(quad.uvDensity, 0.5f, 1e-5f);
+
+    // 1024 texels over 1080 pixels needs level 0, each halving of the screen size drops a level
+    EXPECT_EQ(TextureStreamer::SelectMipLevel(1024, 1.0f, 1080), 0u);
+    EXPECT_EQ(TextureStreamer::SelectMipLevel(1024, 2.2f, 1080), 1u);
+    EXPECT_EQ(TextureStreamer::SelectMipLevel(1024, 4.5f, 1080), 2u);
+    EXPECT_EQ(TextureStreamer::SelectMipLevel(4096, 64.0f, 1024), 8u);
+
+    // Unknown density keeps the full resolution
+    EXPECT_EQ(TextureStreamer::SelectMipLevel(1024, 0.0f, 1080), 0u);
+
+    // The tail is the first level within kTailSize texels
+    EXPECT_EQ(TextureStreamer::GetTailLevel(2048, 2048), 4u);
+    EXPECT_EQ(TextureStreamer::GetTailLevel(2048, 512), 4u);
+    EXPECT_EQ(TextureStreamer::GetTailLevel(100, 64), 0u);
+}
+
+TEST(TextureStreamerTest, StreamsOnlyBindlessMipChains)
+{
+    flex::CompressedImage image;
+    image.format = flex::Format::BC7;
+    image.width = 512;
+    image.height = 512;
+    image.levels.resize(10);
+
+    // Array buckets are keyed by size, reallocating a texture would move it between them
+    EXPECT_TRUE(flex::TextureStreamer::CanStream(image, true));
+    EXPECT_FALSE(flex::TextureStreamer::CanStream(image, false));
+
+    // A single level has nothing to leave out
+    image.levels.resize(1);
+    EXPECT_FALSE(flex::TextureStreamer::CanStream(image, true));
+}